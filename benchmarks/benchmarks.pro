@@ -17,9 +17,21 @@ QMAKE_LFLAGS = -Wl,-O3 #-fsanitize=address,leak
 
 SOURCES += \
     bm_bitvector.cpp \
+    bm_bucket_sort.cpp \
+    bm_circular_queue.cpp \
+    bm_compact_string.cpp \
+    bm_concurrent_queue.cpp \
     bm_counting_sort.cpp \
+    bm_is_unique.cpp \
+    bm_kway_intersect.cpp \
+    bm_kway_merge.cpp \
     bm_main.cpp \
     bm_packed_hashtbl.cpp \
+    bm_parallel_sort.cpp \
+    bm_priority_set.cpp \
+    bm_small_sort.cpp \
+    bm_split.cpp \
+    bm_static_search_index.cpp \
     bm_stringset.cpp
 
 
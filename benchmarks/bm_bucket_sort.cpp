@@ -0,0 +1,91 @@
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/algorithm/sorting/bucket_sort.hpp>
+#include <stlext/algorithm/sorting/parallel_sort.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// state.range(1): 0 - uniform keys, 1 - heavily skewed (exponential) keys
+static std::vector<uint64_t> __bucket_sort_keys(size_t n, bool skewed)
+{
+    std::mt19937_64 gen(n);
+    std::exponential_distribution<double> expd(1e-3);
+    std::vector<uint64_t> v(n);
+    for (auto& x : v)
+        x = (skewed ? static_cast<uint64_t>(expd(gen)) : gen());
+    return v;
+}
+
+template<class _Sort>
+static void __bucket_sort_benchmark(benchmark::State& state, _Sort sort)
+{
+    auto keys = __bucket_sort_keys(state.range(0), state.range(1) != 0);
+    std::vector<uint64_t> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = keys;
+        state.ResumeTiming();
+        sort(v.begin(), v.end());
+    }
+    state.SetLabel(std::is_sorted(v.begin(), v.end()) ? "[PASSED]" : "[FAILED]");
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+typedef std::vector<uint64_t>::iterator __key_iterator;
+
+void BM_bucket_std_sort(benchmark::State& state)
+{
+    __bucket_sort_benchmark(state, [](__key_iterator first, __key_iterator last) { 
+        std::sort(first, last); 
+    });
+}
+BENCHMARK(BM_bucket_std_sort)->RangeMultiplier(16)->Ranges({{1 << 16, 1 << 24}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+// min/max equal-width buckets, as bucketizer<int> does
+struct __equal_width_bucketizer
+{
+    template<class _It>
+    __equal_width_bucketizer(_It first, _It last, size_t nbuckets) : n(nbuckets) {
+        auto minmax = std::minmax_element(first, last);
+        minimum = *minmax.first;
+        width = (*minmax.second - minimum) / nbuckets + 1;
+    }
+
+    size_t operator()(uint64_t x) const { return static_cast<size_t>((x - minimum) / width); }
+    size_t size() const { return n; }
+
+    size_t n;
+    uint64_t minimum;
+    uint64_t width;
+};
+
+void BM_bucket_sort_equal_width(benchmark::State& state)
+{
+    __bucket_sort_benchmark(state, [](__key_iterator first, __key_iterator last) { 
+        stdx::thread_set threads;
+        size_t nthreads = std::thread::hardware_concurrency();
+        stdx::bucket_sort(first, last, __equal_width_bucketizer(first, last, 256), 
+                          std::less<uint64_t>(), nthreads, threads);
+    });
+}
+BENCHMARK(BM_bucket_sort_equal_width)->RangeMultiplier(16)->Ranges({{1 << 16, 1 << 24}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_sample_sort(benchmark::State& state)
+{
+    __bucket_sort_benchmark(state, [](__key_iterator first, __key_iterator last) { 
+        stdx::sample_sort(first, last); 
+    });
+}
+BENCHMARK(BM_sample_sort)->RangeMultiplier(16)->Ranges({{1 << 16, 1 << 24}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+void BM_bucket_parallel_sort(benchmark::State& state)
+{
+    __bucket_sort_benchmark(state, [](__key_iterator first, __key_iterator last) { 
+        stdx::parallel_sort(first, last); 
+    });
+}
+BENCHMARK(BM_bucket_parallel_sort)->RangeMultiplier(16)->Ranges({{1 << 16, 1 << 24}, {0, 1}})->Unit(benchmark::kMillisecond);
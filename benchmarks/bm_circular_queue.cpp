@@ -0,0 +1,65 @@
+#include <deque>
+#include <vector>
+#include <numeric>
+
+#include <stlext/containers/circular_queue.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// sliding window of samples: queue is full most of the time,
+// so every push evicts front element
+template<class _Queue>
+void __bench_push(benchmark::State& state)
+{
+    _Queue q(state.range(0));
+    double sample = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; i++)
+            q.push(sample += 1.0);
+        benchmark::DoNotOptimize(q.back());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+template<class _Queue>
+void __bench_push_range(benchmark::State& state)
+{
+    _Queue q(state.range(0));
+    std::vector<double> block(256);
+    std::iota(block.begin(), block.end(), 0.0);
+    for (auto _ : state) {
+        for (int i = 0; i < 4; i++)
+            q.push(block.data(), block.data() + block.size());
+        benchmark::DoNotOptimize(q.back());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+
+template<class _Queue>
+void __bench_sum(benchmark::State& state)
+{
+    _Queue q(state.range(0));
+    for (int64_t i = 0; i < state.range(0) + 3; i++)
+        q.push(double(i));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(q.begin(), q.end(), 0.0));
+    state.SetItemsProcessed(state.iterations() * q.size());
+}
+
+typedef stdx::circular_queue<double, std::deque<double>> deque_queue;
+typedef stdx::circular_queue<double, stdx::ring_buffer<double>> ring_queue;
+
+void BM_circular_queue_deque_push(benchmark::State& state) { __bench_push<deque_queue>(state); }
+void BM_circular_queue_ring_push(benchmark::State& state) { __bench_push<ring_queue>(state); }
+void BM_circular_queue_deque_push_range(benchmark::State& state) { __bench_push_range<deque_queue>(state); }
+void BM_circular_queue_ring_push_range(benchmark::State& state) { __bench_push_range<ring_queue>(state); }
+void BM_circular_queue_deque_sum(benchmark::State& state) { __bench_sum<deque_queue>(state); }
+void BM_circular_queue_ring_sum(benchmark::State& state) { __bench_sum<ring_queue>(state); }
+
+BENCHMARK(BM_circular_queue_deque_push)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_circular_queue_ring_push)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_circular_queue_deque_push_range)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_circular_queue_ring_push_range)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_circular_queue_deque_sum)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_circular_queue_ring_sum)->Arg(1000)->Arg(100000);
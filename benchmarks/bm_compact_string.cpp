@@ -0,0 +1,151 @@
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <functional>
+
+#include <stlext/compact/string.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+static std::vector<std::string> make_strings(size_t n, size_t len)
+{
+    std::mt19937 gen(len);
+    std::vector<std::string> v(n);
+    for (auto& s : v)
+        for (size_t j = 0; j < len; j++)
+            s.push_back(char('a' + gen() % 26));
+    return v;
+}
+
+
+template<class _String>
+void __bench_string_hash(benchmark::State& state)
+{
+    auto src = make_strings(1024, state.range(0));
+    std::vector<_String> v(src.begin(), src.end());
+    std::hash<_String> hasher;
+
+    for (auto _ : state) {
+        for (auto& s : v)
+            benchmark::DoNotOptimize(hasher(s));
+    }
+    state.SetItemsProcessed(state.iterations() * v.size());
+}
+
+
+template<class _String>
+void __bench_string_equal(benchmark::State& state)
+{
+    auto src = make_strings(1024, state.range(0));
+    std::vector<_String> a(src.begin(), src.end());
+    std::vector<_String> b(a);
+    std::rotate(b.begin(), b.begin() + 1, b.end());
+    for (size_t i = 0; i < b.size(); i += 2)
+        b[i] = a[i];  // half equal, half different
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < a.size(); i++)
+            benchmark::DoNotOptimize(a[i] == b[i]);
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+
+template<class _String>
+void __bench_string_find(benchmark::State& state)
+{
+    std::string src = make_strings(1, state.range(0)).front();
+    src.replace(src.size() - 4, 4, "WXYZ");
+    _String s(src);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.find('W'));
+        benchmark::DoNotOptimize(s.find("WXYZ"));
+    }
+    state.SetBytesProcessed(state.iterations() * src.size() * 2);
+}
+
+
+// first character of the needle is everywhere
+template<class _String>
+void __bench_string_find_dense(benchmark::State& state)
+{
+    std::string src(state.range(0), 'a');
+    src.back() = 'b';
+    _String s(src);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(s.find("aab"));
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+
+template<class _String>
+void __bench_string_find_first_of(benchmark::State& state)
+{
+    std::string src = make_strings(1, state.range(0)).front();
+    src.back() = ';';
+    _String s(src);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(s.find_first_of(" \t,;:"));
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+
+
+void BM_std_string_hash(benchmark::State& state) {
+    __bench_string_hash<std::string>(state);
+}
+BENCHMARK(BM_std_string_hash)->Arg(4)->Arg(16)->Arg(64);
+
+void BM_compact_string_hash(benchmark::State& state) {
+    __bench_string_hash<compact::string>(state);
+}
+BENCHMARK(BM_compact_string_hash)->Arg(4)->Arg(16)->Arg(64);
+
+
+void BM_std_string_equal(benchmark::State& state) {
+    __bench_string_equal<std::string>(state);
+}
+BENCHMARK(BM_std_string_equal)->Arg(4)->Arg(16)->Arg(64);
+
+void BM_compact_string_equal(benchmark::State& state) {
+    __bench_string_equal<compact::string>(state);
+}
+BENCHMARK(BM_compact_string_equal)->Arg(4)->Arg(16)->Arg(64);
+
+
+void BM_std_string_find(benchmark::State& state) {
+    __bench_string_find<std::string>(state);
+}
+BENCHMARK(BM_std_string_find)->RangeMultiplier(4)->Range(16, 16 << 10);
+
+void BM_compact_string_find(benchmark::State& state) {
+    __bench_string_find<compact::string>(state);
+}
+BENCHMARK(BM_compact_string_find)->RangeMultiplier(4)->Range(16, 16 << 10);
+
+
+void BM_std_string_find_dense(benchmark::State& state) {
+    __bench_string_find_dense<std::string>(state);
+}
+BENCHMARK(BM_std_string_find_dense)->RangeMultiplier(4)->Range(16, 16 << 10);
+
+void BM_compact_string_find_dense(benchmark::State& state) {
+    __bench_string_find_dense<compact::string>(state);
+}
+BENCHMARK(BM_compact_string_find_dense)->RangeMultiplier(4)->Range(16, 16 << 10);
+
+
+void BM_std_string_find_first_of(benchmark::State& state) {
+    __bench_string_find_first_of<std::string>(state);
+}
+BENCHMARK(BM_std_string_find_first_of)->RangeMultiplier(4)->Range(16, 16 << 10);
+
+void BM_compact_string_find_first_of(benchmark::State& state) {
+    __bench_string_find_first_of<compact::string>(state);
+}
+BENCHMARK(BM_compact_string_find_first_of)->RangeMultiplier(4)->Range(16, 16 << 10);
@@ -0,0 +1,125 @@
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+#include <stlext/containers/circular_queue.hpp>
+#include <stlext/containers/concurrent_circular_queue.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// baseline: ring buffer guarded by mutex
+template<class _Tp>
+class locked_queue
+{
+public:
+    explicit locked_queue(size_t n) : __m_max_size(n), __m_buffer(n) {}
+
+    bool try_push(const _Tp& v) {
+        std::lock_guard<std::mutex> lock(__m_mutex);
+        if (__m_buffer.size() == __m_max_size)
+            return false;
+        __m_buffer.push_back(v);
+        return true;
+    }
+
+    bool try_pop(_Tp& v) {
+        std::lock_guard<std::mutex> lock(__m_mutex);
+        if (__m_buffer.empty())
+            return false;
+        v = __m_buffer.front();
+        __m_buffer.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex __m_mutex;
+    size_t __m_max_size;
+    stdx::ring_buffer<_Tp> __m_buffer;
+};
+
+
+static const size_t __messages = 1 << 18;
+
+// move __messages integers from range(0) producers to range(1) consumers
+template<class _Queue>
+void __bench_throughput(benchmark::State& state)
+{
+    const int nproducers = state.range(0);
+    const int nconsumers = state.range(1);
+
+    for (auto _ : state)
+    {
+        _Queue q(1024);
+        std::atomic<size_t> consumed(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nproducers; t++) {
+            threads.emplace_back([&, t] {
+                for (size_t i = t; i < __messages; i += nproducers)
+                    while (!q.try_push(i))
+                        std::this_thread::yield();
+            });
+        }
+        for (int t = 0; t < nconsumers; t++) {
+            threads.emplace_back([&] {
+                size_t v;
+                while (consumed.load(std::memory_order_relaxed) < __messages) {
+                    if (q.try_pop(v))
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+    state.SetItemsProcessed(state.iterations() * __messages);
+}
+
+// ping-pong between two threads over a pair of queues
+template<class _Queue>
+void __bench_round_trip(benchmark::State& state)
+{
+    const size_t rounds = 1 << 12;
+    for (auto _ : state)
+    {
+        _Queue ping(16), pong(16);
+        std::thread echo([&] {
+            size_t v;
+            for (size_t i = 0; i < rounds; i++) {
+                while (!ping.try_pop(v))
+                    std::this_thread::yield();
+                while (!pong.try_push(v))
+                    std::this_thread::yield();
+            }
+        });
+        size_t v;
+        for (size_t i = 0; i < rounds; i++) {
+            while (!ping.try_push(i))
+                std::this_thread::yield();
+            while (!pong.try_pop(v))
+                std::this_thread::yield();
+        }
+        echo.join();
+    }
+    state.SetItemsProcessed(state.iterations() * rounds);
+}
+
+
+void BM_locked_queue_throughput(benchmark::State& state) { __bench_throughput< locked_queue<size_t> >(state); }
+void BM_spsc_queue_throughput(benchmark::State& state) { __bench_throughput< stdx::spsc_circular_queue<size_t> >(state); }
+void BM_mpmc_queue_throughput(benchmark::State& state) { __bench_throughput< stdx::mpmc_circular_queue<size_t> >(state); }
+
+BENCHMARK(BM_locked_queue_throughput)->Args({1, 1})->Args({2, 2})->Args({4, 4})->UseRealTime();
+BENCHMARK(BM_spsc_queue_throughput)->Args({1, 1})->UseRealTime();
+BENCHMARK(BM_mpmc_queue_throughput)->Args({1, 1})->Args({2, 2})->Args({4, 4})->UseRealTime();
+
+void BM_locked_queue_round_trip(benchmark::State& state) { __bench_round_trip< locked_queue<size_t> >(state); }
+void BM_spsc_queue_round_trip(benchmark::State& state) { __bench_round_trip< stdx::spsc_circular_queue<size_t> >(state); }
+void BM_mpmc_queue_round_trip(benchmark::State& state) { __bench_round_trip< stdx::mpmc_circular_queue<size_t> >(state); }
+
+BENCHMARK(BM_locked_queue_round_trip)->UseRealTime();
+BENCHMARK(BM_spsc_queue_round_trip)->UseRealTime();
+BENCHMARK(BM_mpmc_queue_round_trip)->UseRealTime();
@@ -1,10 +1,13 @@
 #include <string>
 #include <vector>
 #include <random>
+#include <algorithm>
+#include <cstdint>
 
 #include <benchmark/benchmark.h>
 
 #include <stlext/algorithm/sorting/counting_sort.hpp>
+#include <stlext/algorithm/sorting/radix_sort.hpp>
 
 
 
@@ -71,3 +74,126 @@ void BM_counting_sort_proj(benchmark::State& state)
     state.SetLabel(success ? "[PASSED]" : "[FAILED]");
 }
 BENCHMARK(BM_counting_sort_proj)->RangeMultiplier(2)->Range(1024, 8<<10);
+
+
+template<class _Tp>
+std::vector<_Tp> radix_sort_input(size_t n)
+{
+    std::mt19937_64 rgen(n);
+    std::vector<_Tp> v(n);
+    std::generate(v.begin(), v.end(), [&rgen]() { 
+        return static_cast<_Tp>(rgen()); 
+    });
+    return v;
+}
+
+template<>
+std::vector<double> radix_sort_input<double>(size_t n)
+{
+    std::mt19937_64 rgen(n);
+    std::normal_distribution<double> distr(0.0, 1e6);
+    std::vector<double> v(n);
+    std::generate(v.begin(), v.end(), [&rgen, &distr]() { return distr(rgen); });
+    return v;
+}
+
+template<class _Tp, class _Sort>
+void radix_sort_benchmark(benchmark::State& state, _Sort sort)
+{
+    const auto input = radix_sort_input<_Tp>(state.range(0));
+    std::vector<_Tp> v;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        sort(v.begin(), v.end());
+    }
+
+    bool success = std::is_sorted(v.begin(), v.end());
+    state.SetLabel(success ? "[PASSED]" : "[FAILED]");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<class _Tp>
+void BM_std_sort(benchmark::State& state)
+{
+    radix_sort_benchmark<_Tp>(state, [](typename std::vector<_Tp>::iterator first, typename std::vector<_Tp>::iterator last) {
+        std::sort(first, last);
+    });
+}
+
+template<class _Tp, unsigned _DigitBits>
+void BM_lsd_radix_sort(benchmark::State& state)
+{
+    radix_sort_benchmark<_Tp>(state, [](typename std::vector<_Tp>::iterator first, typename std::vector<_Tp>::iterator last) {
+        stdx::lsd_radix_sort<_DigitBits>(first, last);
+    });
+}
+
+template<class _Tp>
+void BM_american_flag_sort(benchmark::State& state)
+{
+    radix_sort_benchmark<_Tp>(state, [](typename std::vector<_Tp>::iterator first, typename std::vector<_Tp>::iterator last) {
+        stdx::american_flag_sort(first, last);
+    });
+}
+
+#define RADIX_SORT_RANGE RangeMultiplier(10)->Range(1000000, 100000000)->Unit(benchmark::kMillisecond)
+
+BENCHMARK_TEMPLATE(BM_std_sort, uint32_t)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, uint32_t, 8)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, uint32_t, 11)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, uint32_t, 16)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_american_flag_sort, uint32_t)->RADIX_SORT_RANGE;
+
+BENCHMARK_TEMPLATE(BM_std_sort, int64_t)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, int64_t, 8)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, int64_t, 11)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, int64_t, 16)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_american_flag_sort, int64_t)->RADIX_SORT_RANGE;
+
+BENCHMARK_TEMPLATE(BM_std_sort, double)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_lsd_radix_sort, double, 11)->RADIX_SORT_RANGE;
+BENCHMARK_TEMPLATE(BM_american_flag_sort, double)->RADIX_SORT_RANGE;
+
+
+void BM_std_sort_strings(benchmark::State& state)
+{
+    std::mt19937 rgen(state.range(0));
+    std::vector<std::string> input(state.range(0));
+    for (auto& s : input) {
+        s.resize(8 + rgen() % 16);
+        for (auto& c : s) c = 'a' + rgen() % 26;
+    }
+    std::vector<std::string> v;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        std::sort(v.begin(), v.end());
+    }
+    state.SetLabel(std::is_sorted(v.begin(), v.end()) ? "[PASSED]" : "[FAILED]");
+}
+BENCHMARK(BM_std_sort_strings)->RangeMultiplier(10)->Range(100000, 1000000)->Unit(benchmark::kMillisecond);
+
+void BM_msd_radix_sort_strings(benchmark::State& state)
+{
+    std::mt19937 rgen(state.range(0));
+    std::vector<std::string> input(state.range(0));
+    for (auto& s : input) {
+        s.resize(8 + rgen() % 16);
+        for (auto& c : s) c = 'a' + rgen() % 26;
+    }
+    std::vector<std::string> v;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        stdx::msd_radix_sort(v.begin(), v.end());
+    }
+    state.SetLabel(std::is_sorted(v.begin(), v.end()) ? "[PASSED]" : "[FAILED]");
+}
+BENCHMARK(BM_msd_radix_sort_strings)->RangeMultiplier(10)->Range(100000, 1000000)->Unit(benchmark::kMillisecond);
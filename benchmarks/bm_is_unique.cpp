@@ -0,0 +1,105 @@
+
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+
+#include <stlext/algorithm/experimental.h>
+
+#include <benchmark/benchmark.h>
+
+
+// distinct shuffled integers spread over [0, n * spread)
+static std::vector<int64_t> __unique_data(size_t n, int64_t spread)
+{
+    std::vector<int64_t> v(n);
+    for (size_t i = 0; i < n; ++i)
+        v[i] = static_cast<int64_t>(i) * spread;
+    std::shuffle(v.begin(), v.end(), std::mt19937(static_cast<unsigned>(n)));
+    return v;
+}
+
+// reference: node based set, as is_unique used to be implemented
+template<class _InIt>
+static bool __is_unique_node_set(_InIt first, _InIt last)
+{
+    typedef typename std::iterator_traits<_InIt>::value_type value_type;
+    std::unordered_set<value_type> lookup(16);
+    for (; first != last; ++first) {
+        if (!lookup.insert(*first).second)
+            return false;
+    }
+    return true;
+}
+
+template<class _Container, class _Fx>
+static void __unique_benchmark(benchmark::State& state, const _Container& data, _Fx check)
+{
+    bool result = true;
+    for (auto _ : state)
+        result &= check(data);
+    benchmark::DoNotOptimize(result);
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+#define UNIQUE_RANGE RangeMultiplier(16)->Range(16, 1 << 20)
+
+void BM_is_unique_node_set(benchmark::State& state)
+{
+    __unique_benchmark(state, __unique_data(state.range(0), 7), [](const std::vector<int64_t>& v) {
+        return __is_unique_node_set(v.begin(), v.end());
+    });
+}
+BENCHMARK(BM_is_unique_node_set)->UNIQUE_RANGE;
+
+void BM_is_unique_narrow(benchmark::State& state)
+{
+    __unique_benchmark(state, __unique_data(state.range(0), 7), [](const std::vector<int64_t>& v) {
+        return stdx::is_unique(v.begin(), v.end());
+    });
+}
+BENCHMARK(BM_is_unique_narrow)->UNIQUE_RANGE;
+
+void BM_is_unique_wide(benchmark::State& state)
+{
+    __unique_benchmark(state, __unique_data(state.range(0), 1LL << 32), [](const std::vector<int64_t>& v) {
+        return stdx::is_unique(v.begin(), v.end());
+    });
+}
+BENCHMARK(BM_is_unique_wide)->UNIQUE_RANGE;
+
+void BM_is_unique_inplace(benchmark::State& state)
+{
+    const auto data = __unique_data(state.range(0), 1LL << 32);
+    std::vector<int64_t> buffer;
+    __unique_benchmark(state, data, [&buffer](const std::vector<int64_t>& v) {
+        buffer = v;
+        return stdx::is_unique_inplace(buffer.begin(), buffer.end());
+    });
+}
+BENCHMARK(BM_is_unique_inplace)->UNIQUE_RANGE;
+
+static std::vector<std::string> __string_data(size_t n)
+{
+    auto ints = __unique_data(n, 1LL << 32);
+    std::vector<std::string> v(n);
+    std::transform(ints.begin(), ints.end(), v.begin(), [](int64_t x) { return "key_" + std::to_string(x); });
+    return v;
+}
+
+void BM_is_unique_strings_node_set(benchmark::State& state)
+{
+    __unique_benchmark(state, __string_data(state.range(0)), [](const std::vector<std::string>& v) {
+        return __is_unique_node_set(v.begin(), v.end());
+    });
+}
+BENCHMARK(BM_is_unique_strings_node_set)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+void BM_is_unique_strings(benchmark::State& state)
+{
+    __unique_benchmark(state, __string_data(state.range(0)), [](const std::vector<std::string>& v) {
+        return stdx::is_unique(v.begin(), v.end());
+    });
+}
+BENCHMARK(BM_is_unique_strings)->RangeMultiplier(16)->Range(16, 1 << 16);
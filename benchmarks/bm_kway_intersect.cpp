@@ -0,0 +1,58 @@
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/algorithm/ext/kway_intersect.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// sorted posting lists of given lengths drawn from [0, universe)
+static std::vector< std::vector<uint32_t> > __make_lists(std::vector<size_t> sizes, uint32_t universe)
+{
+    std::mt19937 gen(static_cast<unsigned>(sizes.size()));
+    std::vector< std::vector<uint32_t> > lists;
+    for (size_t n : sizes) {
+        std::vector<uint32_t> l(n);
+        for (auto& x : l)
+            x = gen() % universe;
+        std::sort(l.begin(), l.end());
+        l.erase(std::unique(l.begin(), l.end()), l.end());
+        lists.push_back(std::move(l));
+    }
+    return lists;
+}
+
+static std::vector< std::vector<uint32_t> > __lists_for(int64_t scenario)
+{
+    switch (scenario) {
+    case 0:  // similar lengths
+        return __make_lists({ 200000, 250000, 300000 }, 1000000);
+    case 1:  // wildly different lengths
+        return __make_lists({ 1000, 100000, 1000000 }, 4000000);
+    default: // many lists of mixed lengths
+        return __make_lists({ 500, 300000, 20000, 800000, 5000, 100000, 60000, 900000, 2000, 400000 }, 1000000);
+    }
+}
+
+void BM_kway_intersect_linear(benchmark::State& state)
+{
+    auto lists = __lists_for(state.range(0));
+    std::vector<uint32_t> out(lists[0].size());
+    for (auto _ : state) {
+        auto last = stdx::__kway_intersect(lists, out.begin(), std::less<>{}, std::forward_iterator_tag());
+        benchmark::DoNotOptimize(last);
+    }
+}
+BENCHMARK(BM_kway_intersect_linear)->DenseRange(0, 2);
+
+void BM_kway_intersect_adaptive(benchmark::State& state)
+{
+    auto lists = __lists_for(state.range(0));
+    std::vector<uint32_t> out(lists[0].size());
+    for (auto _ : state) {
+        auto last = stdx::kway_intersect(lists, out.begin());
+        benchmark::DoNotOptimize(last);
+    }
+}
+BENCHMARK(BM_kway_intersect_adaptive)->DenseRange(0, 2);
@@ -0,0 +1,65 @@
+#include <queue>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/algorithm/ext/kway_merge.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+static const size_t __total = 1 << 20;
+
+static std::vector< std::vector<uint64_t> > __make_runs(size_t k)
+{
+    std::mt19937_64 gen(k);
+    std::vector< std::vector<uint64_t> > runs(k);
+    for (auto& r : runs) {
+        r.resize(__total / k);
+        for (auto& x : r)
+            x = gen();
+        std::sort(r.begin(), r.end());
+    }
+    return runs;
+}
+
+// baseline: binary heap of (value, run) pairs
+void BM_kway_merge_binary_heap(benchmark::State& state)
+{
+    typedef std::vector<uint64_t>::const_iterator iterator;
+    typedef std::pair<iterator, iterator> range;
+
+    auto runs = __make_runs(state.range(0));
+    std::vector<uint64_t> out(__total);
+    for (auto _ : state)
+    {
+        auto greater = [](const range& x, const range& y) { return *x.first > *y.first; };
+        std::priority_queue<range, std::vector<range>, decltype(greater)> queue(greater);
+        for (auto& r : runs)
+            queue.emplace(r.cbegin(), r.cend());
+
+        auto it = out.begin();
+        while (!queue.empty()) {
+            range r = queue.top();
+            queue.pop();
+            *it++ = *r.first++;
+            if (r.first != r.second)
+                queue.push(r);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * __total);
+}
+BENCHMARK(BM_kway_merge_binary_heap)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_kway_merge_loser_tree(benchmark::State& state)
+{
+    auto runs = __make_runs(state.range(0));
+    std::vector<uint64_t> out(__total);
+    for (auto _ : state) {
+        stdx::kway_merge(runs, out.begin());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * __total);
+}
+BENCHMARK(BM_kway_merge_loser_tree)->RangeMultiplier(4)->Range(4, 1024);
@@ -0,0 +1,48 @@
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/algorithm/sorting/parallel_sort.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+static std::vector<uint64_t> __random_keys(size_t n)
+{
+    std::mt19937_64 gen(n);
+    std::vector<uint64_t> v(n);
+    for (auto& x : v)
+        x = gen();
+    return v;
+}
+
+void BM_std_sort(benchmark::State& state)
+{
+    auto keys = __random_keys(state.range(0));
+    std::vector<uint64_t> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = keys;
+        state.ResumeTiming();
+        std::sort(v.begin(), v.end());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_std_sort)->Arg(1 << 20)->Arg(1 << 24)->UseRealTime();
+
+// range(1) threads, 0 - all hardware threads
+void BM_parallel_sort(benchmark::State& state)
+{
+    auto keys = __random_keys(state.range(0));
+    size_t nthreads = state.range(1) > 0 ? state.range(1) : std::thread::hardware_concurrency();
+    std::vector<uint64_t> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = keys;
+        state.ResumeTiming();
+        stdx::parallel_sort(v.begin(), v.end(), std::less<>(), nthreads);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_parallel_sort)->ArgsProduct({ { 1 << 20, 1 << 24 }, { 2, 4, 8, 0 } })->UseRealTime();
@@ -0,0 +1,86 @@
+#include <random>
+#include <vector>
+
+#include <stlext/containers/priority_map.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// Dijkstra-like workload: every key is inserted once,
+// gets several decrease-key updates and is popped
+template<class _PrioritySet>
+void __bench_decrease_key(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const size_t updates = 4 * n;
+
+    std::mt19937 gen(42);
+    std::vector<uint32_t> keys(updates);
+    std::vector<uint64_t> prios(updates);
+    for (size_t i = 0; i < updates; i++) {
+        keys[i] = gen() % n;
+        prios[i] = gen();
+    }
+
+    for (auto _ : state)
+    {
+        _PrioritySet ps;
+        ps.reserve(n);
+        for (size_t k = 0; k < n; k++)
+            ps.insert(uint32_t(k), uint64_t(-1));
+        for (size_t i = 0; i < updates; i++)
+            ps.update(keys[i], prios[i] >> (i * 16 / updates));
+        while (!ps.empty())
+            ps.pop_front();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * (2 * n + updates));
+}
+
+
+// fill and drain: every key is inserted and popped once
+template<class _PrioritySet>
+void __bench_insert(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+
+    std::mt19937 gen(42);
+    std::vector<uint32_t> keys(n);
+    std::vector<uint64_t> prios(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = gen();
+        prios[i] = gen();
+    }
+
+    for (auto _ : state)
+    {
+        _PrioritySet ps;
+        for (size_t i = 0; i < n; i++)
+            ps.insert(keys[i], prios[i]);
+        while (!ps.empty())
+            ps.pop_front();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * n);
+}
+
+
+void BM_priority_set_decrease_key(benchmark::State& state) {
+    __bench_decrease_key< stdx::priority_set<uint32_t, uint64_t> >(state);
+}
+BENCHMARK(BM_priority_set_decrease_key)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+void BM_heap_priority_set_decrease_key(benchmark::State& state) {
+    __bench_decrease_key< stdx::heap_priority_set<uint32_t, uint64_t> >(state);
+}
+BENCHMARK(BM_heap_priority_set_decrease_key)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+void BM_priority_set_insert(benchmark::State& state) {
+    __bench_insert< stdx::priority_set<uint32_t, uint64_t> >(state);
+}
+BENCHMARK(BM_priority_set_insert)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+void BM_heap_priority_set_insert(benchmark::State& state) {
+    __bench_insert< stdx::heap_priority_set<uint32_t, uint64_t> >(state);
+}
+BENCHMARK(BM_heap_priority_set_insert)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
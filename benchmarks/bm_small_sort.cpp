@@ -0,0 +1,100 @@
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include <stlext/algorithm/sorting/simd_sort.hpp>
+#include <stlext/algorithm/sorting/small_sort.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+template<class _Tp>
+static std::vector<_Tp> __random_values(size_t n)
+{
+    std::mt19937_64 gen(n);
+    std::vector<_Tp> v(n);
+    for (auto& x : v)
+        x = static_cast<_Tp>(static_cast<int64_t>(gen()) >> 16);
+    return v;
+}
+
+// sort 64K values as consecutive arrays of state.range(0) elements
+template<class _Tp, class _Sort>
+static void __sort_arrays(benchmark::State& state, _Sort sort)
+{
+    const size_t k = state.range(0);
+    const auto input = __random_values<_Tp>(65536);
+    std::vector<_Tp> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        for (size_t i = 0; i + k <= v.size(); i += k)
+            sort(v.data() + i, v.data() + i + k);
+    }
+    state.SetItemsProcessed(state.iterations() * (v.size() / k));
+}
+
+template<class _Tp>
+void BM_std_sort_arrays(benchmark::State& state)
+{
+    __sort_arrays<_Tp>(state, [](_Tp* first, _Tp* last) { std::sort(first, last); });
+}
+
+template<class _Tp>
+void BM_small_sort_arrays(benchmark::State& state)
+{
+    __sort_arrays<_Tp>(state, [](_Tp* first, _Tp* last) { stdx::small_sort(first, last); });
+}
+
+BENCHMARK_TEMPLATE(BM_std_sort_arrays, int32_t)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_small_sort_arrays, int32_t)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_std_sort_arrays, int64_t)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_small_sort_arrays, int64_t)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_std_sort_arrays, float)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_small_sort_arrays, float)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_std_sort_arrays, double)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_small_sort_arrays, double)->RangeMultiplier(2)->Range(8, 64);
+BENCHMARK_TEMPLATE(BM_std_sort_arrays, int32_t)->Arg(13)->Arg(27);
+BENCHMARK_TEMPLATE(BM_small_sort_arrays, int32_t)->Arg(13)->Arg(27);
+
+
+template<class _Tp, class _Sort>
+static void __sort_range(benchmark::State& state, _Sort sort)
+{
+    const auto input = __random_values<_Tp>(state.range(0));
+    std::vector<_Tp> v;
+    for (auto _ : state) {
+        state.PauseTiming();
+        v = input;
+        state.ResumeTiming();
+        sort(v.begin(), v.end());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+template<class _Tp>
+void BM_std_sort_range(benchmark::State& state)
+{
+    __sort_range<_Tp>(state, [](typename std::vector<_Tp>::iterator first, typename std::vector<_Tp>::iterator last) {
+        std::sort(first, last);
+    });
+}
+
+template<class _Tp>
+void BM_simd_sort_range(benchmark::State& state)
+{
+    __sort_range<_Tp>(state, [](typename std::vector<_Tp>::iterator first, typename std::vector<_Tp>::iterator last) {
+        stdx::simd_sort(first, last);
+    });
+}
+
+BENCHMARK_TEMPLATE(BM_std_sort_range, int32_t)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_simd_sort_range, int32_t)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_std_sort_range, int64_t)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_simd_sort_range, int64_t)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_std_sort_range, float)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_simd_sort_range, float)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_std_sort_range, double)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_simd_sort_range, double)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
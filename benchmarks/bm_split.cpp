@@ -0,0 +1,171 @@
+
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <istream>
+#include <experimental/string_view>
+
+#include <stlext/algorithm/experimental.h>
+#include <stlext/functional/predicates.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+// TSV lines: id, count, price, name
+static const std::vector<std::string>& __tsv_lines()
+{
+    static std::vector<std::string> lines;
+    if (lines.empty()) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> ids(0, 1 << 30);
+        std::uniform_int_distribution<int> counts(0, 10000);
+        std::uniform_int_distribution<int> cents(0, 99999);
+        for (int i = 0; i < 4096; ++i) {
+            int c = cents(gen);
+            lines.push_back(std::to_string(ids(gen)) + "\t" + std::to_string(counts(gen)) + "\t" +
+                            std::to_string(c / 100) + "." + std::to_string(c % 100) + "\tproduct_" + std::to_string(i));
+        }
+    }
+    return lines;
+}
+
+// field wrapper read with operator>>, forces the stream based path
+template<class _Tp>
+struct __streamed { _Tp value; };
+
+template<class _Tp>
+std::istream& operator>>(std::istream& is, __streamed<_Tp>& x) {
+    return (is >> x.value);
+}
+
+template<class _Fx>
+static void __split_benchmark(benchmark::State& state, _Fx parse)
+{
+    const auto& lines = __tsv_lines();
+    double sum = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        for (const auto& line : lines) 
+            sum += parse(line);
+    }
+    for (const auto& line : lines)
+        bytes += line.size();
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * lines.size() * 4);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+void BM_split_into_stringstream(benchmark::State& state)
+{
+    __split_benchmark(state, [](const std::string& line) {
+        __streamed<long> id; __streamed<int> count; __streamed<double> price; __streamed<std::string> name;
+        stdx::split_into(line, '\t', id, count, price, name);
+        return id.value + count.value + price.value + name.value.size();
+    });
+}
+BENCHMARK(BM_split_into_stringstream);
+
+void BM_split_into(benchmark::State& state)
+{
+    __split_benchmark(state, [](const std::string& line) {
+        long id; int count; double price; std::experimental::string_view name;
+        stdx::split_into(line, '\t', id, count, price, name);
+        return id + count + price + name.size();
+    });
+}
+BENCHMARK(BM_split_into);
+
+void BM_split_into_any_of(benchmark::State& state)
+{
+    static const auto delims = stdx::is_any_of({ '\t', ';' });
+    __split_benchmark(state, [](const std::string& line) {
+        long id; int count; double price; std::experimental::string_view name;
+        stdx::split_into(line, delims, id, count, price, name);
+        return id + count + price + name.size();
+    });
+}
+BENCHMARK(BM_split_into_any_of);
+
+void BM_split_copy_string(benchmark::State& state)
+{
+    std::vector<std::string> tokens;
+    __split_benchmark(state, [&tokens](const std::string& line) {
+        tokens.clear();
+        stdx::split_copy(line.begin(), line.end(), std::back_inserter(tokens), [](char c) { return c == '\t'; });
+        return tokens.size();
+    });
+}
+BENCHMARK(BM_split_copy_string);
+
+void BM_split_copy_view(benchmark::State& state)
+{
+    std::vector<std::experimental::string_view> tokens;
+    __split_benchmark(state, [&tokens](const std::string& line) {
+        tokens.clear();
+        stdx::split_copy(line, std::back_inserter(tokens), '\t');
+        return tokens.size();
+    });
+}
+BENCHMARK(BM_split_copy_view);
+
+
+// one large CSV document, 1MB
+static const std::string& __csv_text()
+{
+    static std::string text;
+    if (text.empty()) {
+        const auto& lines = __tsv_lines();
+        for (size_t i = 0; text.size() < (1 << 20); ++i) {
+            std::string line = lines[i % lines.size()];
+            std::replace(line.begin(), line.end(), '\t', ',');
+            text += line + (i % 3 ? ",\"quoted, field\"\n" : ",plain field\n");
+        }
+    }
+    return text;
+}
+
+template<class _Fx>
+static void __scan_benchmark(benchmark::State& state, _Fx scan)
+{
+    const auto& text = __csv_text();
+    size_t count = 0;
+    for (auto _ : state)
+        count += scan(text);
+    benchmark::DoNotOptimize(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_split_scan(benchmark::State& state)
+{
+    __scan_benchmark(state, [](const std::string& text) {
+        size_t n = 0;
+        stdx::split(text.begin(), text.end(), [](char c) { return c == ',' || c == '\n'; }, [&n](auto, auto) { ++n; });
+        return n;
+    });
+}
+BENCHMARK(BM_split_scan);
+
+void BM_tokenizer_scan(benchmark::State& state)
+{
+    __scan_benchmark(state, [](const std::string& text) {
+        size_t n = 0;
+        for (auto token : stdx::tokenize(text, ",\n"))
+            n += !token.empty();
+        return n;
+    });
+}
+BENCHMARK(BM_tokenizer_scan);
+
+void BM_tokenizer_scan_quoted(benchmark::State& state)
+{
+    __scan_benchmark(state, [](const std::string& text) {
+        size_t n = 0;
+        stdx::tokenizer range(text.data(), text.data() + text.size(), ",\n", stdx::empty_tokens::keep, '"');
+        for (auto token : range)
+            n += !token.empty();
+        return n;
+    });
+}
+BENCHMARK(BM_tokenizer_scan_quoted);
@@ -0,0 +1,85 @@
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include <stlext/algorithm/searching.h>
+
+#include <benchmark/benchmark.h>
+
+
+// sorted distinct keys with random gaps and existing keys to look up
+struct __search_data
+{
+    std::vector<int32_t> keys;
+    std::vector<int32_t> queries;
+
+    explicit __search_data(size_t n) : keys(n), queries(1 << 16) {
+        std::mt19937 gen(static_cast<unsigned>(n));
+        int32_t x = (std::numeric_limits<int32_t>::min)();
+        for (auto& k : keys) 
+            k = (x += 1 + static_cast<int32_t>(gen() % 3));
+        for (auto& q : queries) 
+            q = keys[gen() % n];
+    }
+
+    static const __search_data& get(size_t n) {
+        static std::unique_ptr<__search_data> data;
+        if (!data || data->keys.size() != n)
+            data.reset(new __search_data(n));
+        return *data;
+    }
+};
+
+template<class _Search>
+static void __search_benchmark(benchmark::State& state, _Search search)
+{
+    const auto& data = __search_data::get(state.range(0));
+    size_t sum = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        sum += search(data, data.queries[i]);
+        i = (i + 1) & (data.queries.size() - 1);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define SEARCH_RANGE RangeMultiplier(8)->Range(1 << 10, 1 << 30)
+
+void BM_std_lower_bound(benchmark::State& state)
+{
+    __search_benchmark(state, [](const __search_data& d, int32_t x) { 
+        return std::lower_bound(d.keys.begin(), d.keys.end(), x) - d.keys.begin(); 
+    });
+}
+BENCHMARK(BM_std_lower_bound)->SEARCH_RANGE;
+
+void BM_interpolation_search(benchmark::State& state)
+{
+    __search_benchmark(state, [](const __search_data& d, int32_t x) { 
+        return stdx::interpolation_search(d.keys.begin(), d.keys.end(), x, [](int32_t k) { return k; }) - d.keys.begin(); 
+    });
+}
+BENCHMARK(BM_interpolation_search)->SEARCH_RANGE;
+
+void BM_exponential_search(benchmark::State& state)
+{
+    __search_benchmark(state, [](const __search_data& d, int32_t x) { 
+        return stdx::exponential_search(d.keys.begin(), d.keys.end(), x) - d.keys.begin(); 
+    });
+}
+BENCHMARK(BM_exponential_search)->SEARCH_RANGE;
+
+template<class _Layout>
+void BM_static_search_index(benchmark::State& state)
+{
+    const auto& data = __search_data::get(state.range(0));
+    stdx::static_search_index<int32_t, _Layout> index(data.keys.begin(), data.keys.end());
+    __search_benchmark(state, [&index](const __search_data&, int32_t x) { 
+        return index.lower_bound(x); 
+    });
+}
+BENCHMARK_TEMPLATE(BM_static_search_index, stdx::eytzinger_layout)->SEARCH_RANGE;
+BENCHMARK_TEMPLATE(BM_static_search_index, stdx::btree_layout)->SEARCH_RANGE;
@@ -5,6 +5,7 @@
 
 #include <unordered_set>
 #include <stlext/containers/stringset.hpp>
+#include <stlext/containers/static_stringset.hpp>
 
 #include <benchmark/benchmark.h>
 
@@ -91,6 +92,61 @@ size_t __bench_uset_insert_clear(benchmark::State& state)
 }
 
 
+template<class _USet>
+size_t __bench_uset_lookup(benchmark::State& state, bool hit)
+{
+    using namespace std;
+
+    size_t n = state.range(0);
+    vector<string> elems(n);
+    size_t s = make_array(elems);
+
+    _USet mapping;
+    mapping.reserve(n);
+    for (size_t k = 0; k < n; k++)
+        mapping.insert(elems[k]);
+
+    vector<string> keys(elems);
+    if (!hit) {
+        // prefix byte never produced by make_array()
+        for (size_t k = 0; k < n; k++)
+            keys[k].insert(keys[k].begin(), char(127));
+    }
+    shuffle(keys.begin(), keys.end(), mt19937());
+
+    for (auto _ : state) {
+        for (size_t k = 0; k < n; k++)
+            benchmark::DoNotOptimize(mapping.count(keys[k]));
+    }
+    return s;
+}
+
+
+size_t __bench_static_lookup(benchmark::State& state, bool hit)
+{
+    using namespace std;
+
+    size_t n = state.range(0);
+    vector<string> elems(n);
+    size_t s = make_array(elems);
+
+    stdx::static_stringset mapping(elems.begin(), elems.end());
+
+    vector<string> keys(elems);
+    if (!hit) {
+        for (size_t k = 0; k < n; k++)
+            keys[k].insert(keys[k].begin(), char(127));
+    }
+    shuffle(keys.begin(), keys.end(), mt19937());
+
+    for (auto _ : state) {
+        for (size_t k = 0; k < n; k++)
+            benchmark::DoNotOptimize(mapping.count(keys[k]));
+    }
+    return s;
+}
+
+
 template<class _USet>
 size_t __bench_uset_traverse(benchmark::State& state)
 {
@@ -160,6 +216,58 @@ BENCHMARK(BM_string_set_insert_clear)->RangeMultiplier(2)->Range(8, 1 << 20);
 
 
 
+void BM_unordered_set_lookup_hit(benchmark::State& state)
+{
+    size_t n = __bench_uset_lookup< std::unordered_set<std::string> >(state, true);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_unordered_set_lookup_hit)->RangeMultiplier(4)->Range(8, 1 << 20);
+
+void BM_string_set_lookup_hit(benchmark::State& state)
+{
+    size_t n = __bench_uset_lookup< stdx::stringset >(state, true);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_string_set_lookup_hit)->RangeMultiplier(4)->Range(8, 1 << 20);
+
+void BM_static_string_set_lookup_hit(benchmark::State& state)
+{
+    size_t n = __bench_static_lookup(state, true);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_static_string_set_lookup_hit)->RangeMultiplier(4)->Range(8, 1 << 20);
+
+
+
+void BM_unordered_set_lookup_miss(benchmark::State& state)
+{
+    size_t n = __bench_uset_lookup< std::unordered_set<std::string> >(state, false);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_unordered_set_lookup_miss)->RangeMultiplier(4)->Range(8, 1 << 20);
+
+void BM_string_set_lookup_miss(benchmark::State& state)
+{
+    size_t n = __bench_uset_lookup< stdx::stringset >(state, false);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_string_set_lookup_miss)->RangeMultiplier(4)->Range(8, 1 << 20);
+
+void BM_static_string_set_lookup_miss(benchmark::State& state)
+{
+    size_t n = __bench_static_lookup(state, false);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_static_string_set_lookup_miss)->RangeMultiplier(4)->Range(8, 1 << 20);
+
+
+
 void BM_unordered_set_traverse(benchmark::State& state)
 {
     size_t n = __bench_uset_traverse< std::unordered_set<std::string> >(state);
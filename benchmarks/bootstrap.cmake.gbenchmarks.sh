@@ -13,9 +13,21 @@ echo 'set(CMAKE_LFLAGS "${CMAKE_LFLAGS} -fsanitize=address")'
 echo 'include_directories(../ ${CMAKE_CURRENT_SOURCE_DIR})'
 echo 'add_executable(${PROJECT_NAME}'
 echo '  bm_bitvector.cpp'
+echo '  bm_bucket_sort.cpp'
+echo '  bm_circular_queue.cpp'
+echo '  bm_compact_string.cpp'
+echo '  bm_concurrent_queue.cpp'
 echo '  bm_counting_sort.cpp'
+echo '  bm_is_unique.cpp'
+echo '  bm_kway_intersect.cpp'
+echo '  bm_kway_merge.cpp'
 echo '  bm_main.cpp'
 echo '  bm_packed_hashtbl.cpp'
+echo '  bm_parallel_sort.cpp'
+echo '  bm_priority_set.cpp'
+echo '  bm_small_sort.cpp'
+echo '  bm_split.cpp'
+echo '  bm_static_search_index.cpp'
 echo '  bm_stringset.cpp'
 echo ')'
 echo 'target_link_libraries(${PROJECT_NAME} ${GBENCHMARK_LIBRARY} ${GBENCHMARK_MAINLIB} ${PTHREAD_LIBRARY})'
@@ -43,6 +43,7 @@
 
 #include "ext/stralgo.hpp"
 #include "ext/split.hpp"
+#include "ext/tokenizer.hpp"
 #include "ext/regex_split.hpp"
 #include "ext/join.hpp"
 
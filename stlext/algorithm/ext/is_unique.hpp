@@ -35,11 +35,266 @@
 #include <string>
 #include <unordered_set>
 #include <bitset>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
 #include "../../platform/common.h"
+#include "../../platform/bits.h"
+#include "../../bitvector/bitvector.hpp"
+#include "kway_utility.hpp"
+
+/*
+ * Ranges up to this size are checked by comparing
+ * all pairs of elements, without any lookup structure.
+ */
+#ifndef _IS_UNIQUE_SMALL_SIZE
+#	define _IS_UNIQUE_SMALL_SIZE 32
+#endif
+
+/*
+ * Integers are checked with presence bitmap while range
+ * of values spans at most this many bits per element.
+ */
+#ifndef _IS_UNIQUE_BITMAP_RATIO
+#	define _IS_UNIQUE_BITMAP_RATIO 64
+#endif
 
 _STDX_BEGIN
 
+namespace detail
+{
+	// hash and predicate define plain value equality
+	template<class _Tp, class _Hash, class _Pred>
+	struct __is_value_equality : std::integral_constant<bool,
+		std::is_same<_Hash, std::hash<_Tp>>::value &&
+		(std::is_same<_Pred, std::equal_to<_Tp>>::value || std::is_same<_Pred, std::equal_to<>>::value)> {};
+
+	// all pairs comparison with early exit
+	template<class _FwdIt, class _Pred>
+	bool __is_unique_pairwise(_FwdIt first, _FwdIt last, _Pred p)
+	{
+		for (; first != last; ++first) {
+			for (_FwdIt it = std::next(first); it != last; ++it) {
+				if (p(*first, *it))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	template<class _Tp>
+	struct __use_simd_unique : std::integral_constant<bool,
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+		std::is_integral<_Tp>::value && (sizeof(_Tp) == 4 || sizeof(_Tp) == 8)
+#else
+		false
+#endif
+	> {};
+
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+	inline __m256i __simd_broadcast(const int32_t* x) { return _mm256_set1_epi32(*x); }
+	inline __m256i __simd_broadcast(const int64_t* x) { return _mm256_set1_epi64x(*x); }
+	inline __m256i __simd_cmpeq(__m256i a, __m256i b, const int32_t*) { return _mm256_cmpeq_epi32(a, b); }
+	inline __m256i __simd_cmpeq(__m256i a, __m256i b, const int64_t*) { return _mm256_cmpeq_epi64(a, b); }
+
+	/*
+	 * All pairs comparison of small array: every element is
+	 * broadcast and compared with following elements a register
+	 * at a time, stopping at the first match.
+	 */
+	template<class _Tp>
+	bool __is_unique_simd(const _Tp* first, const _Tp* last)
+	{
+		typedef typename std::conditional<sizeof(_Tp) == 4, int32_t, int64_t>::type lane_type;
+		static constexpr ptrdiff_t lanes = 32 / sizeof(_Tp);
+
+		const lane_type* data = reinterpret_cast<const lane_type*>(first);
+		const ptrdiff_t n = last - first;
+		for (ptrdiff_t i = 0; i + 1 < n; ++i)
+		{
+			const __m256i x = __simd_broadcast(data + i);
+			ptrdiff_t j = i + 1;
+			for (; j + lanes <= n; j += lanes) {
+				__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + j));
+				__m256i eq = __simd_cmpeq(x, y, data);
+				if (!_mm256_testz_si256(eq, eq))
+					return false;
+			}
+			for (; j < n; ++j) {
+				if (data[j] == data[i])
+					return false;
+			}
+		}
+		return true;
+	}
+#endif
+
+	template<class _FwdIt, class _Pred>
+	inline bool __is_unique_small(_FwdIt first, _FwdIt last, _Pred p, std::false_type /*simd*/) {
+		return __is_unique_pairwise(first, last, p);
+	}
+
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+	template<class _FwdIt, class _Pred>
+	inline bool __is_unique_small(_FwdIt first, _FwdIt last, _Pred, std::true_type /*simd*/) {
+		return __is_unique_simd(&*first, &*first + std::distance(first, last));
+	}
+#endif
+
+	/*
+	 * Presence bitmap check for integers.
+	 * \return -1 if range of values is too wide for bitmap,
+	 * otherwise 1 if all values are unique and 0 if not
+	 */
+	template<class _FwdIt>
+	int __is_unique_bitmap(_FwdIt first, _FwdIt last, size_t n, std::true_type /*integral*/)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+		typedef typename std::make_unsigned<value_type>::type unsigned_type;
+
+		auto bounds = std::minmax_element(first, last);
+		unsigned_type lo = static_cast<unsigned_type>(*bounds.first);
+		uint64_t span = static_cast<uint64_t>(static_cast<unsigned_type>(static_cast<unsigned_type>(*bounds.second) - lo));
+		if (span >= static_cast<uint64_t>(n) * _IS_UNIQUE_BITMAP_RATIO)
+			return -1;
+
+		stdx::bitvector<uint64_t> seen(static_cast<size_t>(span) + 1);
+		for (; first != last; ++first) {
+			size_t pos = static_cast<size_t>(static_cast<unsigned_type>(static_cast<unsigned_type>(*first) - lo));
+			if (seen.test(pos))
+				return 0;
+			seen.set(pos);
+		}
+		return 1;
+	}
+
+	template<class _FwdIt>
+	inline int __is_unique_bitmap(_FwdIt, _FwdIt, size_t, std::false_type /*integral*/) {
+		return -1;
+	}
+
+	/*
+	 * Slots of __unique_flat_set keep small trivial values
+	 * themselves, otherwise iterators pointing to them.
+	 */
+	template<class _FwdIt, bool = 
+		std::is_trivially_copyable<typename std::iterator_traits<_FwdIt>::value_type>::value &&
+		std::is_trivially_default_constructible<typename std::iterator_traits<_FwdIt>::value_type>::value &&
+		(sizeof(typename std::iterator_traits<_FwdIt>::value_type) <= 16)>
+	struct __unique_slot
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type type;
+		static inline type make(_FwdIt it) { return *it; }
+		static inline const type& get(const type& slot) { return slot; }
+	};
+
+	template<class _FwdIt>
+	struct __unique_slot<_FwdIt, false>
+	{
+		typedef _FwdIt type;
+		static inline type make(_FwdIt it) { return it; }
+		static inline typename std::iterator_traits<_FwdIt>::reference get(const type& slot) { return *slot; }
+	};
+
+	/*
+	 * Insert-only open addressing set with linear probing.
+	 * Capacity is fixed up front to at least twice the number of
+	 * elements, so it never rehashes. Each slot has a control byte
+	 * holding 7 bits of hash, which rejects most probes without
+	 * invoking the predicate.
+	 */
+	template<class _FwdIt, class _Hash, class _Pred>
+	class __unique_flat_set
+	{
+		typedef __unique_slot<_FwdIt> slot_traits;
+		typedef typename slot_traits::type slot_type;
+
+	public:
+		__unique_flat_set(size_t n, const _Hash& hs, const _Pred& p) :
+			__m_hash(hs), __m_pred(p)
+		{
+			size_t capacity = 16;
+			while (capacity < 2 * n)
+				capacity <<= 1;
+			__m_mask = capacity - 1;
+			__m_ctrl.assign(capacity, 0);
+			__m_slots.resize(capacity);
+		}
+
+		//! \return false if element equal to *it is already inserted
+		bool insert(_FwdIt it)
+		{
+			const uint64_t h = static_cast<uint64_t>(__m_hash(*it)) * 0x9E3779B97F4A7C15ULL; // spread low bits
+			const uint8_t tag = static_cast<uint8_t>(0x80 | (h >> 57));
+			for (size_t pos = static_cast<size_t>(h >> 32) & __m_mask;; pos = (pos + 1) & __m_mask)
+			{
+				if (__m_ctrl[pos] == 0) {
+					__m_ctrl[pos] = tag;
+					__m_slots[pos] = slot_traits::make(it);
+					return true;
+				}
+				if (__m_ctrl[pos] == tag && __m_pred(slot_traits::get(__m_slots[pos]), *it))
+					return false;
+			}
+		}
+
+	private:
+		_Hash __m_hash;
+		_Pred __m_pred;
+		size_t __m_mask;
+		std::vector<uint8_t> __m_ctrl;
+		std::vector<slot_type> __m_slots;
+	};
+
+	template<class _InIt, class _Hash, class _Pred>
+	bool __is_unique(_InIt first, _InIt last, _Hash hs, _Pred p, std::input_iterator_tag)
+	{
+		typedef typename std::iterator_traits<_InIt>::value_type value_type;
+		std::unordered_set<value_type, _Hash, _Pred> lookup(16, hs, p);
+		for (; first != last; ++first) {
+			auto it = lookup.find(*first);
+			if (it != lookup.end())
+				return false;
+			lookup.emplace(*first);
+		}
+		return true;
+	}
+
+	template<class _FwdIt, class _Hash, class _Pred>
+	bool __is_unique(_FwdIt first, _FwdIt last, _Hash hs, _Pred p, std::forward_iterator_tag)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+		typedef __is_value_equality<value_type, _Hash, _Pred> is_value_equality;
+
+		const size_t n = static_cast<size_t>(std::distance(first, last));
+		if (n < 2)
+			return true;
+
+		if (n <= _IS_UNIQUE_SMALL_SIZE) {
+			typedef std::integral_constant<bool, is_value_equality::value &&
+				__use_simd_unique<value_type>::value &&
+				utility::__is_contiguous_iterator<_FwdIt>::value> use_simd;
+			return __is_unique_small(first, last, p, use_simd());
+		}
+
+		typedef std::integral_constant<bool, is_value_equality::value &&
+			std::is_integral<value_type>::value && !std::is_same<value_type, bool>::value> use_bitmap;
+		int result = __is_unique_bitmap(first, last, n, use_bitmap());
+		if (result >= 0)
+			return (result != 0);
+
+		__unique_flat_set<_FwdIt, _Hash, _Pred> lookup(n, hs, p);
+		for (; first != last; ++first) {
+			if (!lookup.insert(first))
+				return false;
+		}
+		return true;
+	}
+} // end namespace detail
+
+
 
 /*!
 * \fn is_unique (_InIt first, _InIt last)
@@ -50,19 +305,17 @@ _STDX_BEGIN
 * \param last  One past the end of the sequence.
 * \param p     A binary predicate that returns true if two elements are equal.
 * \return true whatever all elements in range [first, last) are unique, otherwise return false
+* \note for forward iterators the check does not allocate per element: small ranges
+* are compared pairwise (with AVX2 for contiguous integers), integers of narrow
+* value range are tracked in a bitvector, and other elements are inserted into
+* open addressing set sized from distance(first, last). Single pass iterators
+* use std::unordered_set.
 */
 template<class _InIt, class _Hash, class _Pred>
-bool is_unique(_InIt first, _InIt last, _Hash hs, _Pred p)
+inline bool is_unique(_InIt first, _InIt last, _Hash hs, _Pred p)
 {
-	typedef typename std::iterator_traits<_InIt>::value_type value_type;
-	std::unordered_set<value_type, _Hash, _Pred> lookup(16, hs, p);
-	for (; first != last; ++first) {
-		auto it = lookup.find(*first);
-		if (it != lookup.end())
-			return false;
-		lookup.emplace(*first);
-	}
-	return true;
+	typedef typename std::iterator_traits<_InIt>::iterator_category iterator_category;
+	return detail::__is_unique(first, last, hs, p, iterator_category());
 }
 
 
@@ -102,6 +355,39 @@ inline bool is_unique(_InIt first, _InIt last)
 }
 
 
+/*!
+* \fn is_unique_inplace (_RanIt first, _RanIt last, _Comp comp)
+* \brief check whatever all elements in range [first, last) are unique by sorting the range
+* \tparam _RanIt models random access iterator
+* \tparam _Comp models strict weak ordering
+* \param first The start of the sequence to be tested.
+* \param last  One past the end of the sequence.
+* \param comp  A comparison function, elements are unique if none of them are equivalent.
+* \return true whatever all elements in range [first, last) are unique, otherwise return false
+* \note needs no additional memory, but leaves range sorted with respect to comp
+*/
+template<class _RanIt, class _Comp>
+bool is_unique_inplace(_RanIt first, _RanIt last, _Comp comp)
+{
+	std::sort(first, last, comp);
+	return (std::adjacent_find(first, last, [&comp](const auto& x, const auto& y) { return !comp(x, y); }) == last);
+}
+
+/*!
+* \fn is_unique_inplace (_RanIt first, _RanIt last)
+* \brief check whatever all elements in range [first, last) are unique by sorting the range
+* \tparam _RanIt models random access iterator
+* \param first The start of the sequence to be tested.
+* \param last  One past the end of the sequence.
+* \return true whatever all elements in range [first, last) are unique, otherwise return false
+* \note needs no additional memory, but leaves range sorted
+*/
+template<class _RanIt>
+inline bool is_unique_inplace(_RanIt first, _RanIt last) {
+	return is_unique_inplace(first, last, std::less<>());
+}
+
+
 
 ///
 /// --- OVERLOADS
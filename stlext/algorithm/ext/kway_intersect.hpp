@@ -34,15 +34,29 @@
 #include <iterator>
 #include <queue>
 #include <stack>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
 
 #ifdef _HAVE_BOOST_LIBS
 #include <boost/heap/pairing_heap.hpp>
 #endif
 
 #include "../../platform/common.h"
+#include "../../platform/bits.h"
 
+#include "../searching/exponential_search.hpp"
 #include "kway_utility.hpp"
 
+/*
+ * Length ratio of two lists starting from which the shorter
+ * list drives exponential search through the longer one
+ * instead of merging them side by side.
+ */
+#ifndef _KWAY_GALLOP_RATIO
+#define _KWAY_GALLOP_RATIO 32
+#endif
+
 _STDX_BEGIN
 
 
@@ -218,10 +232,224 @@ _OutIt __kway_intersect_large(const std::vector< _Container >& inputs, _OutIt ou
 #endif // _HAVE_BOOST_LIBS
 
 
-// k-way intersect
+namespace detail
+{
+    // two-list kernels: write elements of [first1, last1) found in [first2, last2),
+    // output may alias first input (it never overtakes the read position)
+
+    template<class _RanIt1, class _RanIt2, class _OutIt, class _Comp>
+    _OutIt __intersect_gallop(_RanIt1 first1, _RanIt1 last1, 
+                              _RanIt2 first2, _RanIt2 last2, 
+                              _OutIt out, _Comp comp)
+    {
+        for (; first1 != last1; ++first1) {
+            first2 = exponential_search(first2, last2, *first1, comp);
+            if (first2 == last2)
+                break;
+            if (!comp(*first1, *first2)) {
+                *out = *first1; ++out;
+            }
+        }
+        return out;
+    }
+
+    template<class _RanIt1, class _RanIt2, class _OutIt, class _Comp>
+    _OutIt __intersect_merge(_RanIt1 first1, _RanIt1 last1, 
+                             _RanIt2 first2, _RanIt2 last2, 
+                             _OutIt out, _Comp comp)
+    {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2))
+                ++first1;
+            else if (comp(*first2, *first1))
+                ++first2;
+            else {
+                *out = *first1; ++out; ++first1;
+            }
+        }
+        return out;
+    }
+
+#ifndef __STDX_DISABLE_SIMD_OPTIMIZATION__
+#ifdef __SSE2__
+    // append v to out[0, k) unless it equals the last written element
+    template<class _Int>
+    inline void __emit_unique(_Int* out, size_t& k, _Int v) {
+        if (k == 0 || out[k - 1] != v)
+            out[k++] = v;
+    }
+
+    // block intersection of 32-bit integer lists: every element of 
+    // a block of the first list is compared against all elements of 
+    // a block of the second one, then the block with the smaller 
+    // last element is advanced (both on tie).
+    // Block of the first list may match several blocks of the second
+    // one, so duplicates are dropped on output: this keeps output 
+    // sorted, unique and never ahead of the read position in a
+    template<class _Int>
+    size_t __intersect_simd(const _Int* a, size_t na, const _Int* b, size_t nb, _Int* out)
+    {
+        static_assert(sizeof(_Int) == 4, "32-bit integers expected");
+
+        size_t i = 0, j = 0, k = 0;
+#ifdef __AVX2__
+        const __m256i rot = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        for (; i + 8 <= na && j + 8 <= nb; )
+        {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+            __m256i eq = _mm256_cmpeq_epi32(va, vb);
+            for (int r = 1; r < 8; r++) {
+                vb = _mm256_permutevar8x32_epi32(vb, rot);
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+            }
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+            for (; mask != 0; mask &= mask - 1)
+                __emit_unique(out, k, a[i + __builtin_ctz(mask)]);
+
+            _Int amax = a[i + 7], bmax = b[j + 7];
+            i += (amax <= bmax) ? 8 : 0;
+            j += (bmax <= amax) ? 8 : 0;
+        }
+#endif
+        for (; i + 4 <= na && j + 4 <= nb; )
+        {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i eq = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(va, vb), 
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+            for (; mask != 0; mask &= mask - 1)
+                __emit_unique(out, k, a[i + __builtin_ctz(mask)]);
+
+            _Int amax = a[i + 3], bmax = b[j + 3];
+            i += (amax <= bmax) ? 4 : 0;
+            j += (bmax <= amax) ? 4 : 0;
+        }
+        while (i < na && j < nb) {
+            if (a[i] < b[j])
+                ++i;
+            else if (b[j] < a[i])
+                ++j;
+            else
+                __emit_unique(out, k, a[i++]);
+        }
+        return k;
+    }
+#endif
+#endif
+
+    // SIMD kernel: contiguous 32-bit integers in ascending order
+    template<class _RanIt1, class _RanIt2, class _OutIt, class _Comp>
+    struct __use_simd_intersect 
+    {
+        typedef typename std::iterator_traits<_RanIt1>::value_type value_type;
+        static constexpr bool value = 
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__SSE2__)
+            std::is_integral<value_type>::value && sizeof(value_type) == 4 &&
+            std::is_same<value_type, typename std::iterator_traits<_RanIt2>::value_type>::value &&
+            std::is_same<value_type, typename std::iterator_traits<_OutIt>::value_type>::value &&
+            utility::__is_contiguous_iterator<_RanIt1>::value &&
+            utility::__is_contiguous_iterator<_RanIt2>::value &&
+            utility::__is_contiguous_iterator<_OutIt>::value &&
+            utility::__is_natural_order<_Comp, value_type>::value;
+#else
+            false;
+#endif
+    };
+
+    template<class _RanIt1, class _RanIt2, class _OutIt, class _Comp>
+    inline _OutIt __intersect_similar(_RanIt1 first1, _RanIt1 last1, 
+                                      _RanIt2 first2, _RanIt2 last2, 
+                                      _OutIt out, _Comp comp, std::false_type)
+    {
+        return __intersect_merge(first1, last1, first2, last2, out, comp);
+    }
+
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__SSE2__)
+    template<class _RanIt1, class _RanIt2, class _OutIt, class _Comp>
+    inline _OutIt __intersect_similar(_RanIt1 first1, _RanIt1 last1, 
+                                      _RanIt2 first2, _RanIt2 last2, 
+                                      _OutIt out, _Comp, std::true_type)
+    {
+        if (first1 == last1 || first2 == last2)
+            return out;
+        return out + __intersect_simd(&*first1, last1 - first1, &*first2, last2 - first2, &*out);
+    }
+#endif
+
+    // intersect shorter list [first1, last1) with [first2, last2):
+    // gallop through the longer one when lengths differ a lot, 
+    // merge side by side (vectorized if possible) otherwise
+    template<class _RanIt1, class _RanIt2, class _OutIt, class _Comp>
+    inline _OutIt __intersect_pair(_RanIt1 first1, _RanIt1 last1, 
+                                   _RanIt2 first2, _RanIt2 last2, 
+                                   _OutIt out, _Comp comp)
+    {
+        size_t n1 = last1 - first1;
+        size_t n2 = last2 - first2;
+        if (n1 * _KWAY_GALLOP_RATIO < n2)
+            return __intersect_gallop(first1, last1, first2, last2, out, comp);
+
+        typedef std::integral_constant<bool, 
+            __use_simd_intersect<_RanIt1, _RanIt2, _OutIt, _Comp>::value> use_simd;
+        return __intersect_similar(first1, last1, first2, last2, out, comp, use_simd());
+    }
+}
+
 
+// intersection of random access ranges, "small vs small" strategy:
+// ranges are intersected in order of length, starting from
+// the two shortest, so the running result only shrinks
 template<class _Container, class _OutIt, class _Comp>
-_OutIt kway_intersect(const std::vector< _Container >& inputs, _OutIt out, _Comp comp)
+_OutIt __kway_intersect_svs(const std::vector< _Container >& inputs, _OutIt out, _Comp comp)
+{
+    typedef typename utility::container_traits<_Container>::const_iterator iterator;
+    typedef typename std::iterator_traits<iterator>::value_type value_type;
+    typedef std::pair<iterator, iterator> range;
+
+    std::vector<range> ranges;
+    ranges.reserve(inputs.size());
+    for (auto it = inputs.begin(); it != inputs.end(); ++it) {
+        auto first = utility::begin(*it);
+        auto last  = utility::end(*it);
+        if (first != last) // escape empty ranges
+            ranges.emplace_back(first, last);
+    }
+    if (ranges.size() < 2)
+        return out;
+
+    std::sort(ranges.begin(), ranges.end(), [](const range& x, const range& y) {
+        return (x.second - x.first) < (y.second - y.first);
+    });
+
+    std::vector<value_type> result(ranges[0].second - ranges[0].first);
+    auto last = detail::__intersect_pair(ranges[0].first, ranges[0].second,
+                                         ranges[1].first, ranges[1].second,
+                                         result.begin(), comp);
+    for (size_t i = 2; i < ranges.size() && last != result.begin(); i++) {
+        last = detail::__intersect_pair(result.begin(), last,
+                                        ranges[i].first, ranges[i].second,
+                                        result.begin(), comp);
+    }
+
+    // write unique elements
+    for (auto it = result.begin(); it != last; ++it) {
+        if (it == result.begin() || comp(*(it - 1), *it)) {
+            *out = *it; ++out;
+        }
+    }
+    return out;
+}
+
+
+// k-way intersect of sequential ranges
+
+template<class _Container, class _OutIt, class _Comp>
+_OutIt __kway_intersect(const std::vector< _Container >& inputs, _OutIt out, _Comp comp, std::forward_iterator_tag)
 {
     using namespace utility;
 
@@ -325,6 +553,24 @@ _OutIt kway_intersect(const std::vector< _Container >& inputs, _OutIt out, _Comp
     return out;
 }
 
+// k-way intersect of random access ranges - gallop/merge pairwise from the shortest one
+
+template<class _Container, class _OutIt, class _Comp>
+inline _OutIt __kway_intersect(const std::vector< _Container >& inputs, _OutIt out, _Comp comp, std::random_access_iterator_tag)
+{
+    return __kway_intersect_svs(inputs, out, comp);
+}
+
+
+// k-way intersect
+
+template<class _Container, class _OutIt, class _Comp>
+_OutIt kway_intersect(const std::vector< _Container >& inputs, _OutIt out, _Comp comp)
+{
+    typedef typename utility::container_traits<_Container>::const_iterator iterator;
+    return __kway_intersect(inputs, out, comp, typename std::iterator_traits<iterator>::iterator_category());
+}
+
 template<class _Container, class _OutIt>
 _OutIt kway_intersect(const std::vector< _Container >& inputs, _OutIt out) {
     return kway_intersect(inputs, out, std::less<>{});
@@ -32,11 +32,9 @@
 
 #include <vector>
 #include <iterator>
-#include <queue>
-
-#ifdef _HAVE_BOOST_LIBS
-#include <boost/heap/pairing_heap.hpp>
-#endif
+#include <memory>
+#include <functional>
+#include <type_traits>
 
 #include "../../platform/common.h"
 
@@ -44,149 +42,220 @@
 
 _STDX_BEGIN
 
-#ifdef _HAVE_BOOST_LIBS
-template<class _Container, class _OutIt, class _Comp>
-_OutIt __kway_merge_large(const std::vector< _Container >& inputs, _OutIt out, _Comp)
+/*!
+ * \brief kway_merger tournament (loser) tree over sorted sources
+ *
+ * Leaves of the tree are sources (cursors, see utility::range_cursor),
+ * every internal node keeps the loser of the match played in its
+ * subtree and the overall winner is kept aside. Emitting an element
+ * replays only the path from the winner's leaf to the root, that is
+ * ceil(log2(k)) comparisons per element regardless of k.
+ *
+ * Exhausted sources lose every match, so no sentinel value is needed.
+ * Like heap based merge, order of equal elements from different
+ * sources is unspecified.
+ */
+template<
+    class _Cursor,
+    class _Comp = std::less<>
+>
+class kway_merger
 {
-    using namespace utility;
-
-    typedef typename container_traits<_Container>::const_iterator iterator;
-
-    typedef entry<iterator, _Comp> entry_t;
-
-    // create min/max heap
-    boost::heap::pairing_heap< entry_t > queue;
+public:
+    typedef _Cursor cursor_type;
+    typedef decltype(std::declval<const _Cursor&>().front()) reference;
+    typedef typename std::decay<reference>::type value_type;
+    typedef size_t size_type;
+
+    explicit kway_merger(std::vector<_Cursor> sources, const _Comp& c = _Comp()) :
+        __m_sources(std::move(sources)), __m_comp(c) 
+    {
+        __m_leaves = 1;
+        while (__m_leaves < __m_sources.size())
+            __m_leaves <<= 1;
+        if (!__by_value::value && !std::is_lvalue_reference<reference>::value)
+            __m_values.resize(__m_sources.size());
+        __m_tree.resize(__m_leaves);
+        __m_tree[0] = __build(1);
+    }
 
-    // push all first elements of each range
-    for (auto it = inputs.begin(); it != inputs.end(); ++it) {
-        auto first = utility::begin(*it);
-        auto last  = utility::end(*it);
-        if (first != last) // exclude empty ranges
-            queue.emplace(first, last);
+    // test if all sources are exhausted
+    bool empty() const { 
+        return (__m_tree[0].source == __exhausted); 
     }
 
-    // now one by one get the minimum/maximum element
-    // from min heap and replace it with next
-    // element of its array
-    while (!queue.empty())
-    {
-        entry_t e = queue.top();
-        queue.pop();
+    // smallest element of all sources
+    const value_type& top() const { 
+        return __get(__m_tree[0].key); 
+    }
 
-        *out = *e;
-        ++out; ++e;
+    // index of source holding top()
+    size_type source() const { 
+        return __m_tree[0].source; 
+    }
 
-        if (e) {
-            queue.push(e);
+    // remove top() and replay matches on its path
+    void pop() {
+        size_type src = __m_tree[0].source;
+        __m_sources[src].pop();
+        node w = __fetch(src);
+        size_type i = (__m_leaves + src) >> 1;
+        if (w.source != __exhausted) {
+            // w stays valid on the way up: only stored loser may be exhausted
+            for (; i > 0; i >>= 1) {
+                // outcome is data dependent, select instead of branching
+                node t = __m_tree[i];
+                bool lost = (t.source != __exhausted) && __m_comp(__get(t.key), __get(w.key));
+                __m_tree[i] = lost ? w : t;
+                w = lost ? t : w;
+            }
         }
+        else {
+            for (; i > 0; i >>= 1) {
+                if (__beats(__m_tree[i], w))
+                    std::swap(__m_tree[i], w);
+            }
+        }
+        __m_tree[0] = w;
     }
-    return out;
-}
-#endif
 
+    // emit up to n elements into out
+    template<class _OutIt>
+    _OutIt read(_OutIt out, size_type n) {
+        for (; n > 0 && !empty(); --n, ++out) {
+            *out = top();
+            pop();
+        }
+        return out;
+    }
 
+    // emit all remaining elements into out
+    template<class _OutIt>
+    _OutIt read(_OutIt out) {
+        for (; !empty(); ++out) {
+            *out = top();
+            pop();
+        }
+        return out;
+    }
 
-template<class _Container, class _OutIt, class _Comp>
-_OutIt __kway_merge_small(const std::vector< _Container >& inputs, _OutIt out, _Comp c)
-{
-    using namespace utility;
+    const std::vector<_Cursor>& sources() const {
+        return __m_sources;
+    }
 
-    typedef typename container_traits<_Container>::const_iterator iterator;
+private:
+    // small trivially copyable keys are copied into the tree,
+    // so replaying a path does not chase pointers into sources
+    typedef std::integral_constant<bool, 
+        std::is_trivially_copyable<value_type>::value && 
+        std::is_default_constructible<value_type>::value &&
+        sizeof(value_type) <= 2 * sizeof(void*)> __by_value;
 
-    typedef entry<iterator, _Comp> entry_t;
+    typedef typename std::conditional<__by_value::value, 
+        value_type, const value_type*>::type key_type;
 
+    static constexpr size_type __exhausted = static_cast<size_type>(-1);
 
-    switch(inputs.size()) {
-    case 0:
-        return out;
-    case 1:
-        return copy(utility::begin(*inputs.begin()), utility::end(*inputs.begin()), out);
-    case 2:
-        return std::merge(utility::begin(*inputs.begin()), utility::end(*inputs.begin()),
-                          utility::begin(*(inputs.begin() + 1)), utility::end(*(inputs.begin() + 1)),
-                          out, c);
+    // match participant: current element of source,
+    // exhausted source loses every match
+    struct node
+    {
+        key_type  key;
+        size_type source;
+    };
+
+    static inline const value_type& __get(const value_type& key) { return key; }
+    static inline const value_type& __get(const value_type* key) { return *key; }
+
+    node __fetch(size_type i) {
+        node n;
+        if (i >= __m_sources.size() || __m_sources[i].empty()) {
+            n.key = key_type();
+            n.source = __exhausted;
+        }
+        else {
+            n.key = __key(__m_sources[i].front(), i, __by_value(), std::is_lvalue_reference<reference>());
+            n.source = i;
+        }
+        return n;
     }
 
-    // create min/max heap
-   std::vector<entry_t> queue;
-   queue.reserve(inputs.size());
+    template<class _Lvalue>
+    static value_type __key(const value_type& v, size_type, std::true_type, _Lvalue) {
+        return v;
+    }
 
-    // push all first elements of each range
-    for (auto it = inputs.begin(); it != inputs.end(); ++it) {
-        auto first = utility::begin(*it);
-        auto last  = utility::end(*it);
-        if (first != last) // exclude empty ranges
-            queue.emplace_back(first, last);
+    static const value_type* __key(const value_type& v, size_type, std::false_type, std::true_type) {
+        return std::addressof(v);
     }
-    utility::__small_sort(queue.begin(), queue.end());
 
-    // now one by one get the minimum/maximum element
-    // from min heap and replace it with next
-    // element of its array
-    while (!queue.empty())
-    {
-        entry_t e = queue.back();
-        queue.pop_back();
+    // cursor returns by value: keep copy of current element aside
+    const value_type* __key(value_type v, size_type i, std::false_type, std::false_type) {
+        __m_values[i] = std::move(v);
+        return std::addressof(__m_values[i]);
+    }
 
-        *out = *e;
-        ++out; ++e;
+    // test if a wins over b
+    inline bool __beats(const node& a, const node& b) const {
+        if (a.source == __exhausted)
+            return false;
+        if (b.source == __exhausted)
+            return true;
+        return __m_comp(__get(a.key), __get(b.key));
+    }
 
-        if (e) {
-            queue.push_back(e);
+    // play initial tournament in subtree of i, return winner
+    node __build(size_type i) {
+        if (i >= __m_leaves)
+            return __fetch(i - __m_leaves);
+        node l = __build(2 * i);
+        node r = __build(2 * i + 1);
+        if (__beats(l, r)) {
+            __m_tree[i] = r;
+            return l;
         }
-        utility::__small_sort(queue.begin(), queue.end());
+        __m_tree[i] = l;
+        return r;
     }
-    return out;
-}
 
+private:
+    std::vector<_Cursor> __m_sources;
+    std::vector<value_type> __m_values; // current elements of by-value cursors
+    std::vector<node> __m_tree;         // [0] - winner, [1, leaves) - losers
+    size_type __m_leaves;
+    _Comp __m_comp;
+};
+
+template<class _Cursor, class _Comp>
+constexpr typename kway_merger<_Cursor, _Comp>::size_type kway_merger<_Cursor, _Comp>::__exhausted;
 
 
-// k-way merge
+// k-way merge of sorted ranges (containers or iterator pairs)
 
 template<class _Container, class _OutIt, class _Comp>
 _OutIt kway_merge(const std::vector< _Container >& inputs, _OutIt out, _Comp c)
 {
-    using namespace utility;
+    typedef typename utility::container_traits<_Container>::const_iterator iterator;
+    typedef utility::range_cursor<iterator> cursor;
 
-    typedef typename container_traits<_Container>::const_iterator iterator;
-
-    typedef entry<iterator, _Comp> entry_t;
-
-    if (inputs.size() < 10) {
-        return __kway_merge_small(inputs, out, c);
-    }
-#if _HAVE_BOOST_LIBS
-    if (inputs.size() > 1000) {
-        return __kway_merge_large(inputs, out, c);
-    }
-#endif
-    // create min/max heap
-    std::priority_queue< entry_t, std::vector<entry_t> > queue;
-
-    // push all first elements of each range
-    for (auto it = inputs.begin(); it != inputs.end(); ++it) {
-        auto first = utility::begin(*it);
-        auto last  = utility::end(*it);
-        if (first != last) // exclude empty ranges
-            queue.emplace(first, last);
+    switch(inputs.size()) {
+    case 0:
+        return out;
+    case 1:
+        return std::copy(utility::begin(inputs[0]), utility::end(inputs[0]), out);
+    case 2:
+        return std::merge(utility::begin(inputs[0]), utility::end(inputs[0]),
+                          utility::begin(inputs[1]), utility::end(inputs[1]),
+                          out, c);
     }
 
-    // now one by one get the minimum/maximum element
-    // from min heap and replace it with next
-    // element of its array
-    while (!queue.empty())
-    {
-        entry_t e = queue.top();
-        queue.pop();
-
-        *out = *e;
-        ++out; ++e;
+    std::vector<cursor> sources;
+    sources.reserve(inputs.size());
+    for (auto it = inputs.begin(); it != inputs.end(); ++it)
+        sources.emplace_back(utility::begin(*it), utility::end(*it));
 
-        if (e) {
-            queue.push(e);
-        }
-    }
-    return out;
+    kway_merger<cursor, _Comp> merger(std::move(sources), c);
+    return merger.read(out);
 }
 
 
@@ -196,4 +265,3 @@ _OutIt kway_merge(const std::vector< _Container >& inputs, _OutIt out) {
 }
 
 _STDX_END
-
@@ -31,7 +31,11 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <utility>
+#include <iterator>
+#include <type_traits>
+#include <vector>
 
 #include "../../platform/common.h"
 #include "../../functional/symmetric_operation.hpp"
@@ -70,6 +74,32 @@ namespace utility
     };
 
 
+    // cursor over range [first, last) of input iterators
+    //
+    // cursor is a minimal sequential source used by k-way merge:
+    //   bool empty() const - test if source is exhausted
+    //   front()            - current element (valid until pop())
+    //   void pop()         - advance to next element
+    // any source (e.g. file reader) providing these members can be merged
+    template<class _InIt>
+    struct range_cursor
+    {
+        typedef typename std::iterator_traits<_InIt>::value_type value_type;
+        typedef typename std::iterator_traits<_InIt>::reference reference;
+
+        range_cursor(_InIt first, _InIt last) :
+            __m_first(first), __m_last(last) {}
+
+        bool empty() const { return (__m_first == __m_last); }
+        reference front() const { return (*__m_first); }
+        void pop() { ++__m_first; }
+
+    private:
+        _InIt __m_first;
+        _InIt __m_last;
+    };
+
+
     // sort
 
     // stable, 2-3 compares, 0-2 swaps
@@ -202,6 +232,19 @@ namespace utility
         __small_sort(first, last, std::less<>{});
     }
 
+    // iterator over contiguous storage (pointer or std::vector iterator)
+    template<class _It>
+    struct __is_contiguous_iterator : std::integral_constant<bool,
+        std::is_pointer<_It>::value ||
+        std::is_same<_It, typename std::vector<typename std::iterator_traits<_It>::value_type>::iterator>::value ||
+        std::is_same<_It, typename std::vector<typename std::iterator_traits<_It>::value_type>::const_iterator>::value> {};
+
+    // comparator is operator< of values
+    template<class _Comp, class _Tp>
+    struct __is_natural_order : std::integral_constant<bool,
+        std::is_same<_Comp, std::less<>>::value || 
+        std::is_same<_Comp, std::less<_Tp>>::value> {};
+
 }
 
 template<
@@ -31,18 +31,351 @@
 #pragma once
 #include <sstream>
 #include <string>
+#include <experimental/string_view>
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <type_traits>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
 #include <tuple>
 
 #include "../../platform/common.h"
+#include "../../platform/bits.h"
+#include "tokenizer.hpp"
 
 _STDX_BEGIN
 
 namespace detail
 {
+    // Fast path: contiguous char input, no streams, no allocations
+
+    /*
+     * Single character delimiter.
+     * split_into() and split_copy() wrap a plain character passed
+     * instead of a predicate, so it can be scanned with SIMD.
+     */
+    template<class _Elem>
+    struct __char_delimiter
+    {
+        _Elem ch;
+        inline bool operator()(_Elem c) const { return (c == ch); }
+    };
+
+    template<class _Elem, class _Pred>
+    struct __delimiter_traits
+    {
+        typedef _Pred type;
+        static inline const _Pred& make(const _Pred& pred) { return pred; }
+    };
+
+    template<class _Elem>
+    struct __delimiter_traits<_Elem, _Elem>
+    {
+        typedef __char_delimiter<_Elem> type;
+        static inline type make(_Elem c) { return type{ c }; }
+    };
+
+    template<class _Elem, class _Pred>
+    inline const _Elem* __find_delimiter(const _Elem* first, const _Elem* last, const _Pred& pred) {
+        return std::find_if(first, last, pred);
+    }
+
+    inline const char* __find_delimiter(const char* first, const char* last, const __char_delimiter<char>& delim)
+    {
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+        const __m256i pattern = _mm256_set1_epi8(delim.ch);
+        for (; last - first >= 32; first += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern)));
+            if (mask != 0)
+                return (first + __builtin_ctz(mask));
+        }
+#endif
+        if (first == last)
+            return last;
+        const void* pos = std::memchr(first, delim.ch, static_cast<size_t>(last - first));
+        return (pos != nullptr ? static_cast<const char*>(pos) : last);
+    }
+
+    inline const char* __find_delimiter(const char* first, const char* last, const delimiter_set& delims) {
+        return delims.find(first, last);
+    }
+
+    inline bool __is_space(char c) {
+        return (c == ' ' || static_cast<unsigned>(c - '\t') <= static_cast<unsigned>('\r' - '\t'));
+    }
+
+    // skip leading whitespace of field, as operator>> does
+    inline const char* __skip_space(const char* first, const char* last) {
+        while (first != last && __is_space(*first))
+            ++first;
+        return first;
+    }
+
+    /*
+     * Parse an integer field: optional sign followed by decimal digits.
+     * As with operator>>, leading whitespace is skipped and parsing
+     * stops at the first non-digit character.
+     * Out of range values are clamped and reported as failure.
+     */
+    template<class _Tp>
+    bool __parse_integer(const char* first, const char* last, _Tp& val)
+    {
+        typedef typename std::make_unsigned<_Tp>::type _Uty;
+
+        first = __skip_space(first, last);
+        bool negative = false;
+        if (first != last && (*first == '-' || *first == '+')) {
+            negative = (*first == '-');
+            ++first;
+        }
+        if (first == last || static_cast<unsigned>(*first - '0') > 9 || (negative && !std::is_signed<_Tp>::value)) {
+            val = _Tp();
+            return false;
+        }
+
+        const _Uty limit = static_cast<_Uty>(std::numeric_limits<_Tp>::max()) + static_cast<_Uty>(negative);
+        _Uty acc = 0;
+        for (; first != last; ++first)
+        {
+            unsigned digit = static_cast<unsigned>(*first - '0');
+            if (digit > 9)
+                break;
+            if (acc > (limit - digit) / 10) {
+                val = negative ? std::numeric_limits<_Tp>::min() : std::numeric_limits<_Tp>::max();
+                return false;
+            }
+            acc = acc * 10 + digit;
+        }
+        val = negative ? static_cast<_Tp>(0 - acc) : static_cast<_Tp>(acc);
+        return true;
+    }
+
+    template<class _Tp>
+    struct __float_traits;
+
+    template<>
+    struct __float_traits<float>
+    {
+        static constexpr uint64_t max_exact_mantissa = (1ULL << 24);
+        static constexpr int max_exact_exponent = 10;
+        static inline float parse(const char* s, char** end) { return std::strtof(s, end); }
+    };
+
+    template<>
+    struct __float_traits<double>
+    {
+        static constexpr uint64_t max_exact_mantissa = (1ULL << 53);
+        static constexpr int max_exact_exponent = 22;
+        static inline double parse(const char* s, char** end) { return std::strtod(s, end); }
+    };
+
+    template<>
+    struct __float_traits<long double>
+    {
+        // always delegate to strtold
+        static constexpr uint64_t max_exact_mantissa = 0;
+        static constexpr int max_exact_exponent = -1;
+        static inline long double parse(const char* s, char** end) { return std::strtold(s, end); }
+    };
+
+    // strto* on a null-terminated copy of [first, last)
+    template<class _Tp>
+    bool __parse_float_slow(const char* first, const char* last, _Tp& val)
+    {
+        char buf[64];
+        std::string heap;
+        size_t n = static_cast<size_t>(last - first);
+        const char* s = buf;
+        if (n < sizeof(buf)) {
+            std::memcpy(buf, first, n);
+            buf[n] = '\0';
+        } else {
+            heap.assign(first, last);
+            s = heap.c_str();
+        }
+
+        char* end = nullptr;
+        val = __float_traits<_Tp>::parse(s, &end);
+        if (end == s) {
+            val = _Tp();
+            return false;
+        }
+        return true;
+    }
+
+    /*
+     * Parse a floating point field.
+     * Decimal numbers whose mantissa and power of ten are both exactly
+     * representable are converted with a single multiplication or
+     * division (which is correctly rounded); everything else, including
+     * inf/nan and hexadecimal notation, is delegated to strto*.
+     */
+    template<class _Tp>
+    bool __parse_float(const char* first, const char* last, _Tp& val)
+    {
+        static const _Tp powers_of_10[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        typedef __float_traits<_Tp> traits;
+
+        first = __skip_space(first, last);
+        const char* it = first;
+        bool negative = false;
+        if (it != last && (*it == '-' || *it == '+')) {
+            negative = (*it == '-');
+            ++it;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        for (; it != last && static_cast<unsigned>(*it - '0') <= 9; ++it, ++digits)
+            mantissa = mantissa * 10 + static_cast<unsigned>(*it - '0');
+
+        if (it != last && *it == '.') {
+            for (++it; it != last && static_cast<unsigned>(*it - '0') <= 9; ++it, ++digits, --exponent)
+                mantissa = mantissa * 10 + static_cast<unsigned>(*it - '0');
+        }
+
+        if (digits == 0 || digits > 19)
+            return __parse_float_slow(first, last, val);
+
+        if (it != last && (*it == 'e' || *it == 'E'))
+        {
+            const char* exp_first = ++it;
+            bool exp_negative = false;
+            if (it != last && (*it == '-' || *it == '+')) {
+                exp_negative = (*it == '-');
+                ++it;
+            }
+            int exp_value = 0;
+            for (; it != last && static_cast<unsigned>(*it - '0') <= 9 && exp_value < 10000; ++it)
+                exp_value = exp_value * 10 + (*it - '0');
+            if (it == exp_first || static_cast<unsigned>(*(it - 1) - '0') > 9)
+                return __parse_float_slow(first, last, val);
+            exponent += exp_negative ? -exp_value : exp_value;
+        }
+
+        if (it != last && (*it == 'x' || *it == 'X'))
+            return __parse_float_slow(first, last, val); // hexadecimal notation
+
+        if (mantissa > traits::max_exact_mantissa || exponent > traits::max_exact_exponent || -exponent > traits::max_exact_exponent)
+            return __parse_float_slow(first, last, val);
+
+        _Tp result = static_cast<_Tp>(mantissa);
+        result = (exponent < 0) ? result / powers_of_10[-exponent] : result * powers_of_10[exponent];
+        val = negative ? -result : result;
+        return true;
+    }
+
+    template<class _Tp>
+    struct __is_char_field :
+            std::integral_constant<bool,
+                std::is_same<_Tp, char>::value ||
+                std::is_same<_Tp, signed char>::value ||
+                std::is_same<_Tp, unsigned char>::value>
+    {};
+
+    template<class _Tp>
+    inline typename std::enable_if<__is_char_field<_Tp>::value, bool>::type
+    __parse_field(const char* first, const char* last, _Tp& val)
+    {
+        first = __skip_space(first, last);
+        if (first == last)
+            return false;
+        val = static_cast<_Tp>(*first);
+        return true;
+    }
+
+    template<class _Tp>
+    inline typename std::enable_if<std::is_integral<_Tp>::value && !__is_char_field<_Tp>::value, bool>::type
+    __parse_field(const char* first, const char* last, _Tp& val) {
+        return __parse_integer(first, last, val);
+    }
+
+    template<class _Tp>
+    inline typename std::enable_if<std::is_floating_point<_Tp>::value, bool>::type
+    __parse_field(const char* first, const char* last, _Tp& val) {
+        return __parse_float(first, last, val);
+    }
+
+    template<class _Traits>
+    inline bool __parse_field(const char* first, const char* last, std::experimental::basic_string_view<char, _Traits>& val) {
+        val = std::experimental::basic_string_view<char, _Traits>(first, static_cast<size_t>(last - first));
+        return true;
+    }
+
+    // same as operator>>: the first whitespace delimited word of the field
+    template<class _Traits, class _Alloc>
+    inline bool __parse_field(const char* first, const char* last, std::basic_string<char, _Traits, _Alloc>& val)
+    {
+        first = __skip_space(first, last);
+        const char* it = first;
+        while (it != last && !__is_space(*it))
+            ++it;
+        val.assign(first, it); // reuses existing capacity
+        return (first != it);
+    }
+
+    /*
+     * Field types handled by __parse_field.
+     * bool and wide characters keep going through operator>>.
+     */
+    template<class _Tp>
+    struct __is_fast_field :
+            std::integral_constant<bool,
+                (std::is_integral<_Tp>::value && !std::is_same<_Tp, bool>::value &&
+                    (sizeof(_Tp) > 1 || __is_char_field<_Tp>::value)) ||
+                std::is_floating_point<_Tp>::value>
+    {};
+
+    template<class _Traits>
+    struct __is_fast_field< std::experimental::basic_string_view<char, _Traits> > :
+            std::true_type
+    {};
+
+    template<class _Traits, class _Alloc>
+    struct __is_fast_field< std::basic_string<char, _Traits, _Alloc> > :
+            std::true_type
+    {};
+
+    template<class... _Args>
+    struct __all_fast_fields;
+
+    template<>
+    struct __all_fast_fields<> :
+            std::true_type
+    {};
+
+    template<class _Arg, class... _Args>
+    struct __all_fast_fields<_Arg, _Args...> :
+            std::integral_constant<bool,
+                __is_fast_field<typename std::remove_reference<_Arg>::type>::value &&
+                __all_fast_fields<_Args...>::value>
+    {};
+
+    template<class _SStream, class _InIt, class _Arg>
+    inline void __read_field(_SStream& stream, _InIt first, _InIt last, _Arg& val)
+    {
+        stream.str({ first, last }); // reset internal buffer
+        stream >> val; // read value
+        stream.clear(); // buffer cleaup
+    }
+
+    // fields which do not need a stream are parsed in place
+    template<class _SStream, class _Arg>
+    inline typename std::enable_if<__is_fast_field<_Arg>::value>::type
+    __read_field(_SStream&, const char* first, const char* last, _Arg& val) {
+        __parse_field(first, last, val);
+    }
+
     template<
         class _SStream,
         class _InIt,
@@ -64,7 +397,7 @@ namespace detail
             }
         }
 
-        if (first == last)
+        if (it == last)
             return last;
 
         ++it;
@@ -73,9 +406,7 @@ namespace detail
             ++it;
         }
 
-        stream.str({ first, it }); // reset internal buffer
-        stream >> val; // read value
-        stream.clear(); // buffer cleaup
+        __read_field(stream, first, it, val);
         return it;
     }
 
@@ -135,6 +466,143 @@ namespace detail
         static inline _InIt apply(_Tuple& src, _SStream& stream, _InIt first, _InIt last, _Pred pred) { }
     };
 
+
+    /*
+     * Same semantics as __split_element: skip leading delimiters,
+     * read next token into val (which is left untouched if there
+     * are no more tokens) and return the end of the token.
+     */
+    template<class _Pred, class _Arg>
+    inline const char* __split_field(const char* first, const char* last, const _Pred& pred, _Arg& val)
+    {
+        while (first != last && pred(*first))
+            ++first;
+        if (first == last)
+            return last;
+
+        const char* it = __find_delimiter(first + 1, last, pred);
+        __parse_field(first, it, val);
+        return it;
+    }
+
+    template<size_t _Idx, size_t _Size>
+    struct __tuple_split_fields
+    {
+        template<class _Tuple, class _Pred>
+        static inline const char* apply(_Tuple& src, const char* first, const char* last, const _Pred& pred) {
+            first = __split_field(first, last, pred, std::get<_Idx>(src));
+            return __tuple_split_fields<_Idx + 1, _Size>::apply(src, first, last, pred);
+        }
+    };
+
+    template<size_t _Size>
+    struct __tuple_split_fields<_Size, _Size>
+    {
+        template<class _Tuple, class _Pred>
+        static inline const char* apply(_Tuple&, const char* first, const char*, const _Pred&) {
+            return first;
+        }
+    };
+
+    template<class _Elem, class _Traits, class _Pred, class... _Args>
+    inline void __split_into(const _Elem* first, const _Elem* last, const _Pred& pred, std::tuple<_Args...>& args, std::true_type /*fast*/) {
+        __tuple_split_fields<0, sizeof...(_Args)>::apply(args, first, last, pred);
+    }
+
+    template<class _Elem, class _Traits, class _Pred, class... _Args>
+    inline void __split_into(const _Elem* first, const _Elem* last, const _Pred& pred, std::tuple<_Args...>& args, std::false_type /*fast*/)
+    {
+        typedef std::basic_istringstream<_Elem, _Traits> stream_type;
+        typedef tuple_split<0, int(sizeof...(_Args)) - 1> visitor;
+
+        stream_type stream;
+        visitor::apply(args, stream, first, last, pred);
+    }
+
+    template<class _Elem, class _Traits, class _Pred, class... _Args>
+    inline void __split_into(const _Elem* first, const _Elem* last, const _Pred& pred, std::tuple<_Args...>& args)
+    {
+        typedef __delimiter_traits<_Elem, _Pred> delimiter;
+        typedef std::integral_constant<bool,
+            std::is_same<_Elem, char>::value && __all_fast_fields<_Args...>::value> is_fast;
+
+        __split_into<_Elem, _Traits>(first, last, delimiter::make(pred), args, is_fast());
+    }
+
+    /*
+     * Token produced by split_copy() on contiguous character input.
+     * Converts to both basic_string and basic_string_view, so
+     * output sequences of views are filled without allocations.
+     */
+    template<class _Elem, class _Traits>
+    struct __split_token
+    {
+        const _Elem* first;
+        const _Elem* last;
+
+        template<class _Alloc>
+        inline operator std::basic_string<_Elem, _Traits, _Alloc>() const {
+            return std::basic_string<_Elem, _Traits, _Alloc>(first, last);
+        }
+
+        inline operator std::experimental::basic_string_view<_Elem, _Traits>() const {
+            return std::experimental::basic_string_view<_Elem, _Traits>(first, static_cast<size_t>(last - first));
+        }
+    };
+
+    template<class _Elem, class _Traits, class _OutIt, class _Pred>
+    _OutIt __split_copy(const _Elem* first, const _Elem* last, _OutIt out, const _Pred& pred)
+    {
+        for (;;)
+        {
+            while (first != last && pred(*first))
+                ++first;
+            if (first == last)
+                break;
+
+            const _Elem* it = __find_delimiter(first + 1, last, pred);
+            *out = __split_token<_Elem, _Traits>{ first, it }; ++out;
+
+            first = it;
+        }
+        return out;
+    }
+
+    // output iterator accepts __split_token, i.e. holds strings or string views
+    template<class _OutIt, class _Token, class = void>
+    struct __accepts_token :
+            std::false_type
+    {};
+
+    template<class _OutIt, class _Token>
+    struct __accepts_token<_OutIt, _Token, decltype((void)(*std::declval<_OutIt&>() = std::declval<const _Token&>()))> :
+            std::true_type
+    {};
+
+    template<class _Elem, class _Traits, class _OutIt, class _Pred>
+    inline _OutIt __split_copy(const _Elem* first, const _Elem* last, _OutIt out, const _Pred& pred, std::true_type /*token*/) {
+        return __split_copy<_Elem, _Traits>(first, last, out, pred);
+    }
+
+    // other outputs are assigned { first, last } pair of iterators
+    template<class _Elem, class _Traits, class _OutIt, class _Pred>
+    _OutIt __split_copy(const _Elem* first, const _Elem* last, _OutIt out, const _Pred& pred, std::false_type /*token*/)
+    {
+        for (;;)
+        {
+            while (first != last && pred(*first))
+                ++first;
+            if (first == last)
+                break;
+
+            const _Elem* it = __find_delimiter(first + 1, last, pred);
+            *out = { first, it }; ++out;
+
+            first = it;
+        }
+        return out;
+    }
+
 } // end namespace detail
 
 /*!
@@ -158,8 +626,10 @@ void split(_InIt first, _InIt last, _Pred pred, _Fx action)
 
         _InIt it = std::find_if(std::next(first), last, pred);
         action(first, it); // apply action to sub range
+        if (it == last)
+            break;
 
-        first =  std::next(it);
+        first = std::next(it);
     }
 }
 
@@ -183,8 +653,10 @@ _OutIt split_copy(_InIt first, _InIt last, _OutIt out, _Pred pred)
 
         _InIt it = std::find_if(std::next(first), last, pred);
         *out = { first, it }; ++out; // assign a sub range to output iterator
+        if (it == last)
+            break;
 
-        first =  std::next(it);
+        first = std::next(it);
     }
 
     return out;
@@ -213,14 +685,55 @@ inline _OutIt split_copy(const _Tx (&input)[_Size], _OutIt out, _Pred pred) {
     return split_copy(std::begin(input), std::end(input), out, pred);
 }
 
+/*!
+ * \brief split_copy
+ * split string \a line using boolean predicate or
+ * delimiter character \a pred, and copy result into out
+ *
+ * Tokens are assigned to output iterator as objects convertible
+ * to both std::basic_string and std::experimental::basic_string_view,
+ * so the output sequence may hold views into \a line. Outputs of
+ * other types are assigned { first, last } pairs of iterators.
+ */
+template<typename _Elem, typename _Traits, typename _Alloc, typename _OutIt, typename _Pred>
+inline _OutIt split_copy(const std::basic_string<_Elem, _Traits, _Alloc>& line, _OutIt out, _Pred pred)
+{
+    typedef detail::__delimiter_traits<_Elem, _Pred> delimiter;
+    typedef detail::__accepts_token<_OutIt, detail::__split_token<_Elem, _Traits>> accepts_token;
+    return detail::__split_copy<_Elem, _Traits>(line.data(), line.data() + line.size(), out, delimiter::make(pred), accepts_token());
+}
+
+/*!
+ * \brief split_copy
+ * split string view \a line using boolean predicate or
+ * delimiter character \a pred, and copy result into out
+ *
+ * \see split_copy(const std::basic_string&, _OutIt, _Pred)
+ */
+template<typename _Elem, typename _Traits, typename _OutIt, typename _Pred>
+inline _OutIt split_copy(std::experimental::basic_string_view<_Elem, _Traits> line, _OutIt out, _Pred pred)
+{
+    typedef detail::__delimiter_traits<_Elem, _Pred> delimiter;
+    typedef detail::__accepts_token<_OutIt, detail::__split_token<_Elem, _Traits>> accepts_token;
+    return detail::__split_copy<_Elem, _Traits>(line.data(), line.data() + line.size(), out, delimiter::make(pred), accepts_token());
+}
+
 
 
 
 /*!
  * \brief split_into
- * split string \a line using
- * boolean predicate \a pred, and copy results into \a args tuple
+ * split string \a line using boolean predicate or
+ * delimiter character \a pred, and copy results into \a args tuple
  *
+ * When \a line is a narrow string and every field is an arithmetic
+ * type, std::string or std::experimental::string_view, fields are
+ * converted in place without streams or allocations. Results match
+ * operator>>: leading whitespace is skipped, std::string receives the
+ * first whitespace delimited word of the field, a numeric field which
+ * cannot be parsed is value-initialized, an out of range integer is
+ * clamped. std::experimental::string_view receives the whole field.
+ * Other field types are read with operator>>.
  */
 template<
         typename _Elem,
@@ -231,13 +744,7 @@ template<
         >
 inline void split_into(const std::basic_string<_Elem, _Traits, _Alloc>& line, _Pred pred, std::tuple<_Args...>& args)
 {
-    using namespace std;
-    typedef basic_istringstream<_Elem, _Traits, _Alloc> stream_type;
-    typedef tuple<_Args...> tuple_type;
-    typedef detail::tuple_split<0, int(tuple_size<tuple_type>::value) - 1> visitor;
-
-    stream_type stream;
-    visitor::apply(args, stream, begin(line), end(line), pred);
+    detail::__split_into<_Elem, _Traits>(line.data(), line.data() + line.size(), pred, args);
 }
 
 
@@ -256,13 +763,9 @@ template<
         >
 inline void split_into(const _Elem (&line)[_Size], _Pred pred, std::tuple<_Args...>& args)
 {
-    using namespace std;
-    typedef basic_istringstream< _Elem, char_traits<_Elem> > stream_type;
-    typedef tuple< _Args... > tuple_type;
-    typedef detail::tuple_split<0, int(tuple_size<tuple_type>::value) - 1> visitor;
-
-    stream_type stream;
-    visitor::apply(args, stream, begin(line), end(line), pred);
+    const _Elem* last = line + _Size;
+    if (_Size > 0 && line[_Size - 1] == _Elem()) --last; // skip terminating null
+    detail::__split_into<_Elem, std::char_traits<_Elem>>(line, last, pred, args);
 }
 
 
@@ -0,0 +1,457 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <experimental/string_view>
+
+#include "../../platform/common.h"
+#include "../../platform/bits.h"
+
+_STDX_BEGIN
+
+namespace detail
+{
+    // bit i of result is the parity of bits [0, i] of x
+    inline uint64_t __prefix_xor(uint64_t x)
+    {
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__PCLMUL__)
+        __m128i all_ones = _mm_set1_epi8('\xFF');
+        __m128i result = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<int64_t>(x)), all_ones, 0);
+        return static_cast<uint64_t>(_mm_cvtsi128_si64(result));
+#else
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+#endif
+    }
+
+    // bitmask of bytes in 64-byte block equal to c
+    inline uint64_t __eq_mask64(const char* block, char c)
+    {
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+        const __m256i pattern = _mm256_set1_epi8(c);
+        uint64_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), pattern)));
+        uint64_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)), pattern)));
+        return lo | (hi << 32);
+#elif !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__SSE2__)
+        const __m128i pattern = _mm_set1_epi8(c);
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern)))) << i;
+        }
+        return mask;
+#else
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; ++i)
+            mask |= static_cast<uint64_t>(block[i] == c) << i;
+        return mask;
+#endif
+    }
+} // end namespace detail
+
+
+/*!
+ * \brief class delimiter_set represents a set of single byte delimiters
+ *
+ * Besides being a unary predicate, delimiter_set classifies 64-byte
+ * blocks of text at once producing a bitmask of delimiter positions
+ * (simdjson stage 1 style). Membership is looked up with two
+ * pshufb's: one indexed by the low nibble of a byte and one by its
+ * high nibble, a byte is a delimiter when their results share a bit.
+ * This is exact as long as delimiters have at most 8 distinct high
+ * nibbles, which covers any set of ASCII punctuation and whitespace;
+ * other sets are classified byte by byte.
+ */
+class delimiter_set
+{
+public:
+    typedef char value_type;
+
+    //! Construct an empty set
+    delimiter_set() {
+        __build(static_cast<const char*>(nullptr), static_cast<const char*>(nullptr));
+    }
+
+    //! Construct a set consisting of single delimiter \a c
+    delimiter_set(char c) {
+        __build(&c, &c + 1);
+    }
+
+    //! Construct a set from null-terminated string of delimiters
+    delimiter_set(const char* delims) {
+        __build(delims, delims + std::strlen(delims));
+    }
+
+    //! Construct a set from delimiters list
+    delimiter_set(std::initializer_list<char> delims) {
+        __build(delims.begin(), delims.end());
+    }
+
+    //! Construct a set from [first, last) range of delimiters
+    template<class _InIt>
+    delimiter_set(_InIt first, _InIt last) {
+        __build(first, last);
+    }
+
+    //! \return true if \a c is a delimiter
+    inline bool operator()(char c) const {
+        unsigned char uc = static_cast<unsigned char>(c);
+        return ((__m_bits[uc >> 6] >> (uc & 63)) & 1) != 0;
+    }
+
+    /*!
+     * \brief classify 64-byte block
+     * \return bitmask with bit i set if block[i] is a delimiter
+     */
+    inline uint64_t classify(const char* block) const
+    {
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && (defined(__AVX2__) || defined(__SSSE3__))
+        if (__m_nibbles)
+            return __classify_nibbles(block);
+#endif
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; ++i)
+            mask |= static_cast<uint64_t>((*this)(block[i])) << i;
+        return mask;
+    }
+
+    //! \return iterator to the first delimiter in [first, last) or last
+    const char* find(const char* first, const char* last) const
+    {
+        for (; last - first >= 64; first += 64) {
+            uint64_t mask = classify(first);
+            if (mask != 0)
+                return (first + __builtin_ctzll(mask));
+        }
+        for (; first != last && !(*this)(*first); ++first) {}
+        return first;
+    }
+
+private:
+    template<class _InIt>
+    void __build(_InIt first, _InIt last)
+    {
+        std::memset(__m_bits, 0, sizeof(__m_bits));
+        std::memset(__m_lo, 0, sizeof(__m_lo));
+        std::memset(__m_hi, 0, sizeof(__m_hi));
+        for (; first != last; ++first) {
+            unsigned char uc = static_cast<unsigned char>(*first);
+            __m_bits[uc >> 6] |= (1ULL << (uc & 63));
+        }
+
+        // assign one bit per distinct high nibble
+        int nclasses = 0;
+        for (unsigned hi = 0; hi < 16; ++hi)
+        {
+            bool used = false;
+            for (unsigned lo = 0; lo < 16; ++lo) {
+                if ((*this)(static_cast<char>(hi << 4 | lo))) {
+                    used = true;
+                    break;
+                }
+            }
+            if (!used)
+                continue;
+            if (nclasses == 8) {
+                __m_nibbles = false;
+                return;
+            }
+            uint8_t bit = static_cast<uint8_t>(1u << nclasses++);
+            __m_hi[hi] = bit;
+            for (unsigned lo = 0; lo < 16; ++lo) {
+                if ((*this)(static_cast<char>(hi << 4 | lo)))
+                    __m_lo[lo] |= bit;
+            }
+        }
+        __m_nibbles = true;
+    }
+
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+    inline uint64_t __classify_nibbles(const char* block) const
+    {
+        const __m256i lo_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__m_lo)));
+        const __m256i hi_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__m_hi)));
+        const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+        const __m256i zero = _mm256_setzero_si256();
+
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; i += 32)
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+            __m256i lo = _mm256_shuffle_epi8(lo_table, _mm256_and_si256(chunk, low_nibble));
+            __m256i hi = _mm256_shuffle_epi8(hi_table, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_nibble));
+            __m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), zero);
+            mask |= static_cast<uint64_t>(~static_cast<uint32_t>(_mm256_movemask_epi8(none))) << i;
+        }
+        return mask;
+    }
+#elif !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__SSSE3__)
+    inline uint64_t __classify_nibbles(const char* block) const
+    {
+        const __m128i lo_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(__m_lo));
+        const __m128i hi_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(__m_hi));
+        const __m128i low_nibble = _mm_set1_epi8(0x0F);
+        const __m128i zero = _mm_setzero_si128();
+
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            __m128i lo = _mm_shuffle_epi8(lo_table, _mm_and_si128(chunk, low_nibble));
+            __m128i hi = _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(chunk, 4), low_nibble));
+            __m128i none = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero);
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(~_mm_movemask_epi8(none))) << i;
+        }
+        return mask;
+    }
+#endif
+
+    uint64_t __m_bits[4];   // membership bitmap
+    uint8_t  __m_lo[16];    // low nibble -> classes
+    uint8_t  __m_hi[16];    // high nibble -> class
+    bool     __m_nibbles;   // lookup tables are exact
+};
+
+
+//! Empty tokens policy of tokenizer
+enum class empty_tokens
+{
+    skip, //!< adjacent delimiters are collapsed, as in split()
+    keep  //!< every delimiter ends a token, as in CSV
+};
+
+
+/*!
+ * \brief class tokenizer provides lazily evaluated range of tokens
+ *
+ * Text is scanned in 64-byte blocks: each block is turned into a
+ * bitmask of delimiter positions by delimiter_set::classify(), and
+ * delimiters are then visited with ctz, so no per character branch
+ * is taken. Tokens are string views into source text.
+ *
+ * When quote character is specified, delimiters between quotes are
+ * ignored. Quoted regions are tracked across blocks with prefix xor
+ * of quote positions, so doubled quotes ("") inside quoted token are
+ * handled as well. Enclosing quotes are stripped from tokens, doubled
+ * quotes are left as is.
+ *
+ * \note iterators refer to tokenizer, it must outlive them
+ */
+class tokenizer
+{
+public:
+    typedef std::experimental::string_view value_type;
+
+    class const_iterator :
+            public std::iterator<std::forward_iterator_tag, value_type, std::ptrdiff_t, const value_type*, const value_type&>
+    {
+        friend class tokenizer;
+
+    public:
+        const_iterator() :
+            __m_owner(nullptr), __m_next(nullptr), __m_block(nullptr), __m_mask(0), __m_carry(0) {
+        }
+
+        inline const value_type& operator*() const { return __m_token; }
+        inline const value_type* operator->() const { return &__m_token; }
+
+        inline const_iterator& operator++() {
+            __advance();
+            return *this;
+        }
+
+        inline const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            __advance();
+            return tmp;
+        }
+
+        inline bool operator==(const const_iterator& other) const {
+            return (__m_owner == other.__m_owner && __m_token.data() == other.__m_token.data() &&
+                    __m_token.size() == other.__m_token.size());
+        }
+
+        inline bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        explicit const_iterator(const tokenizer* owner) :
+            __m_owner(owner), __m_next(owner->__m_first), __m_block(owner->__m_first), __m_mask(0), __m_carry(0)
+        {
+            if (__m_next == owner->__m_last) {
+                __m_owner = nullptr;
+                return;
+            }
+            __load_block();
+            __advance();
+        }
+
+        // classify block starting at __m_block
+        void __load_block()
+        {
+            const char* last = __m_owner->__m_last;
+            const char* block = __m_block;
+            alignas(64) char tail[64];
+            size_t n = static_cast<size_t>(last - __m_block);
+            if (n < 64) {
+                std::memcpy(tail, __m_block, n);
+                std::memset(tail + n, 0, 64 - n);
+                block = tail;
+            }
+
+            uint64_t mask = __m_owner->__m_delims.classify(block);
+            if (__m_owner->__m_quote != '\0') {
+                uint64_t quoted = detail::__prefix_xor(detail::__eq_mask64(block, __m_owner->__m_quote)) ^ __m_carry;
+                __m_carry = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+                mask &= ~quoted;
+            }
+            if (n < 64)
+                mask &= (1ULL << n) - 1;
+            __m_mask = mask;
+        }
+
+        // position of next unquoted delimiter or end of text
+        const char* __next_delimiter()
+        {
+            const char* last = __m_owner->__m_last;
+            while (__m_mask == 0) {
+                if (last - __m_block <= 64)
+                    return last;
+                __m_block += 64;
+                __load_block();
+            }
+            const char* pos = __m_block + __builtin_ctzll(__m_mask);
+            __m_mask &= __m_mask - 1;
+            return pos;
+        }
+
+        void __advance()
+        {
+            for (;;)
+            {
+                if (__m_next == nullptr) { // past the last token
+                    __m_owner = nullptr;
+                    __m_token = value_type();
+                    return;
+                }
+
+                const char* first = __m_next;
+                const char* last = __next_delimiter();
+                __m_next = (last == __m_owner->__m_last) ? nullptr : last + 1;
+
+                if (first != last || __m_owner->__m_mode == empty_tokens::keep) {
+                    const char quote = __m_owner->__m_quote;
+                    if (quote != '\0' && last - first >= 2 && *first == quote && *(last - 1) == quote) {
+                        ++first;
+                        --last;
+                    }
+                    __m_token = value_type(first, static_cast<size_t>(last - first));
+                    return;
+                }
+            }
+        }
+
+        const tokenizer* __m_owner; // null for past-the-end iterator
+        const char* __m_next;       // start of next token, null after last one
+        const char* __m_block;      // current 64-byte block
+        uint64_t __m_mask;          // unvisited delimiters of current block
+        uint64_t __m_carry;         // all ones if block ended inside quotes
+        value_type __m_token;
+    };
+
+    typedef const_iterator iterator;
+
+    /*!
+     * \brief Construct tokenizer of [first, last) text
+     * \param delims set of delimiters
+     * \param mode whatever empty tokens are skipped or kept
+     * \param quote quote character, or '\0' if quoting is not used
+     */
+    tokenizer(const char* first, const char* last, const delimiter_set& delims,
+              empty_tokens mode = empty_tokens::skip, char quote = '\0') :
+        __m_first(first), __m_last(last), __m_delims(delims), __m_mode(mode), __m_quote(quote) {
+    }
+
+    inline const_iterator begin() const { return const_iterator(this); }
+    inline const_iterator end() const { return const_iterator(); }
+
+private:
+    const char* __m_first;
+    const char* __m_last;
+    delimiter_set __m_delims;
+    empty_tokens __m_mode;
+    char __m_quote;
+};
+
+
+/*!
+ * \brief tokenize
+ * \return range of tokens of \a text separated by any of \a delims,
+ * empty tokens are skipped as in split()
+ */
+template<class _Traits, class _Alloc>
+inline tokenizer tokenize(const std::basic_string<char, _Traits, _Alloc>& text, const delimiter_set& delims) {
+    return tokenizer(text.data(), text.data() + text.size(), delims);
+}
+
+/*!
+ * \brief tokenize
+ * \return range of tokens of \a text separated by any of \a delims,
+ * empty tokens are skipped as in split()
+ */
+template<class _Traits>
+inline tokenizer tokenize(std::experimental::basic_string_view<char, _Traits> text, const delimiter_set& delims) {
+    return tokenizer(text.data(), text.data() + text.size(), delims);
+}
+
+/*!
+ * \brief csv_tokenize
+ * \return range of fields of CSV record \a line, fields
+ * are separated by \a separator and may be quoted with \a quote
+ */
+inline tokenizer csv_tokenize(std::experimental::string_view line, char separator = ',', char quote = '"') {
+    return tokenizer(line.data(), line.data() + line.size(), delimiter_set(separator), empty_tokens::keep, quote);
+}
+
+_STDX_END
@@ -33,4 +33,5 @@
 // searching algorithms
 #include "searching/exponential_search.hpp"
 #include "searching/interpolation_search.hpp"
+#include "searching/static_search_index.hpp"
 
@@ -0,0 +1,377 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../../platform/common.h"
+#include "../../platform/bits.h"
+#include "../ext/kway_utility.hpp"
+
+/*
+ * Number of keys in node of btree_layout.
+ */
+#ifndef _SEARCH_INDEX_NODE_SIZE
+#    define _SEARCH_INDEX_NODE_SIZE 16
+#endif
+
+_STDX_BEGIN
+
+//! Eytzinger (BFS) layout: children of key k are keys 2k and 2k + 1
+struct eytzinger_layout {};
+
+//! Static B-tree layout: nodes of _SEARCH_INDEX_NODE_SIZE keys with node size + 1 children
+struct btree_layout {};
+
+namespace detail
+{
+	inline void __prefetch(const void* p) 
+	{
+#if defined(STDX_PROCESSOR_X86_64)
+		_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+		__builtin_prefetch(p);
+#else
+		(void)p;
+#endif
+	}
+
+	/*
+	 * Keys of search index and their ranks in original sorted range.
+	 * Keys are aligned to cache line (if key size allows), so blocks 
+	 * of the layout do not straddle cache lines.
+	 */
+	template<class _Tp, class _Comp>
+	class __search_index_base
+	{
+	public:
+		typedef _Tp value_type;
+		typedef _Comp value_compare;
+		typedef size_t size_type;
+		typedef uint32_t rank_type;
+
+		static const size_t cache_line = 64;
+
+		size_type size() const { 
+			return __m_size; 
+		}
+
+		bool empty() const { 
+			return (__m_size == 0); 
+		}
+
+		value_compare value_comp() const {
+			return __m_comp;
+		}
+
+	protected:
+		__search_index_base(size_type n, size_type nkeys, const _Comp& comp) :
+			__m_comp(comp), __m_size(n), __m_offset(0)
+		{
+			if (n >= (std::numeric_limits<rank_type>::max)())
+				throw std::length_error("static_search_index is too large");
+
+			const size_t spare = (cache_line % sizeof(_Tp) == 0 ? cache_line / sizeof(_Tp) : 0);
+			__m_storage.resize(nkeys + spare);
+			__m_ranks.resize(nkeys);
+			if (spare != 0) {
+				uintptr_t addr = reinterpret_cast<uintptr_t>(__m_storage.data());
+				__m_offset = ((cache_line - addr % cache_line) % cache_line) / sizeof(_Tp);
+			}
+		}
+
+		__search_index_base(const __search_index_base& other) :
+			__m_comp(other.__m_comp), __m_storage(other.__m_storage.size()), __m_ranks(other.__m_ranks), 
+			__m_size(other.__m_size), __m_offset(other.__m_offset)
+		{
+			// keep alignment of copied storage
+			if (__m_storage.size() > __m_ranks.size()) {
+				uintptr_t addr = reinterpret_cast<uintptr_t>(__m_storage.data());
+				__m_offset = ((cache_line - addr % cache_line) % cache_line) / sizeof(_Tp);
+			}
+			std::copy(other.keys(), other.keys() + __m_ranks.size(), keys());
+		}
+
+		__search_index_base(__search_index_base&&) = default;
+		__search_index_base& operator=(const __search_index_base& other) {
+			if (this != &other) {
+				__search_index_base tmp(other);
+				*this = std::move(tmp);
+			}
+			return *this;
+		}
+		__search_index_base& operator=(__search_index_base&&) = default;
+
+		_Tp* keys() { 
+			return __m_storage.data() + __m_offset; 
+		}
+
+		const _Tp* keys() const { 
+			return __m_storage.data() + __m_offset; 
+		}
+
+		_Comp __m_comp;
+		std::vector<_Tp> __m_storage;
+		std::vector<rank_type> __m_ranks;
+		size_type __m_size;
+		size_type __m_offset;
+	};
+
+	// number of keys of node less than x
+	template<size_t _NodeSize, class _Tp, class _Comp>
+	inline size_t __node_rank(const _Tp* node, const _Tp& x, _Comp comp, std::false_type)
+	{
+		size_t r = 0;
+		for (size_t j = 0; j < _NodeSize; j++)
+			r += static_cast<size_t>(comp(node[j], x));
+		return r;
+	}
+
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+	template<size_t _NodeSize, class _Tp, class _Comp>
+	inline size_t __node_rank(const _Tp* node, const _Tp& x, _Comp, std::true_type)
+	{
+		const size_t lanes = 32 / sizeof(_Tp);
+		const __m256i vx = (sizeof(_Tp) == 4 ? _mm256_set1_epi32(static_cast<int32_t>(x)) : _mm256_set1_epi64x(static_cast<int64_t>(x)));
+		size_t r = 0;
+		for (size_t j = 0; j < _NodeSize; j += lanes) {
+			__m256i keys = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + j));
+			__m256i less = (sizeof(_Tp) == 4 ? _mm256_cmpgt_epi32(vx, keys) : _mm256_cmpgt_epi64(vx, keys));
+			r += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(less)));
+		}
+		return r / sizeof(_Tp);
+	}
+#endif
+
+	// node is searched by SIMD: 32/64-bit signed keys in natural order, whole registers per node
+	template<class _Tp, class _Comp, size_t _NodeSize>
+	struct __use_simd_node_rank : std::integral_constant<bool,
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+		std::is_integral<_Tp>::value && std::is_signed<_Tp>::value &&
+		(sizeof(_Tp) == 4 || sizeof(_Tp) == 8) &&
+		(_NodeSize * sizeof(_Tp)) % 32 == 0 &&
+		utility::__is_natural_order<_Comp, _Tp>::value
+#else
+		false
+#endif
+	> {};
+}
+
+template<class _Tp, class _Layout = eytzinger_layout, class _Comp = std::less<_Tp> >
+class static_search_index;
+
+/*!
+ * \brief Read-only sorted sequence rearranged for fast lower_bound queries.
+ *
+ * Binary search over large sorted array takes a cache miss per probe.
+ * Eytzinger layout stores keys in breadth-first order of implicit 
+ * binary search tree: first levels share few cache lines, and the 
+ * 16 grand-grand-children of a key are adjacent, so the search prefetches
+ * them 4 levels ahead and goes down without branches.
+ *
+ * \tparam _Tp   key type
+ * \tparam _Comp models strict weak ordering
+ */
+template<class _Tp, class _Comp>
+class static_search_index<_Tp, eytzinger_layout, _Comp> :
+	public detail::__search_index_base<_Tp, _Comp>
+{
+	typedef detail::__search_index_base<_Tp, _Comp> base_type;
+public:
+	typedef typename base_type::size_type size_type;
+	typedef typename base_type::rank_type rank_type;
+
+	/*!
+	 * \brief Build index of sorted range [first, last)
+	 * \throw std::length_error if range has 2^32 - 1 elements or more
+	 */
+	template<class _RanIt>
+	static_search_index(_RanIt first, _RanIt last, const _Comp& comp = _Comp()) :
+		base_type(std::distance(first, last), std::distance(first, last) + 1, comp)
+	{
+		if (this->__m_size > 0) 
+			__build(first, 0, 1);
+	}
+
+	/*!
+	 * \brief Rank of the first key not less than x in original range, size() if there is none.
+	 * Same as std::lower_bound(first, last, x, comp) - first.
+	 */
+	size_type lower_bound(const _Tp& x) const {
+		size_t k = __search(x);
+		return (k == 0 ? this->__m_size : this->__m_ranks[k]);
+	}
+
+	//! Index has key equivalent to x
+	bool contains(const _Tp& x) const {
+		size_t k = __search(x);
+		return (k != 0 && !this->__m_comp(x, this->keys()[k]));
+	}
+
+private:
+	// in-order assignment of sorted keys to subtree rooted at k
+	template<class _RanIt>
+	size_t __build(_RanIt first, size_t i, size_t k)
+	{
+		if (k <= this->__m_size) {
+			i = __build(first, i, 2 * k);
+			this->keys()[k] = *(first + i);
+			this->__m_ranks[k] = static_cast<rank_type>(i);
+			i = __build(first, i + 1, 2 * k + 1);
+		}
+		return i;
+	}
+
+	// index of the first key not less than x or 0
+	size_t __search(const _Tp& x) const 
+	{
+		const size_t block = (std::max)(size_t(1), base_type::cache_line / sizeof(_Tp));
+		const _Tp* keys = this->keys();
+		const uintptr_t base = reinterpret_cast<uintptr_t>(keys);
+		const size_t n = this->__m_size;
+
+		size_t k = 1;
+		while (k <= n) {
+			detail::__prefetch(reinterpret_cast<const void*>(base + k * block * sizeof(_Tp)));
+			k = 2 * k + static_cast<size_t>(this->__m_comp(keys[k], x));
+		}
+		// go up while coming from the right child
+		k >>= __builtin_ctzll(~static_cast<unsigned long long>(k)) + 1;
+		return k;
+	}
+};
+
+/*!
+ * \brief Read-only sorted sequence rearranged for fast lower_bound queries.
+ *
+ * Static B-tree layout (S-tree) stores keys in nodes of 
+ * _SEARCH_INDEX_NODE_SIZE keys (one cache line of 32-bit keys),
+ * node k has children k * (size + 1) + i + 1. The search takes 
+ * log(n) / log(size + 1) node visits, every node is ranked by 
+ * counting its keys less than x: with AVX2 two (32-bit keys) 
+ * or four (64-bit keys) comparisons and popcount per node.
+ * The last node is padded by copies of the greatest key.
+ *
+ * \tparam _Tp   key type
+ * \tparam _Comp models strict weak ordering
+ */
+template<class _Tp, class _Comp>
+class static_search_index<_Tp, btree_layout, _Comp> :
+	public detail::__search_index_base<_Tp, _Comp>
+{
+	typedef detail::__search_index_base<_Tp, _Comp> base_type;
+	static const size_t node_size = _SEARCH_INDEX_NODE_SIZE;
+public:
+	typedef typename base_type::size_type size_type;
+	typedef typename base_type::rank_type rank_type;
+
+	/*!
+	 * \brief Build index of sorted range [first, last)
+	 * \throw std::length_error if range has 2^32 - 1 elements or more
+	 */
+	template<class _RanIt>
+	static_search_index(_RanIt first, _RanIt last, const _Comp& comp = _Comp()) :
+		base_type(std::distance(first, last), __nodes(std::distance(first, last)) * node_size, comp),
+		__m_nodes(__nodes(std::distance(first, last)))
+	{
+		size_t i = 0;
+		if (this->__m_size > 0)
+			__build(first, i, 0);
+	}
+
+	/*!
+	 * \brief Rank of the first key not less than x in original range, size() if there is none.
+	 * Same as std::lower_bound(first, last, x, comp) - first.
+	 */
+	size_type lower_bound(const _Tp& x) const {
+		size_t slot = __search(x);
+		return (slot == npos ? this->__m_size : this->__m_ranks[slot]);
+	}
+
+	//! Index has key equivalent to x
+	bool contains(const _Tp& x) const {
+		size_t slot = __search(x);
+		return (slot != npos && !this->__m_comp(x, this->keys()[slot]));
+	}
+
+private:
+	static const size_t npos = static_cast<size_t>(-1);
+
+	static size_t __nodes(size_t n) {
+		return (n + node_size - 1) / node_size;
+	}
+
+	static size_t __child(size_t k, size_t i) {
+		return k * (node_size + 1) + i + 1;
+	}
+
+	// in-order assignment of sorted keys to subtree rooted at node k
+	template<class _RanIt>
+	void __build(_RanIt first, size_t& i, size_t k)
+	{
+		if (k >= __m_nodes)
+			return;
+		const size_t n = this->__m_size;
+		for (size_t j = 0; j < node_size; j++) {
+			__build(first, i, __child(k, j));
+			this->keys()[k * node_size + j] = *(first + (i < n ? i : n - 1));
+			this->__m_ranks[k * node_size + j] = static_cast<rank_type>(i < n ? i : n);
+			++i;
+		}
+		__build(first, i, __child(k, node_size));
+	}
+
+	// slot of the first key not less than x or npos
+	size_t __search(const _Tp& x) const 
+	{
+		typedef std::integral_constant<bool, detail::__use_simd_node_rank<_Tp, _Comp, node_size>::value> use_simd;
+		const _Tp* keys = this->keys();
+
+		size_t slot = npos;
+		for (size_t k = 0; k < __m_nodes; ) {
+			size_t i = detail::__node_rank<node_size>(keys + k * node_size, x, this->__m_comp, use_simd());
+			if (i < node_size)
+				slot = k * node_size + i;
+			k = __child(k, i);
+		}
+		return slot;
+	}
+
+	size_t __m_nodes;
+};
+
+_STDX_END
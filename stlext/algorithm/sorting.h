@@ -33,4 +33,8 @@
 #include "sorting/bucket_sort.hpp"
 #include "sorting/counting_sort.hpp"
 #include "sorting/insertion_sort.hpp"
+#include "sorting/parallel_sort.hpp"
+#include "sorting/radix_sort.hpp"
 #include "sorting/selection_sort.hpp"
+#include "sorting/simd_sort.hpp"
+#include "sorting/small_sort.hpp"
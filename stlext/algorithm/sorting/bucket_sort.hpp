@@ -34,10 +34,15 @@
 #include <queue>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iterator>
+#include <random>
+#include <thread>
 
 #include "../../platform/common.h"
+#include "../../threads/thread_set.hpp"
 
 
 
@@ -185,5 +190,353 @@ void bucket_sort(_It first, _It last)
 	bucket_sort(first, last, bucketizer<value_type>(first, last));
 }
 
+
+/*
+ * Ranges shorter than this (per thread) are distributed by single thread.
+ */
+#ifndef _BUCKET_SORT_MIN_CHUNK
+#    define _BUCKET_SORT_MIN_CHUNK 16384
+#endif
+
+/*
+ * Number of sample elements drawn per bucket by sample_bucketizer.
+ */
+#ifndef _SAMPLE_SORT_OVERSAMPLING
+#    define _SAMPLE_SORT_OVERSAMPLING 16
+#endif
+
+/*
+ * Maximal number of buckets (power of 2) chosen by sample_sort.
+ */
+#ifndef _SAMPLE_SORT_MAX_BUCKETS
+#    define _SAMPLE_SORT_MAX_BUCKETS 256
+#endif
+
+/*!
+ * \brief Bucketizer of super scalar sample sort.
+ *
+ * Splitters are chosen from sorted random sample of the input and
+ * stored as implicit binary search tree (children of node i are 
+ * 2i and 2i+1), so an element is classified by log(k) branchless 
+ * steps: i = 2i + comp(tree[i], x). Buckets hold elements of equal 
+ * sizes whatever the distribution of keys is.
+ *
+ * If the sample has repeated keys, every splitter gets equality bucket 
+ * next to its bucket: frequent keys go there and need no sorting 
+ * (see is_equal_bucket()), so skewed input does not end up in a single 
+ * giant bucket.
+ *
+ * \tparam _Tp   value type
+ * \tparam _Comp models strict weak ordering
+ */
+template<class _Tp, class _Comp = std::less<_Tp> >
+class sample_bucketizer
+{
+public:
+	/*!
+	 * \brief Choose nbuckets - 1 splitters from sample of [first, last).
+	 * \param nbuckets number of buckets, rounded up to power of 2
+	 */
+	template<class _RanIt>
+	sample_bucketizer(_RanIt first, _RanIt last, size_t nbuckets = _SAMPLE_SORT_MAX_BUCKETS, 
+					  _Comp comp = _Comp(), unsigned seed = 0) :
+		__m_comp(comp), __m_log(0), __m_equal(false)
+	{
+		size_t n = std::distance(first, last);
+		while ((size_t(1) << __m_log) < nbuckets)
+			++__m_log;
+		if (n == 0) {
+			__m_log = 0;
+			return;
+		}
+
+		const size_t k = size_t(1) << __m_log;
+		std::mt19937_64 rnd(seed);
+		std::vector<_Tp> sample;
+		sample.reserve(k * _SAMPLE_SORT_OVERSAMPLING);
+		for (size_t i = 0; i < k * _SAMPLE_SORT_OVERSAMPLING; i++)
+			sample.push_back(*(first + static_cast<ptrdiff_t>(rnd() % n)));
+		std::sort(sample.begin(), sample.end(), __m_comp);
+
+		__m_splitters.reserve(k - 1);
+		for (size_t i = 1; i < k; i++)
+			__m_splitters.push_back(sample[i * sample.size() / k]);
+
+		for (size_t i = 1; i < __m_splitters.size(); i++) {
+			if (!__m_comp(__m_splitters[i - 1], __m_splitters[i])) 
+				__m_equal = true;
+		}
+
+		__m_tree.resize(k);
+		if (k > 1) 
+			__build(1, 0, k - 1);
+	}
+
+	//! Bucket index of x, buckets are ordered
+	size_t operator()(const _Tp& x) const 
+	{
+		size_t i = 1;
+		for (unsigned l = 0; l < __m_log; l++)
+			i = 2 * i + static_cast<size_t>(__m_comp(__m_tree[i], x));
+		i -= (size_t(1) << __m_log); // splitters[i - 1] < x <= splitters[i]
+		if (__m_equal) 
+			i = 2 * i + static_cast<size_t>(i < __m_splitters.size() && !__m_comp(x, __m_splitters[i]));
+		return i;
+	}
+
+	//! Number of buckets
+	size_t size() const {
+		size_t k = size_t(1) << __m_log;
+		return (__m_equal ? 2 * k - 1 : k);
+	}
+
+	//! Bucket holds keys equal to a splitter
+	bool is_equal_bucket(size_t i) const {
+		return (__m_equal && (i & 1) != 0);
+	}
+
+	const std::vector<_Tp>& splitters() const {
+		return __m_splitters;
+	}
+
+private:
+	// in-order assignment of splitters [lo, hi) to subtree of node
+	void __build(size_t node, size_t lo, size_t hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		__m_tree[node] = __m_splitters[mid];
+		if (2 * node < __m_tree.size()) {
+			__build(2 * node, lo, mid);
+			__build(2 * node + 1, mid + 1, hi);
+		}
+	}
+
+	_Comp __m_comp;
+	std::vector<_Tp> __m_splitters;
+	std::vector<_Tp> __m_tree;
+	unsigned __m_log;
+	bool __m_equal;
+};
+
+namespace detail
+{
+	template<class _Bucketizer>
+	inline auto __is_equal_bucket(const _Bucketizer& b, size_t i, int) -> decltype(b.is_equal_bucket(i)) {
+		return b.is_equal_bucket(i);
+	}
+
+	template<class _Bucketizer>
+	inline bool __is_equal_bucket(const _Bucketizer&, size_t, long) {
+		return false;
+	}
+
+	/*
+	 * Work stealing range of task indices: owner takes tasks from 
+	 * the front, thieves take them from the back. Both ends are
+	 * packed into one word updated by CAS, so the last task is
+	 * taken exactly once.
+	 */
+	struct __steal_range
+	{
+		std::atomic<uint64_t> __m_state;
+		char __m_padding[64 - sizeof(std::atomic<uint64_t>)]; // keep ranges on separate cache lines
+
+		void assign(uint32_t head, uint32_t tail) {
+			__m_state.store((uint64_t(head) << 32) | tail, std::memory_order_relaxed);
+		}
+
+		bool pop_front(size_t& i) {
+			uint64_t s = __m_state.load(std::memory_order_relaxed);
+			for (;;) {
+				uint32_t head = static_cast<uint32_t>(s >> 32), tail = static_cast<uint32_t>(s);
+				if (head >= tail)
+					return false;
+				if (__m_state.compare_exchange_weak(s, (uint64_t(head + 1) << 32) | tail, std::memory_order_acq_rel)) {
+					i = head;
+					return true;
+				}
+			}
+		}
+
+		bool pop_back(size_t& i) {
+			uint64_t s = __m_state.load(std::memory_order_relaxed);
+			for (;;) {
+				uint32_t head = static_cast<uint32_t>(s >> 32), tail = static_cast<uint32_t>(s);
+				if (head >= tail)
+					return false;
+				if (__m_state.compare_exchange_weak(s, (uint64_t(head) << 32) | (tail - 1), std::memory_order_acq_rel)) {
+					i = tail - 1;
+					return true;
+				}
+			}
+		}
+	};
+
+	// run task(0..p-1) concurrently
+	template<class _Executor, class _Task>
+	void __run_tasks(_Executor& executor, size_t p, _Task task) {
+		if (p == 1) {
+			task(size_t(0));
+			return;
+		}
+		for (size_t t = 0; t < p; t++)
+			executor([&task, t] { task(t); });
+		executor.join();
+	}
+}
+
+/*!
+ * \fn bucket_sort(_RanIt first, _RanIt last, _Bucketizer b, _Comp comp, size_t nthreads, _Executor& executor)
+ * \brief Sort range [first, last) distributing it into buckets by nthreads concurrent tasks.
+ *
+ * Every task classifies its chunk of the range (bucket indices are
+ * kept), then moves elements of its chunk into their buckets in 
+ * temporary buffer. Buckets are sorted with std::sort and moved 
+ * back by nthreads tasks with work stealing: buckets are dealt from 
+ * the largest one, a task finishing its own buckets takes the 
+ * smallest ones of others. Equality buckets (see sample_bucketizer)
+ * are only moved back.
+ *
+ * \tparam _RanIt      models random access iterator, value type must be
+ *                     default constructible and move assignable
+ * \tparam _Bucketizer maps value to bucket index in [0, b.size()), 
+ *                     buckets must be ordered according to comp
+ * \tparam _Comp       models strict weak ordering
+ * \tparam _Executor   runs tasks concurrently (see parallel_sort)
+ */
+template<class _RanIt, class _Bucketizer, class _Comp, class _Executor>
+void bucket_sort(_RanIt first, _RanIt last, const _Bucketizer& b, _Comp comp, size_t nthreads, _Executor& executor)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+
+	const size_t n = std::distance(first, last);
+	const size_t nb = b.size();
+	if (n < 2)
+		return;
+
+	size_t p = (std::max)(size_t(1), (std::min)(nthreads, n / _BUCKET_SORT_MIN_CHUNK));
+	auto chunk_begin = [n, p](size_t t) { return t * n / p; };
+
+	// classify: count[t * nb + i] is size of bucket i in chunk t
+	std::vector<uint32_t> oracle(n);
+	std::vector<size_t> count(p * nb, 0);
+	detail::__run_tasks(executor, p, [&](size_t t) {
+		size_t* cnt = count.data() + t * nb;
+		for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; i++) {
+			size_t j = b(*(first + i));
+			oracle[i] = static_cast<uint32_t>(j);
+			++cnt[j];
+		}
+	});
+
+	// bucket bounds and chunk offsets inside buckets
+	std::vector<size_t> bounds(nb + 1, 0);
+	for (size_t j = 0, sum = 0; j < nb; j++) {
+		bounds[j] = sum;
+		for (size_t t = 0; t < p; t++) {
+			size_t c = count[t * nb + j];
+			count[t * nb + j] = sum;
+			sum += c;
+		}
+	}
+	bounds[nb] = n;
+
+	// distribute
+	std::vector<value_type> buffer(n);
+	detail::__run_tasks(executor, p, [&](size_t t) {
+		size_t* offset = count.data() + t * nb;
+		for (size_t i = chunk_begin(t), end = chunk_begin(t + 1); i < end; i++)
+			buffer[offset[oracle[i]]++] = std::move(*(first + i));
+	});
+
+	// deal buckets from the largest: task t owns order[first_task[t], first_task[t + 1])
+	std::vector<size_t> sorted(nb);
+	for (size_t j = 0; j < nb; j++)
+		sorted[j] = j;
+	std::sort(sorted.begin(), sorted.end(), [&bounds](size_t x, size_t y) {
+		return (bounds[x + 1] - bounds[x]) > (bounds[y + 1] - bounds[y]);
+	});
+
+	std::vector<size_t> order;
+	order.reserve(nb);
+	std::vector<detail::__steal_range> ranges(p);
+	for (size_t t = 0; t < p; t++) {
+		size_t head = order.size();
+		for (size_t j = t; j < nb; j += p)
+			order.push_back(sorted[j]);
+		ranges[t].assign(static_cast<uint32_t>(head), static_cast<uint32_t>(order.size()));
+	}
+
+	detail::__run_tasks(executor, p, [&](size_t t) {
+		auto process = [&](size_t j) {
+			auto from = buffer.begin() + bounds[order[j]];
+			auto to = buffer.begin() + bounds[order[j] + 1];
+			if (to - from > 1 && !detail::__is_equal_bucket(b, order[j], 0))
+				std::sort(from, to, comp);
+			std::move(from, to, first + bounds[order[j]]);
+		};
+
+		size_t j;
+		for (;;) {
+			if (ranges[t].pop_front(j)) {
+				process(j);
+				continue;
+			}
+			bool stolen = false;
+			for (size_t v = 1; v < p && !stolen; v++) {
+				if (ranges[(t + v) % p].pop_back(j)) {
+					process(j);
+					stolen = true;
+				}
+			}
+			if (!stolen)
+				return;
+		}
+	});
+}
+
+/*!
+ * \fn sample_sort(_RanIt first, _RanIt last, _Comp comp, size_t nthreads)
+ * \brief Sort range [first, last) by parallel super scalar sample sort.
+ *
+ * Range is distributed into up to _SAMPLE_SORT_MAX_BUCKETS buckets 
+ * by sample_bucketizer and buckets are sorted by nthreads threads
+ * of stdx::thread_set (see bucket_sort). The sort is not stable.
+ */
+template<class _RanIt, class _Comp>
+void sample_sort(_RanIt first, _RanIt last, _Comp comp, size_t nthreads)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+
+	size_t n = std::distance(first, last);
+	size_t nbuckets = (std::min)(size_t(_SAMPLE_SORT_MAX_BUCKETS), (std::max)(size_t(1), n / 1024));
+	nbuckets = (std::max)(nbuckets, 4 * nthreads);
+
+	thread_set threads;
+	sample_bucketizer<value_type, _Comp> b(first, last, nbuckets, comp);
+	bucket_sort(first, last, b, comp, nthreads, threads);
+}
+
+/*!
+ * \fn sample_sort(_RanIt first, _RanIt last, _Comp comp)
+ * \brief Sort range [first, last) by parallel sample sort using all hardware threads.
+ */
+template<class _RanIt, class _Comp>
+inline void sample_sort(_RanIt first, _RanIt last, _Comp comp)
+{
+	size_t nthreads = std::thread::hardware_concurrency();
+	sample_sort(first, last, comp, (nthreads > 0 ? nthreads : 1));
+}
+
+/*!
+ * \fn sample_sort(_RanIt first, _RanIt last)
+ * \brief Sort range [first, last) in ascending order by parallel sample sort.
+ */
+template<class _RanIt>
+inline void sample_sort(_RanIt first, _RanIt last)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+	sample_sort(first, last, std::less<value_type>());
+}
+
 _STDX_END
 
@@ -0,0 +1,226 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "../../platform/common.h"
+#include "../../threads/thread_set.hpp"
+#include "../ext/kway_merge.hpp"
+
+/*
+ * Ranges shorter than this (per thread) are sorted sequentially:
+ * spawning threads and merging do not pay off for them.
+ */
+#ifndef _PARALLEL_SORT_MIN_CHUNK
+#    define _PARALLEL_SORT_MIN_CHUNK 32768
+#endif
+
+_STDX_BEGIN
+
+namespace detail
+{
+	/*
+	 * Exact multisequence selection: split sorted sequences [lo[i], hi[i])
+	 * so that prefixes hold exactly r elements in total and none of them
+	 * is greater than any element of suffixes.
+	 * 
+	 * Elements are ranked by (value, sequence index), so equal keys split 
+	 * deterministically. Every step takes the median of the widest active 
+	 * range, ranks it in all sequences by binary search and narrows the 
+	 * ranges to one side of it: O(p^2 log^2 n) comparisons for p sequences.
+	 * On return lo[i] == hi[i] is the split position of sequence i.
+	 */
+	template<class _RanIt, class _Comp>
+	void __multiseq_select(const std::vector<_RanIt>& seqs, 
+						   std::vector<size_t>& lo, std::vector<size_t>& hi,
+						   size_t r, _Comp comp)
+	{
+		const size_t p = lo.size();
+		std::vector<size_t> cnt(p);
+		for (;;)
+		{
+			size_t j = p;
+			size_t width = 0;
+			for (size_t i = 0; i < p; i++) {
+				if (hi[i] - lo[i] > width) {
+					width = hi[i] - lo[i];
+					j = i;
+				}
+			}
+			if (j == p) 
+				return; // all ranges narrowed to split points
+
+			size_t m = lo[j] + width / 2;
+			const auto& x = *(seqs[j] + m);
+
+			size_t rank = 0;
+			for (size_t i = 0; i < p; i++) {
+				if (i < j) // equal keys of preceding sequences go first
+					cnt[i] = std::upper_bound(seqs[i] + lo[i], seqs[i] + hi[i], x, comp) - seqs[i];
+				else if (i > j)
+					cnt[i] = std::lower_bound(seqs[i] + lo[i], seqs[i] + hi[i], x, comp) - seqs[i];
+				else
+					cnt[i] = m;
+				rank += cnt[i];
+			}
+
+			if (rank < r) { // x belongs to prefix
+				for (size_t i = 0; i < p; i++) 
+					lo[i] = cnt[i];
+				lo[j] = m + 1;
+			}
+			else {
+				for (size_t i = 0; i < p; i++) 
+					hi[i] = cnt[i];
+			}
+		}
+	}
+}
+
+/*!
+ * \fn parallel_sort(_RanIt first, _RanIt last, _Comp comp, size_t nthreads, _Executor& executor)
+ * \brief Sort range [first, last) using nthreads concurrent tasks.
+ *
+ * Range is cut into nthreads chunks sorted concurrently with std::sort,
+ * then output is cut into nthreads equal ranges: exact multisequence
+ * selection finds the part of every chunk falling into each output range,
+ * so every task merges (kway_merge) its parts into disjoint range of
+ * temporary buffer without synchronization. Finally tasks move merged
+ * ranges back.
+ * 
+ * The sort is not stable.
+ *
+ * \tparam _RanIt    models random access iterator, value type must be
+ *                   default constructible and copy assignable
+ * \tparam _Comp     models strict weak ordering
+ * \tparam _Executor runs tasks concurrently: executor(task) launches
+ *                   task, executor.join() waits for all launched tasks
+ *                   (stdx::thread_set meets these requirements)
+ *
+ * \param first    The start of the input sequence
+ * \param last     One past the end of the input sequence
+ * \param comp     comparison function object
+ * \param nthreads number of concurrent tasks
+ * \param executor tasks executor
+ */
+template<class _RanIt, class _Comp, class _Executor>
+void parallel_sort(_RanIt first, _RanIt last, _Comp comp, size_t nthreads, _Executor& executor)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+
+	size_t n = std::distance(first, last);
+	size_t p = (std::min)(nthreads, n / _PARALLEL_SORT_MIN_CHUNK);
+	if (p < 2) {
+		std::sort(first, last, comp);
+		return;
+	}
+
+	// sort chunks
+	std::vector<_RanIt> seqs(p);
+	std::vector<size_t> sizes(p);
+	for (size_t t = 0; t < p; t++) {
+		seqs[t] = first + (t * n / p);
+		sizes[t] = ((t + 1) * n / p) - (t * n / p);
+		executor([&, t] { std::sort(seqs[t], seqs[t] + sizes[t], comp); });
+	}
+	executor.join();
+
+	// select splitters: split[t][i] is the start of output range t in chunk i
+	std::vector< std::vector<size_t> > split(p + 1);
+	split[0].assign(p, 0);
+	split[p] = sizes;
+	for (size_t t = 1; t < p; t++) {
+		executor([&, t] {
+			std::vector<size_t> lo(p, 0), hi(sizes);
+			detail::__multiseq_select(seqs, lo, hi, t * n / p, comp);
+			split[t].swap(lo);
+		});
+	}
+	executor.join();
+
+	// merge disjoint output ranges
+	std::vector<value_type> buffer(n);
+	for (size_t t = 0; t < p; t++) {
+		executor([&, t] {
+			std::vector< std::pair<_RanIt, _RanIt> > parts;
+			parts.reserve(p);
+			for (size_t i = 0; i < p; i++) 
+				parts.emplace_back(seqs[i] + split[t][i], seqs[i] + split[t + 1][i]);
+			kway_merge(parts, buffer.begin() + (t * n / p), comp);
+		});
+	}
+	executor.join();
+
+	// move back
+	for (size_t t = 0; t < p; t++) {
+		executor([&, t] {
+			auto from = buffer.begin() + (t * n / p);
+			auto to = buffer.begin() + ((t + 1) * n / p);
+			std::move(from, to, first + (t * n / p));
+		});
+	}
+	executor.join();
+}
+
+/*!
+ * \fn parallel_sort(_RanIt first, _RanIt last, _Comp comp, size_t nthreads)
+ * \brief Sort range [first, last) using nthreads threads of stdx::thread_set.
+ */
+template<class _RanIt, class _Comp>
+inline void parallel_sort(_RanIt first, _RanIt last, _Comp comp, size_t nthreads)
+{
+	thread_set threads;
+	parallel_sort(first, last, comp, nthreads, threads);
+}
+
+/*!
+ * \fn parallel_sort(_RanIt first, _RanIt last, _Comp comp)
+ * \brief Sort range [first, last) using all hardware threads.
+ */
+template<class _RanIt, class _Comp>
+inline void parallel_sort(_RanIt first, _RanIt last, _Comp comp)
+{
+	size_t nthreads = std::thread::hardware_concurrency();
+	parallel_sort(first, last, comp, (nthreads > 0 ? nthreads : 1));
+}
+
+template<class _RanIt>
+inline void parallel_sort(_RanIt first, _RanIt last)
+{
+	parallel_sort(first, last, std::less<>());
+}
+
+_STDX_END
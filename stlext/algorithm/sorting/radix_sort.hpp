@@ -0,0 +1,538 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../platform/common.h"
+#include "../../functional/identity.hpp"
+#include "insertion_sort.hpp"
+
+/*
+ * Ranges shorter than this are sorted by comparison: 
+ * histograms do not pay off for them.
+ */
+#ifndef _RADIX_SORT_THRESHOLD
+#    define _RADIX_SORT_THRESHOLD 64
+#endif
+
+/*
+ * Buckets of msd_radix_sort shorter than this are finished
+ * by insertion sort on the remaining suffixes.
+ */
+#ifndef _MSD_RADIX_SORT_CUTOFF
+#    define _MSD_RADIX_SORT_CUTOFF 32
+#endif
+
+_STDX_BEGIN
+
+namespace detail
+{
+	template<size_t _Size> struct __radix_uint;
+	template<> struct __radix_uint<1> { typedef uint8_t type; };
+	template<> struct __radix_uint<2> { typedef uint16_t type; };
+	template<> struct __radix_uint<4> { typedef uint32_t type; };
+	template<> struct __radix_uint<8> { typedef uint64_t type; };
+
+	/*
+	 * Maps key to unsigned integer of the same width, such that
+	 * unsigned order of images matches the order of keys:
+	 *  - unsigned keys are taken as is;
+	 *  - signed keys get their sign bit flipped;
+	 *  - floating point keys get their sign bit flipped if positive, 
+	 *    all bits flipped if negative (-0.0 precedes +0.0, 
+	 *    NaNs are placed on both ends according to their sign).
+	 */
+	template<class _Key, class = void>
+	struct __radix_traits;
+
+	template<class _Key>
+	struct __radix_traits<_Key, typename std::enable_if<std::is_integral<_Key>::value && std::is_unsigned<_Key>::value>::type>
+	{
+		typedef _Key bits_type;
+
+		static bits_type encode(_Key x) { 
+			return x; 
+		}
+	};
+
+	template<class _Key>
+	struct __radix_traits<_Key, typename std::enable_if<std::is_integral<_Key>::value && std::is_signed<_Key>::value>::type>
+	{
+		typedef typename std::make_unsigned<_Key>::type bits_type;
+
+		static bits_type encode(_Key x) {
+			return static_cast<bits_type>(static_cast<bits_type>(x) ^ (bits_type(1) << (sizeof(bits_type) * CHAR_BIT - 1)));
+		}
+	};
+
+	template<class _Key>
+	struct __radix_traits<_Key, typename std::enable_if<std::is_floating_point<_Key>::value>::type>
+	{
+		typedef typename __radix_uint<sizeof(_Key)>::type bits_type;
+
+		static bits_type encode(_Key x) {
+			bits_type bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			bits_type sign = bits_type(1) << (sizeof(bits_type) * CHAR_BIT - 1);
+			return static_cast<bits_type>(bits ^ ((bits & sign) ? bits_type(~bits_type(0)) : sign));
+		}
+	};
+
+	// default digit width: 8 bits for short keys, 11 bits (3 passes on 32-bit keys) for the others
+	template<class _Bits>
+	struct __radix_digit_bits : 
+		std::integral_constant<unsigned, (sizeof(_Bits) <= 2 ? 8 : 11)> 
+	{};
+
+	/*
+	 * Temporary storage for n values: trivial values are left
+	 * uninitialized, others are move constructed from the input range
+	 * (so the buffer holds the data and the range holds moved-from values).
+	 */
+	template<class _Tp, class _Alloc>
+	class __radix_buffer
+	{
+		typedef typename std::allocator_traits<_Alloc>::template rebind_alloc<_Tp> allocator_type;
+		typedef std::allocator_traits<allocator_type> alloc_traits;
+
+		__radix_buffer(const __radix_buffer&) = delete;
+		__radix_buffer& operator=(const __radix_buffer&) = delete;
+	public:
+		template<class _RanIt>
+		__radix_buffer(_RanIt first, size_t n, const _Alloc& al) :
+			__m_alloc(al), __m_data(alloc_traits::allocate(__m_alloc, n)), __m_size(n)
+		{
+			if (!std::is_trivial<_Tp>::value) {
+				try {
+					std::uninitialized_copy_n(std::make_move_iterator(first), n, __m_data);
+				} 
+				catch (...) {
+					alloc_traits::deallocate(__m_alloc, __m_data, n);
+					throw;
+				}
+			}
+		}
+
+		~__radix_buffer() {
+			if (!std::is_trivial<_Tp>::value) {
+				for (size_t i = 0; i < __m_size; i++)
+					alloc_traits::destroy(__m_alloc, __m_data + i);
+			}
+			alloc_traits::deallocate(__m_alloc, __m_data, __m_size);
+		}
+
+		_Tp* data() const {
+			return __m_data;
+		}
+
+	private:
+		allocator_type __m_alloc;
+		_Tp* __m_data;
+		size_t __m_size;
+	};
+
+	// stable scatter of [first, last) into out by digit at shift
+	template<class _InIt, class _OutIt, class _KeyOf, class _Bits>
+	void __radix_scatter(_InIt first, _InIt last, _OutIt out, size_t* offsets, 
+						 unsigned shift, _Bits mask, _KeyOf key_of)
+	{
+		for (; first != last; ++first) {
+			size_t digit = static_cast<size_t>((key_of(*first) >> shift) & mask);
+			out[offsets[digit]++] = std::move(*first);
+		}
+	}
+
+	// in-place MSD pass over 8-bit digits, recursing into buckets
+	template<class _RanIt, class _KeyOf>
+	void __american_flag_sort(_RanIt first, _RanIt last, unsigned shift, _KeyOf key_of)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+		const size_t radix = 256;
+
+		for (;;)
+		{
+			size_t n = std::distance(first, last);
+			if (n < _RADIX_SORT_THRESHOLD) {
+				insertion_sort(first, last, [&key_of](const value_type& x, const value_type& y) {
+					return key_of(x) < key_of(y);
+				});
+				return;
+			}
+
+			auto digit_of = [&key_of, shift](const value_type& x) {
+				return static_cast<size_t>((key_of(x) >> shift) & 0xFF);
+			};
+
+			size_t count[radix] = {};
+			for (_RanIt it = first; it != last; ++it)
+				++count[digit_of(*it)];
+
+			if (count[digit_of(*first)] == n) { // trivial digit
+				if (shift == 0)
+					return;
+				shift -= 8;
+				continue;
+			}
+
+			size_t head[radix], tail[radix];
+			size_t sum = 0;
+			for (size_t d = 0; d < radix; d++) {
+				head[d] = sum;
+				sum += count[d];
+				tail[d] = sum;
+			}
+
+			// permute elements into buckets following cycles
+			for (size_t b = 0; b < radix; b++) 
+			{
+				while (head[b] < tail[b]) 
+				{
+					value_type x = std::move(first[head[b]]);
+					size_t d = digit_of(x);
+					while (d != b) {
+						std::swap(x, first[head[d]++]);
+						d = digit_of(x);
+					}
+					first[head[b]++] = std::move(x);
+				}
+			}
+
+			if (shift == 0)
+				return;
+
+			for (size_t d = 0, start = 0; d < radix; start += count[d++]) {
+				if (count[d] > 1)
+					__american_flag_sort(first + start, first + start + count[d], shift - 8, key_of);
+			}
+			return;
+		}
+	}
+
+	// d-th character of string key + 1, or 0 past the end
+	template<class _String>
+	inline size_t __char_at(const _String& s, size_t d) {
+		return (d < s.size() ? static_cast<unsigned char>(s[d]) + 1 : 0);
+	}
+
+	// d-th character of null-terminated key (0 on terminator)
+	inline size_t __char_at(const char* s, size_t d) {
+		return static_cast<unsigned char>(s[d]);
+	}
+
+	// stable MSD string sort of n elements sharing first depth characters
+	template<class _RanIt, class _Tp, class _KeyOf>
+	void __msd_radix_sort(_RanIt first, size_t n, _Tp* aux, size_t depth, _KeyOf key_of)
+	{
+		const size_t radix = 257;
+
+		for (;;)
+		{
+			if (n < _MSD_RADIX_SORT_CUTOFF) {
+				insertion_sort(first, first + n, [&key_of, depth](const _Tp& x, const _Tp& y) {
+					const auto& sx = key_of(x);
+					const auto& sy = key_of(y);
+					for (size_t d = depth;; d++) {
+						size_t cx = __char_at(sx, d);
+						size_t cy = __char_at(sy, d);
+						if (cx != cy)
+							return cx < cy;
+						if (cx == 0)
+							return false;
+					}
+				});
+				return;
+			}
+
+			size_t start[radix + 1] = {};
+			for (size_t i = 0; i < n; i++)
+				++start[__char_at(key_of(first[i]), depth) + 1];
+
+			size_t c0 = __char_at(key_of(*first), depth);
+			if (start[c0 + 1] == n) { // all keys share this character
+				if (c0 == 0)
+					return; // all keys are equal
+				++depth;
+				continue;
+			}
+
+			for (size_t c = 0; c < radix; c++)
+				start[c + 1] += start[c];
+
+			size_t pos[radix];
+			std::copy(start, start + radix, pos);
+			for (size_t i = 0; i < n; i++)
+				aux[pos[__char_at(key_of(first[i]), depth)]++] = std::move(first[i]);
+			std::move(aux, aux + n, first);
+
+			// bucket 0 holds keys ending at depth: they are equal
+			for (size_t c = 1; c < radix; c++) {
+				size_t m = start[c + 1] - start[c];
+				if (m > 1)
+					__msd_radix_sort(first + start[c], m, aux, depth + 1, key_of);
+			}
+			return;
+		}
+	}
+}
+
+/*!
+ * \fn lsd_radix_sort(_RanIt first, _RanIt last, _Proj proj, const _Alloc& al)
+ * \brief Perform a stable LSD radix sort at range [first, last).
+ *
+ * Projected keys are mapped to unsigned integers preserving their order
+ * (see detail::__radix_traits), histograms of all digits are built in
+ * single pass over the input, then every digit scatters elements between
+ * input range and temporary buffer. Digits shared by all keys are skipped.
+ *
+ * \tparam _DigitBits digit width in bits (8, 11, 16...), 0 selects 
+ *                    8 bits for 8/16-bit keys and 11 bits otherwise
+ * \tparam _RanIt     models random access iterator, value type must be
+ *                    move constructible and move assignable
+ * \tparam _Proj      models projection unary function, returning 
+ *                    integral or floating point key
+ * \tparam _Alloc     models memory allocator
+ *
+ * \param first The start of the input sequence
+ * \param last  One past the end of the input sequence
+ * \param proj  projection function object
+ * \param al    Allocator used to allocate memory for internal needs
+ */
+template<unsigned _DigitBits = 0, class _RanIt, class _Proj, class _Alloc>
+void lsd_radix_sort(_RanIt first, _RanIt last, _Proj proj, const _Alloc& al)
+{
+	using namespace std;
+	typedef typename iterator_traits<_RanIt>::value_type value_type;
+	typedef typename decay<decltype(proj(*first))>::type key_type;
+	typedef detail::__radix_traits<key_type> traits;
+	typedef typename traits::bits_type bits_type;
+	typedef typename allocator_traits<_Alloc>::template rebind_alloc<size_t> count_allocator;
+
+	static_assert(_DigitBits <= 16, "digit is too wide");
+
+	const unsigned key_bits = sizeof(bits_type) * CHAR_BIT;
+	const unsigned digit_bits = (std::min)(_DigitBits ? _DigitBits : detail::__radix_digit_bits<bits_type>::value, key_bits);
+	const unsigned passes = (key_bits + digit_bits - 1) / digit_bits;
+	const size_t radix = size_t(1) << digit_bits;
+	const bits_type mask = static_cast<bits_type>(radix - 1);
+
+	auto key_of = [&proj](const value_type& x) {
+		return traits::encode(proj(x));
+	};
+
+	size_t n = distance(first, last);
+	if (n < 2)
+		return;
+
+	if (n < _RADIX_SORT_THRESHOLD) {
+		stable_sort(first, last, [&key_of](const value_type& x, const value_type& y) {
+			return key_of(x) < key_of(y);
+		});
+		return;
+	}
+
+	// histograms of all digits
+	vector<size_t, count_allocator> counts(passes * radix, 0, count_allocator(al));
+	for (_RanIt it = first; it != last; ++it) {
+		bits_type k = key_of(*it);
+		for (unsigned p = 0; p < passes; p++)
+			++counts[p * radix + static_cast<size_t>((k >> (p * digit_bits)) & mask)];
+	}
+
+	detail::__radix_buffer<value_type, _Alloc> buffer(first, n, al);
+	value_type* buf = buffer.data();
+	bool in_buffer = !is_trivial<value_type>::value; // where the data is now
+
+	for (unsigned p = 0; p < passes; p++) 
+	{
+		size_t* offsets = counts.data() + p * radix;
+		unsigned shift = p * digit_bits;
+
+		bits_type k = key_of(in_buffer ? *buf : *first);
+		if (offsets[static_cast<size_t>((k >> shift) & mask)] == n)
+			continue; // all keys share this digit
+
+		size_t sum = 0;
+		for (size_t d = 0; d < radix; d++) {
+			size_t c = offsets[d];
+			offsets[d] = sum;
+			sum += c;
+		}
+
+		if (in_buffer)
+			detail::__radix_scatter(buf, buf + n, first, offsets, shift, mask, key_of);
+		else
+			detail::__radix_scatter(first, last, buf, offsets, shift, mask, key_of);
+		in_buffer = !in_buffer;
+	}
+
+	if (in_buffer)
+		move(buf, buf + n, first);
+}
+
+/*!
+ * \fn lsd_radix_sort(_RanIt first, _RanIt last, _Proj proj)
+ * \brief Perform a stable LSD radix sort at range [first, last) by projected keys.
+ */
+template<unsigned _DigitBits = 0, class _RanIt, class _Proj>
+inline void lsd_radix_sort(_RanIt first, _RanIt last, _Proj proj)
+{
+	lsd_radix_sort<_DigitBits>(first, last, proj, std::allocator<char>());
+}
+
+/*!
+ * \fn lsd_radix_sort(_RanIt first, _RanIt last)
+ * \brief Perform a stable LSD radix sort at range [first, last) of integral or floating point values.
+ */
+template<unsigned _DigitBits = 0, class _RanIt>
+inline void lsd_radix_sort(_RanIt first, _RanIt last)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+	lsd_radix_sort<_DigitBits>(first, last, stdx::identity<value_type>(), std::allocator<char>());
+}
+
+
+/*!
+ * \fn american_flag_sort(_RanIt first, _RanIt last, _Proj proj)
+ * \brief Perform an in-place MSD radix sort (American flag sort) at range [first, last).
+ *
+ * Keys are mapped as in lsd_radix_sort and distributed by 8-bit digits 
+ * starting from the most significant one: elements are permuted into 
+ * their buckets in place, then every bucket is sorted by the next digit.
+ * No temporary buffer is needed, but the sort is not stable.
+ *
+ * \tparam _RanIt models random access iterator
+ * \tparam _Proj  models projection unary function, returning 
+ *                integral or floating point key
+ *
+ * \param first The start of the input sequence
+ * \param last  One past the end of the input sequence
+ * \param proj  projection function object
+ */
+template<class _RanIt, class _Proj>
+void american_flag_sort(_RanIt first, _RanIt last, _Proj proj)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+	typedef typename std::decay<decltype(proj(*first))>::type key_type;
+	typedef detail::__radix_traits<key_type> traits;
+	typedef typename traits::bits_type bits_type;
+
+	auto key_of = [&proj](const value_type& x) {
+		return traits::encode(proj(x));
+	};
+
+	if (first != last)
+		detail::__american_flag_sort(first, last, (sizeof(bits_type) - 1) * CHAR_BIT, key_of);
+}
+
+/*!
+ * \fn american_flag_sort(_RanIt first, _RanIt last)
+ * \brief Perform an in-place MSD radix sort at range [first, last) of integral or floating point values.
+ */
+template<class _RanIt>
+inline void american_flag_sort(_RanIt first, _RanIt last)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+	american_flag_sort(first, last, stdx::identity<value_type>());
+}
+
+
+/*!
+ * \fn msd_radix_sort(_RanIt first, _RanIt last, _Proj proj, const _Alloc& al)
+ * \brief Perform a stable MSD radix sort of strings at range [first, last).
+ *
+ * Elements are distributed by characters of projected string keys
+ * (257 buckets: end of string and 256 character values) starting 
+ * from the first character; every bucket is sorted by the next 
+ * character, small buckets are finished by insertion sort.
+ * Keys are ordered lexicographically by unsigned characters, 
+ * as std::string compares.
+ *
+ * \tparam _RanIt models random access iterator, value type must be
+ *                move constructible and move assignable
+ * \tparam _Proj  models projection unary function, returning string 
+ *                (size() and operator[]) or null-terminated const char*
+ * \tparam _Alloc models memory allocator
+ *
+ * \param first The start of the input sequence
+ * \param last  One past the end of the input sequence
+ * \param proj  projection function object
+ * \param al    Allocator used to allocate memory for internal needs
+ */
+template<class _RanIt, class _Proj, class _Alloc>
+void msd_radix_sort(_RanIt first, _RanIt last, _Proj proj, const _Alloc& al)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+
+	size_t n = std::distance(first, last);
+	if (n < 2)
+		return;
+
+	auto key_of = [&proj](const value_type& x) -> decltype(proj(x)) {
+		return proj(x);
+	};
+
+	detail::__radix_buffer<value_type, _Alloc> buffer(first, n, al);
+	if (!std::is_trivial<value_type>::value)
+		std::move(buffer.data(), buffer.data() + n, first);
+	detail::__msd_radix_sort(first, n, buffer.data(), 0, key_of);
+}
+
+/*!
+ * \fn msd_radix_sort(_RanIt first, _RanIt last, _Proj proj)
+ * \brief Perform a stable MSD radix sort at range [first, last) by projected string keys.
+ */
+template<class _RanIt, class _Proj>
+inline void msd_radix_sort(_RanIt first, _RanIt last, _Proj proj)
+{
+	msd_radix_sort(first, last, proj, std::allocator<char>());
+}
+
+/*!
+ * \fn msd_radix_sort(_RanIt first, _RanIt last)
+ * \brief Perform a stable MSD radix sort at range [first, last) of strings.
+ */
+template<class _RanIt>
+inline void msd_radix_sort(_RanIt first, _RanIt last)
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+	msd_radix_sort(first, last, stdx::identity<value_type>(), std::allocator<char>());
+}
+
+_STDX_END
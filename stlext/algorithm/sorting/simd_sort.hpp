@@ -0,0 +1,254 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+
+#include "../../platform/common.h"
+#include "../../platform/bits.h"
+#include "small_sort.hpp"
+
+_STDX_BEGIN
+
+namespace detail
+{
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+	/*
+	 * Permutations of 8 32-bit lanes moving lanes with clear mask 
+	 * bits to the front and lanes with set mask bits to the back 
+	 * (both in original order), packed into 8 bytes.
+	 */
+	struct __partition_lut
+	{
+		uint64_t perm[256];
+
+		__partition_lut() {
+			for (unsigned m = 0; m < 256; m++) {
+				uint64_t packed = 0;
+				unsigned k = 0;
+				for (unsigned i = 0; i < 8; i++) 
+					if (!(m & (1u << i))) 
+						packed |= uint64_t(i) << (8 * k++);
+				for (unsigned i = 0; i < 8; i++) 
+					if (m & (1u << i)) 
+						packed |= uint64_t(i) << (8 * k++);
+				perm[m] = packed;
+			}
+		}
+
+		__m256i operator[](unsigned m) const {
+			return _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(perm[m])));
+		}
+
+		static const __partition_lut& instance() {
+			static const __partition_lut lut;
+			return lut;
+		}
+	};
+
+	/*
+	 * Partition p[0, n), n >= 2 * lanes, around pivot: returns m such 
+	 * that p[0, m) are not greater (_Strict: less) than pivot and p[m, n)
+	 * are greater (_Strict: not less). 
+	 * 
+	 * First and last registers are put aside, so there is always room 
+	 * for a whole register on both ends: next register is loaded from 
+	 * the end with less room, its lanes are permuted by comparison mask
+	 * (smaller ones to the front) and stored to both ends in full, 
+	 * and the ends advance by the numbers of lanes that fall to them.
+	 */
+	template<class _Vec, bool _Strict, class _Tp>
+	size_t __simd_partition(_Tp* p, size_t n, _Tp pivot)
+	{
+		typedef typename _Vec::type vec_type;
+		const size_t w = _Vec::lanes;
+		const __partition_lut& lut = __partition_lut::instance();
+		const vec_type vpivot = _Vec::set1(pivot);
+
+		size_t rl = w, rr = n - w; // unread range
+		size_t wl = 0, wr = n;     // unwritten range
+
+		auto split = [&](vec_type v) {
+			unsigned mask = (_Strict ? _Vec::ge_mask(v, vpivot) : _Vec::gt_mask(v, vpivot));
+			size_t greater = static_cast<size_t>(__builtin_popcount(mask)) * w / 8;
+			vec_type s = _Vec::permute(v, lut[mask]);
+			_Vec::store(p + wl, s);
+			_Vec::store(p + wr - w, s);
+			wl += w - greater;
+			wr -= greater;
+		};
+
+		vec_type first = _Vec::load(p);
+		vec_type last = _Vec::load(p + n - w);
+
+		while (rr - rl >= w) {
+			vec_type v;
+			if (rl - wl <= wr - rr) {
+				v = _Vec::load(p + rl);
+				rl += w;
+			}
+			else {
+				rr -= w;
+				v = _Vec::load(p + rr);
+			}
+			split(v);
+		}
+
+		_Tp tail[_Vec::lanes];
+		size_t ntail = rr - rl;
+		std::copy(p + rl, p + rr, tail);
+		for (size_t i = 0; i < ntail; i++) {
+			if (_Strict ? tail[i] < pivot : !(pivot < tail[i]))
+				p[wl++] = tail[i];
+			else
+				p[--wr] = tail[i];
+		}
+
+		split(first);
+		split(last);
+		return wl;
+	}
+
+	template<class _Tp>
+	inline _Tp __median3(_Tp a, _Tp b, _Tp c) {
+		return (std::max)((std::min)(a, b), (std::min)((std::max)(a, b), c));
+	}
+
+	// introspective quicksort with vectorized partitioning and sorting networks for small ranges
+	template<class _Vec, class _Tp>
+	void __simd_quicksort(_Tp* p, size_t n, unsigned depth)
+	{
+		while (n > _SMALL_SORT_NETWORK_MAX) 
+		{
+			if (depth-- == 0) {
+				std::sort(p, p + n);
+				return;
+			}
+
+			_Tp pivot = __median3(__median3(p[0], p[n / 8], p[n / 4]),
+								  __median3(p[3 * n / 8], p[n / 2], p[5 * n / 8]),
+								  __median3(p[3 * n / 4], p[7 * n / 8], p[n - 1]));
+
+			size_t m = __simd_partition<_Vec, false>(p, n, pivot);
+			if (m == n) { 
+				// pivot is maximal: put keys equal to it aside
+				m = __simd_partition<_Vec, true>(p, n, pivot);
+				if (m == 0)
+					return; // all keys are equal
+				n = m;
+				continue;
+			}
+
+			if (m < n - m) {
+				__simd_quicksort<_Vec>(p, m, depth);
+				p += m;
+				n -= m;
+			}
+			else {
+				__simd_quicksort<_Vec>(p + m, n - m, depth);
+				n = m;
+			}
+		}
+		__small_sort_simd<_Vec>(p, n);
+	}
+
+	template<class _RanIt, class _Comp>
+	inline void __simd_sort(_RanIt first, _RanIt last, _Comp comp, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+		typedef typename __simd_sort_traits<value_type>::type vec_traits;
+
+		size_t n = last - first;
+		if (n < 2)
+			return;
+
+		value_type* p = &*first;
+		if (__has_nan(p, p + n, std::is_floating_point<value_type>())) {
+			std::sort(first, last, comp);
+			return;
+		}
+
+		unsigned depth = 0;
+		for (size_t k = n; k > 1; k >>= 1)
+			depth += 2;
+		__simd_quicksort<vec_traits>(p, n, depth);
+	}
+#endif
+
+	template<class _RanIt, class _Comp>
+	inline void __simd_sort(_RanIt first, _RanIt last, _Comp comp, std::false_type)
+	{
+		std::sort(first, last, comp);
+	}
+}
+
+/*!
+ * \fn simd_sort(_RanIt first, _RanIt last, _Comp comp)
+ * \brief Sort range [first, last) by quicksort with vectorized partitioning.
+ *
+ * Contiguous ranges of 32/64-bit signed integers, floats and doubles
+ * in ascending order are partitioned with AVX2 (comparison mask of 
+ * register selects permutation moving smaller lanes to the front, 
+ * result is stored to both ends of partition) and ranges of up to 
+ * 64 elements are finished by sorting networks (see small_sort). 
+ * Recursion depth is limited by 2 log(n), deeper ranges are sorted
+ * by std::sort. Ranges with NaNs and other types are sorted by std::sort.
+ *
+ * The sort is not stable.
+ *
+ * \tparam _RanIt models random access iterator
+ * \tparam _Comp  models strict weak ordering
+ *
+ * \param first The start of the input sequence
+ * \param last  One past the end of the input sequence
+ * \param comp  comparison function object
+ */
+template<class _RanIt, class _Comp>
+inline void simd_sort(_RanIt first, _RanIt last, _Comp comp)
+{
+	detail::__simd_sort(first, last, comp, std::integral_constant<bool, detail::__use_simd_sort<_RanIt, _Comp>::value>());
+}
+
+/*!
+ * \fn simd_sort(_RanIt first, _RanIt last)
+ * \brief Sort range [first, last) in ascending order by quicksort with vectorized partitioning.
+ */
+template<class _RanIt>
+inline void simd_sort(_RanIt first, _RanIt last)
+{
+	simd_sort(first, last, std::less<>());
+}
+
+_STDX_END
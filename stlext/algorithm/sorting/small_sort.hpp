@@ -0,0 +1,414 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#include "../../platform/common.h"
+#include "../../platform/bits.h"
+#include "../ext/kway_utility.hpp"
+#include "insertion_sort.hpp"
+
+/*
+ * Ranges up to this size are sorted by insertion sort
+ * when no vectorized kernel is available.
+ */
+#ifndef _SMALL_SORT_INSERTION_THRESHOLD
+#    define _SMALL_SORT_INSERTION_THRESHOLD 16
+#endif
+
+// the largest range sorted by single sorting network
+#define _SMALL_SORT_NETWORK_MAX 64
+
+_STDX_BEGIN
+
+namespace detail
+{
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+	/*
+	 * AVX2 register traits used by sorting networks and partitioning.
+	 * Masks returned by gt_mask/ge_mask have one bit per 32-bit half
+	 * of register (both halves are set for 64-bit lanes), so they can
+	 * index __partition_lut directly.
+	 */
+	struct __avx2_i32
+	{
+		typedef __m256i type;
+		static constexpr unsigned lanes = 8;
+
+		static type load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+		static void store(void* p, type v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+		static type set1(int32_t x) { return _mm256_set1_epi32(x); }
+		static type min(type a, type b) { return _mm256_min_epi32(a, b); }
+		static type max(type a, type b) { return _mm256_max_epi32(a, b); }
+		static type lt(type a, type b) { return _mm256_cmpgt_epi32(b, a); }
+		static type blend(type a, type b, type mask) { return _mm256_blendv_epi8(a, b, mask); }
+		static type bitxor(type a, type b) { return _mm256_xor_si256(a, b); }
+		static type permute(type v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+
+		static unsigned gt_mask(type v, type p) {
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, p))));
+		}
+		static unsigned ge_mask(type v, type p) {
+			return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(p, v)))) & 0xFF;
+		}
+
+		// lane i gets lane i ^ J
+		static type exchange(type v, std::integral_constant<unsigned, 1>) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)); }
+		static type exchange(type v, std::integral_constant<unsigned, 2>) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+		static type exchange(type v, std::integral_constant<unsigned, 4>) { return _mm256_permute2x128_si256(v, v, 1); }
+
+		// lane i is set if i & B
+		template<unsigned _B>
+		static type lane_mask() {
+			return _mm256_setr_epi32(-int((0 & _B) != 0), -int((1 & _B) != 0), -int((2 & _B) != 0), -int((3 & _B) != 0),
+									 -int((4 & _B) != 0), -int((5 & _B) != 0), -int((6 & _B) != 0), -int((7 & _B) != 0));
+		}
+	};
+
+	struct __avx2_f32
+	{
+		typedef __m256 type;
+		static constexpr unsigned lanes = 8;
+
+		static type load(const void* p) { return _mm256_loadu_ps(static_cast<const float*>(p)); }
+		static void store(void* p, type v) { _mm256_storeu_ps(static_cast<float*>(p), v); }
+		static type set1(float x) { return _mm256_set1_ps(x); }
+		static type min(type a, type b) { return _mm256_min_ps(a, b); }
+		static type max(type a, type b) { return _mm256_max_ps(a, b); }
+		static type lt(type a, type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static type blend(type a, type b, type mask) { return _mm256_blendv_ps(a, b, mask); }
+		static type bitxor(type a, type b) { return _mm256_xor_ps(a, b); }
+		static type permute(type v, __m256i idx) { return _mm256_permutevar8x32_ps(v, idx); }
+
+		static unsigned gt_mask(type v, type p) {
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, p, _CMP_GT_OQ)));
+		}
+		static unsigned ge_mask(type v, type p) {
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, p, _CMP_GE_OQ)));
+		}
+
+		static type exchange(type v, std::integral_constant<unsigned, 1>) { return _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1)); }
+		static type exchange(type v, std::integral_constant<unsigned, 2>) { return _mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+		static type exchange(type v, std::integral_constant<unsigned, 4>) { return _mm256_permute2f128_ps(v, v, 1); }
+
+		template<unsigned _B>
+		static type lane_mask() { 
+			return _mm256_castsi256_ps(__avx2_i32::lane_mask<_B>()); 
+		}
+	};
+
+	struct __avx2_i64
+	{
+		typedef __m256i type;
+		static constexpr unsigned lanes = 4;
+
+		static type load(const void* p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+		static void store(void* p, type v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+		static type set1(int64_t x) { return _mm256_set1_epi64x(x); }
+		static type min(type a, type b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+		static type max(type a, type b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+		static type lt(type a, type b) { return _mm256_cmpgt_epi64(b, a); }
+		static type blend(type a, type b, type mask) { return _mm256_blendv_epi8(a, b, mask); }
+		static type bitxor(type a, type b) { return _mm256_xor_si256(a, b); }
+		static type permute(type v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+
+		static unsigned gt_mask(type v, type p) {
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi64(v, p))));
+		}
+		static unsigned ge_mask(type v, type p) {
+			return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi64(p, v)))) & 0xFF;
+		}
+
+		static type exchange(type v, std::integral_constant<unsigned, 1>) { return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+		static type exchange(type v, std::integral_constant<unsigned, 2>) { return _mm256_permute2x128_si256(v, v, 1); }
+
+		template<unsigned _B>
+		static type lane_mask() {
+			return _mm256_setr_epi64x(-int64_t((0 & _B) != 0), -int64_t((1 & _B) != 0), 
+									  -int64_t((2 & _B) != 0), -int64_t((3 & _B) != 0));
+		}
+	};
+
+	struct __avx2_f64
+	{
+		typedef __m256d type;
+		static constexpr unsigned lanes = 4;
+
+		static type load(const void* p) { return _mm256_loadu_pd(static_cast<const double*>(p)); }
+		static void store(void* p, type v) { _mm256_storeu_pd(static_cast<double*>(p), v); }
+		static type set1(double x) { return _mm256_set1_pd(x); }
+		static type min(type a, type b) { return _mm256_min_pd(a, b); }
+		static type max(type a, type b) { return _mm256_max_pd(a, b); }
+		static type lt(type a, type b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+		static type blend(type a, type b, type mask) { return _mm256_blendv_pd(a, b, mask); }
+		static type bitxor(type a, type b) { return _mm256_xor_pd(a, b); }
+		static type permute(type v, __m256i idx) { 
+			return _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), idx)); 
+		}
+
+		static unsigned gt_mask(type v, type p) {
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castpd_ps(_mm256_cmp_pd(v, p, _CMP_GT_OQ))));
+		}
+		static unsigned ge_mask(type v, type p) {
+			return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castpd_ps(_mm256_cmp_pd(v, p, _CMP_GE_OQ))));
+		}
+
+		static type exchange(type v, std::integral_constant<unsigned, 1>) { return _mm256_permute_pd(v, 0x5); }
+		static type exchange(type v, std::integral_constant<unsigned, 2>) { return _mm256_permute2f128_pd(v, v, 1); }
+
+		template<unsigned _B>
+		static type lane_mask() {
+			return _mm256_castsi256_pd(__avx2_i64::lane_mask<_B>());
+		}
+	};
+
+	// register traits for value type (void if there are none)
+	template<class _Tp>
+	struct __simd_sort_traits {
+		typedef typename std::conditional<std::is_same<_Tp, float>::value, __avx2_f32,
+				typename std::conditional<std::is_same<_Tp, double>::value, __avx2_f64,
+				typename std::conditional<std::is_integral<_Tp>::value && std::is_signed<_Tp>::value && sizeof(_Tp) == 4, __avx2_i32,
+				typename std::conditional<std::is_integral<_Tp>::value && std::is_signed<_Tp>::value && sizeof(_Tp) == 8, __avx2_i64,
+				void>::type>::type>::type>::type type;
+	};
+
+	/*
+	 * Bitonic sorting network over _Regs registers: element i is 
+	 * lane i % lanes of register i / lanes. Stage (K, J) compares
+	 * elements i and i ^ J, block i & K sorted in descending order.
+	 * Compare-exchanges of elements in different registers blend
+	 * whole registers by one less-than mask, of elements in the same
+	 * register are min/max with lane-exchanged copy blended by 
+	 * constant mask (both lanes of a pair see the same tie-break).
+	 */
+	template<class _Vec, unsigned _Regs, unsigned _K, unsigned _J, bool = (_J >= _Vec::lanes)>
+	struct __bitonic_stage 
+	{
+		static void apply(typename _Vec::type* r) 
+		{
+			const unsigned rj = _J / _Vec::lanes;
+			for (unsigned a = 0; a < _Regs; a++) {
+				if (a & rj) 
+					continue;
+				// min/max return second operand on ties, which would 
+				// duplicate one of -0.0 and +0.0: swap by a single mask
+				auto swap = _Vec::lt(r[a | rj], r[a]);
+				auto lo = _Vec::blend(r[a], r[a | rj], swap);
+				auto hi = _Vec::blend(r[a | rj], r[a], swap);
+				bool desc = ((a * _Vec::lanes) & _K) != 0;
+				r[a] = desc ? hi : lo;
+				r[a | rj] = desc ? lo : hi;
+			}
+		}
+	};
+
+	template<class _Vec, unsigned _Regs, unsigned _K, unsigned _J>
+	struct __bitonic_stage<_Vec, _Regs, _K, _J, false>
+	{
+		static void apply(typename _Vec::type* r) 
+		{
+			// lane takes maximum if it is upper one of a pair in ascending block
+			auto mask = _Vec::bitxor(_Vec::template lane_mask<_J>(), _Vec::template lane_mask<_K>());
+			for (unsigned a = 0; a < _Regs; a++) {
+				auto x = _Vec::exchange(r[a], std::integral_constant<unsigned, _J>());
+				auto lo = _Vec::min(r[a], x);
+				auto hi = _Vec::max(r[a], x);
+				bool desc = ((a * _Vec::lanes) & _K) != 0;
+				r[a] = desc ? _Vec::blend(hi, lo, mask) : _Vec::blend(lo, hi, mask);
+			}
+		}
+	};
+
+	template<class _Vec, unsigned _Regs, unsigned _K = 2, unsigned _J = 1, bool = (_K > _Regs * _Vec::lanes)>
+	struct __bitonic_network
+	{
+		static void apply(typename _Vec::type* r) {
+			__bitonic_stage<_Vec, _Regs, _K, _J>::apply(r);
+			__bitonic_network<_Vec, _Regs, (_J == 1 ? 2 * _K : _K), (_J == 1 ? _K : _J / 2)>::apply(r);
+		}
+	};
+
+	template<class _Vec, unsigned _Regs, unsigned _K, unsigned _J>
+	struct __bitonic_network<_Vec, _Regs, _K, _J, true>
+	{
+		static void apply(typename _Vec::type*) {}
+	};
+
+	// sort n <= _Regs * lanes values with single network, padding them by maximal value
+	template<class _Vec, unsigned _Regs, class _Tp>
+	void __bitonic_sort(_Tp* p, size_t n)
+	{
+		const size_t size = _Regs * _Vec::lanes;
+		typename _Vec::type r[_Regs];
+
+		if (n == size) {
+			for (unsigned a = 0; a < _Regs; a++)
+				r[a] = _Vec::load(p + a * _Vec::lanes);
+			__bitonic_network<_Vec, _Regs>::apply(r);
+			for (unsigned a = 0; a < _Regs; a++)
+				_Vec::store(p + a * _Vec::lanes, r[a]);
+			return;
+		}
+
+		_Tp buf[size];
+		std::memcpy(buf, p, n * sizeof(_Tp));
+		std::fill(buf + n, buf + size, (std::numeric_limits<_Tp>::has_infinity ? 
+										std::numeric_limits<_Tp>::infinity() : 
+										(std::numeric_limits<_Tp>::max)()));
+		for (unsigned a = 0; a < _Regs; a++)
+			r[a] = _Vec::load(buf + a * _Vec::lanes);
+		__bitonic_network<_Vec, _Regs>::apply(r);
+		for (unsigned a = 0; a < _Regs; a++)
+			_Vec::store(buf + a * _Vec::lanes, r[a]);
+		std::memcpy(p, buf, n * sizeof(_Tp));
+	}
+
+	// sort n <= _SMALL_SORT_NETWORK_MAX values with the narrowest network
+	template<class _Vec, class _Tp>
+	void __small_sort_simd(_Tp* p, size_t n)
+	{
+		const size_t w = _Vec::lanes;
+		if (n < 2)
+			return;
+		if (n <= w)
+			__bitonic_sort<_Vec, 1>(p, n);
+		else if (n <= 2 * w)
+			__bitonic_sort<_Vec, 2>(p, n);
+		else if (n <= 4 * w)
+			__bitonic_sort<_Vec, 4>(p, n);
+		else if (n <= 8 * w)
+			__bitonic_sort<_Vec, 8>(p, n);
+		else
+			__bitonic_sort<_Vec, (_SMALL_SORT_NETWORK_MAX / _Vec::lanes > 8 ? _SMALL_SORT_NETWORK_MAX / _Vec::lanes : 8)>(p, n);
+	}
+#else
+	template<class _Tp>
+	struct __simd_sort_traits {
+		typedef void type;
+	};
+#endif
+
+	// floating point range has NaN (networks and partitioning expect total order)
+	template<class _Tp>
+	inline bool __has_nan(const _Tp* first, const _Tp* last, std::true_type) {
+		return std::any_of(first, last, [](_Tp x) { return std::isnan(x); });
+	}
+
+	template<class _Tp>
+	inline bool __has_nan(const _Tp*, const _Tp*, std::false_type) {
+		return false;
+	}
+
+	// vectorized kernels apply: contiguous values with register traits in ascending order
+	template<class _RanIt, class _Comp>
+	struct __use_simd_sort 
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+		static constexpr bool value = 
+			!std::is_void<typename __simd_sort_traits<value_type>::type>::value &&
+			utility::__is_contiguous_iterator<_RanIt>::value &&
+			utility::__is_natural_order<_Comp, value_type>::value;
+	};
+
+	template<class _RanIt, class _Comp>
+	inline void __small_sort(_RanIt first, _RanIt last, _Comp comp, std::false_type)
+	{
+		if (last - first <= _SMALL_SORT_INSERTION_THRESHOLD)
+			insertion_sort(first, last, comp);
+		else
+			std::sort(first, last, comp);
+	}
+
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__AVX2__)
+	template<class _RanIt, class _Comp>
+	inline void __small_sort(_RanIt first, _RanIt last, _Comp comp, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+		typedef typename __simd_sort_traits<value_type>::type vec_traits;
+
+		size_t n = last - first;
+		if (n < 2)
+			return;
+
+		value_type* p = &*first;
+		if (n > _SMALL_SORT_NETWORK_MAX || __has_nan(p, p + n, std::is_floating_point<value_type>()))
+			std::sort(first, last, comp);
+		else
+			__small_sort_simd<vec_traits>(p, n);
+	}
+#endif
+}
+
+/*!
+ * \fn small_sort(_RanIt first, _RanIt last, _Comp comp)
+ * \brief Sort short range [first, last).
+ *
+ * Contiguous ranges of 32/64-bit signed integers, floats and doubles 
+ * in ascending order of up to 64 elements are sorted by AVX2 bitonic 
+ * sorting networks (8, 16, 32 or 64 elements: a range is padded by 
+ * maximal value up to network size). Ranges with NaNs, longer ranges 
+ * and other types are sorted by insertion sort (up to 
+ * _SMALL_SORT_INSERTION_THRESHOLD elements) or by std::sort.
+ *
+ * The sort is not stable.
+ *
+ * \tparam _RanIt models random access iterator
+ * \tparam _Comp  models strict weak ordering
+ *
+ * \param first The start of the input sequence
+ * \param last  One past the end of the input sequence
+ * \param comp  comparison function object
+ */
+template<class _RanIt, class _Comp>
+inline void small_sort(_RanIt first, _RanIt last, _Comp comp)
+{
+	detail::__small_sort(first, last, comp, std::integral_constant<bool, detail::__use_simd_sort<_RanIt, _Comp>::value>());
+}
+
+/*!
+ * \fn small_sort(_RanIt first, _RanIt last)
+ * \brief Sort short range [first, last) in ascending order.
+ */
+template<class _RanIt>
+inline void small_sort(_RanIt first, _RanIt last)
+{
+	small_sort(first, last, std::less<>());
+}
+
+_STDX_END
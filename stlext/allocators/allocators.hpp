@@ -34,8 +34,12 @@
 #include "heap_arena.hpp"
 #include "ordered_arena.hpp"
 #include "fallback_arena.hpp"
+#include "concurrent_freelist.hpp"
+#include "lockfree_pool.hpp"
 #include "binexp_arena.hpp"
 #include "bitmap_arena.hpp"
+#include "slab_arena.hpp"
+#include "stats_arena.hpp"
 
 _STDX_BEGIN
 
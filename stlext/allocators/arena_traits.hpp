@@ -38,7 +38,7 @@ _STDX_BEGIN
 template<typename _Arena>
 struct arena_traits
 {
-	typedef typename _Arena arena_type;
+	typedef _Arena arena_type;
 	typedef typename _Arena::base_type base_type;
 	typedef typename _Arena::mutex_type mutex_type;
 	typedef typename _Arena::deleter_type deleter_type;
@@ -80,7 +80,7 @@ struct arena_traits
 	}
 
 	static inline void* reallocate(intrusive_ptr<_Arena>& __a, size_t __nbytes, void* __hint) {
-		return __a->reallocate(a, __nbytes, __hint);
+		return __a->reallocate(__nbytes, __hint);
 	}
 
 	static inline void* deallocate(intrusive_ptr<_Arena>& __a, void* __addr, size_t __nbytes) {
@@ -43,7 +43,8 @@ template<
 	typename _Arena, 
 	size_t _MaxSize = 0, 
 	typename _Mutex = void,
-	typename _Destroyer = empty_delete<>
+	typename _Destroyer = empty_delete<>,
+	template<size_t> class _FreeList = freelist
 >
 class binexp_arena :
 	public basic_arena<_Mutex, _Destroyer, false>
@@ -58,14 +59,14 @@ public:
 	static const size_t BINCOUNT = (sizeof(void*) * CHAR_BIT - 1);
 	static const size_t MAX_FREELIST_SIZE = _MaxSize;
 
-	typedef freelist<_MaxSize> freelist_type;
+	typedef _FreeList<_MaxSize> freelist_type;
 
 	binexp_arena() {
-		__init_from(arena_traits<_Arena>::global(), __m_target);
+		this->__init_from(arena_traits<_Arena>::global(), __m_target);
 	}
 
-	binexp_arena(const _Arena& __a) : 
-		__init_from(__a, __m_target) {
+	binexp_arena(const _Arena& __a) {
+		this->__init_from(__a, __m_target);
 	}
 
 	~binexp_arena() {
@@ -0,0 +1,191 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include "../platform/common.h"
+
+_STDX_BEGIN
+
+namespace detail {
+
+/*!
+Head of Treiber stack packing pointer with modification tag into single
+64-bit word to protect stack from ABA problem. On 64-bit platforms upper
+16 bits of user-space pointer are unused and hold the tag, on 32-bit
+platforms pointer and tag share the word equally.
+*/
+template<typename _Node>
+class tagged_head
+{
+	static const unsigned TAG_SHIFT = (sizeof(void*) == 8 ? 48 : 32);
+	static const uint64_t PTR_MASK = ((uint64_t(1) << TAG_SHIFT) - 1);
+
+public:
+	tagged_head() : __m_value(0) {
+	}
+
+	inline void push(_Node* __p)
+	{
+		uint64_t old = __m_value.load(std::memory_order_relaxed);
+		uint64_t val;
+		do {
+			__p->next.store(__pointer(old), std::memory_order_relaxed);
+			val = __pack(__p, old);
+		} while (!__m_value.compare_exchange_weak(old, val, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	inline _Node* pop()
+	{
+		uint64_t old = __m_value.load(std::memory_order_acquire);
+		_Node* p;
+		do {
+			if ((p = __pointer(old)) == nullptr)
+				break;
+		} while (!__m_value.compare_exchange_weak(old, __pack(p->next.load(std::memory_order_relaxed), old),
+												 std::memory_order_acq_rel, std::memory_order_acquire));
+		return p;
+	}
+
+	inline bool empty() const {
+		return (__pointer(__m_value.load(std::memory_order_relaxed)) == nullptr);
+	}
+
+private:
+	static inline _Node* __pointer(uint64_t __value) {
+		return reinterpret_cast<_Node*>(static_cast<uintptr_t>(__value & PTR_MASK));
+	}
+
+	static inline uint64_t __pack(_Node* __p, uint64_t __prev) {
+		return ((((__prev >> TAG_SHIFT) + 1) << TAG_SHIFT) | static_cast<uint64_t>(reinterpret_cast<uintptr_t>(__p)));
+	}
+
+private:
+	std::atomic<uint64_t> __m_value;
+};
+
+} // end namespace detail
+
+
+
+/*!
+Thread-safe free list for multiple producers and multiple consumers.
+Implemented as lock-free Treiber stack with tagged head pointer.
+Free list with non-zero _MaxSize keeps no more than _MaxSize blocks.
+Interface is the same as of freelist<_MaxSize>, so it can be used as
+free list of binexp_arena and pooled_object.
+
+Note that pop() may read link of the block concurrently taken by other
+thread, so blocks must not be returned to the operating system while
+free list is in use.
+*/
+template<size_t _MaxSize = 0>
+class concurrent_freelist
+{
+	__disable_copy(concurrent_freelist)
+public:
+	static const bool concurrent = true;
+
+	concurrent_freelist() : 
+		__m_nblocks(0) 
+	{	// construct with empty list
+	}
+
+	bool push(void *__p)
+	{	// push onto free list depending on max
+		if (__m_nblocks.fetch_add(1, std::memory_order_relaxed) >= _MaxSize) {
+			__m_nblocks.fetch_sub(1, std::memory_order_relaxed);
+			return (false);
+		}
+		__m_head.push(::new(__p) node);
+		return (true);
+	}
+
+	void *pop()
+	{	// pop node from free list
+		node* ptr = __m_head.pop();
+		if (ptr != nullptr)
+			__m_nblocks.fetch_sub(1, std::memory_order_relaxed);
+		return (ptr);
+	}
+
+	inline bool empty() const {
+		return __m_head.empty();
+	}
+
+private:
+	struct node
+	{	// list node
+		std::atomic<node*> next;
+	};
+	detail::tagged_head<node> __m_head;
+	std::atomic<size_t> __m_nblocks;
+};
+
+
+
+template<>
+class concurrent_freelist<0>
+{
+	__disable_copy(concurrent_freelist)
+public:
+	static const bool concurrent = true;
+
+	concurrent_freelist()
+	{	// construct with empty list
+	}
+
+	bool push(void *__p)
+	{	// push onto free list
+		__m_head.push(::new(__p) node);
+		return true;
+	}
+
+	void *pop()
+	{	// pop node from free list
+		return __m_head.pop();
+	}
+
+	inline bool empty() const {
+		return __m_head.empty();
+	}
+
+private:
+	struct node
+	{	// list node
+		std::atomic<node*> next;
+	};
+	detail::tagged_head<node> __m_head;
+};
+
+
+_STDX_END
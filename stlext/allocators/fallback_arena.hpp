@@ -49,13 +49,13 @@ class fallback_arena :
 
 public:
 	fallback_arena() {
-		__init_from(arena_traits<_Arena>::global(), __m_target);
-		__init_from(arena_traits<_Fallback>::global(), __m_fallback);
+		this->__init_from(arena_traits<_Arena>::global(), __m_target);
+		this->__init_from(arena_traits<_Fallback>::global(), __m_fallback);
 	}
 
 	fallback_arena(const _Arena& __target, const _Fallback& __fallback) {
-		__init_from(__target, __m_target);
-		__init_from(__fallback, __m_fallback);
+		this->__init_from(__target, __m_target);
+		this->__init_from(__fallback, __m_fallback);
 	}
 
 
@@ -38,6 +38,8 @@ template<size_t _MaxSize = 0>
 class freelist
 {
 public:
+	static const bool concurrent = false;
+
 	freelist()
 		: __m_head(0), __m_nblocks(0)
 	{	// construct with empty list
@@ -101,6 +103,8 @@ template<>
 class freelist<0>
 {
 public:
+	static const bool concurrent = false;
+
 	freelist()
 		: __m_head(0)
 	{	// construct with empty list
@@ -29,8 +29,14 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
+#include <new>
+#include <cstdlib>
 #include "basic_arena.hpp"
 
+#ifndef STDX_CMPLR_MSVC
+#include <malloc.h>
+#endif
+
 
 _STDX_BEGIN
 
@@ -102,12 +108,12 @@ template<
 class aligned_arena :
 	public basic_arena<_Mutex, void, true>
 {
-protected:
+public:
 	void* allocate(size_t __nbytes) {
 #ifdef STDX_CMPLR_MSVC
 		return ::_aligned_malloc(__nbytes, _Align);
 #else
-		return ::memalign(__nbytes, _Align);
+		return ::memalign(_Align, __nbytes);
 #endif
 	}
 
@@ -121,9 +127,9 @@ protected:
 
 	void* deallocate(void* __addr, size_t) {
 #ifdef STDX_CMPLR_MSVC
-		return ::_aligned_free(__addr, _Align);
+		::_aligned_free(__addr);
 #else
-		return ::free(__addr);
+		::free(__addr);
 #endif
 		return nullptr;
 	}
@@ -29,6 +29,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
+#include <cassert>
 #include <cstdint>
 #include <atomic>
 #include <memory>
@@ -207,7 +208,7 @@ public:
 	*/
 	inline size_t use_count() const
 	{
-		return (typename _ThreadPolicy::load(m_ref_counter));
+		return (_ThreadPolicy::load(m_ref_counter));
 	}
 
 	/*!
@@ -215,7 +216,7 @@ public:
 	*/
 	inline bool unique() const
 	{
-		return (typename _ThreadPolicy::load(m_ref_counter) == 1);
+		return (_ThreadPolicy::load(m_ref_counter) == 1);
 	}
 
 	static _Destroyer get_deleter() { return _Destroyer(); }
@@ -237,15 +238,15 @@ public:
 template<typename _Type, typename _ThreadPolicy, typename _Destroyer>
 void intrusive_ptr_acqure(const intrusive_ref_counter<_Type, _ThreadPolicy, _Destroyer>* p)
 {
-	typename _ThreadPolicy::increment(p->m_ref_counter);
+	_ThreadPolicy::increment(p->m_ref_counter);
 }
 
 template<typename _Type, typename _ThreadPolicy, typename _Destroyer>
 void intrusive_ptr_release(const intrusive_ref_counter<_Type, _ThreadPolicy, _Destroyer>* p)
 {
 	typedef intrusive_ref_counter<_Type, _ThreadPolicy, _Destroyer> type;
-	if (typename _ThreadPolicy::decrement(p->m_ref_counter) == 0)
-		typename type::get_deleter()(const_cast<_Type*>(static_cast< const _Type* >(p)));
+	if (_ThreadPolicy::decrement(p->m_ref_counter) == 0)
+		type::get_deleter()(const_cast<_Type*>(static_cast< const _Type* >(p)));
 }
 
 
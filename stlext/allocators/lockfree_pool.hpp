@@ -0,0 +1,158 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include "../platform/common.h"
+
+_STDX_BEGIN
+
+/*!
+Lock-free fixed-capacity pool of objects of type T.
+
+Pool owns storage for _Capacity objects, free slots are linked into
+Treiber stack by 32-bit indices, the head of stack carries 32-bit
+modification tag, so pool is ABA-safe. Storage is never released
+while pool is alive, so blocks may be allocated on one thread and
+released on another without any restrictions.
+*/
+template<
+	typename T,
+	size_t _Capacity
+>
+class lockfree_pool
+{
+	__disable_copy(lockfree_pool)
+	static_assert(_Capacity > 0 && _Capacity < UINT32_MAX, "incorrect pool capacity");
+
+	typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type slot_type;
+
+	static const uint32_t NIL = UINT32_MAX;
+
+public:
+	typedef T value_type;
+	typedef T* pointer;
+
+	static const size_t CAPACITY = _Capacity;
+
+	lockfree_pool()
+	{
+		for (size_t i = 0; i < CAPACITY; i++)
+			__m_next[i].store(static_cast<uint32_t>(i + 1 < CAPACITY ? i + 1 : NIL), std::memory_order_relaxed);
+		__m_head.store(__pack(0, 0), std::memory_order_release);
+	}
+
+	/*!
+	acquire uninitialized storage for one object, return nullptr if pool is exhausted
+	*/
+	pointer allocate()
+	{
+		uint64_t old = __m_head.load(std::memory_order_acquire);
+		uint32_t idx;
+		do {
+			if ((idx = __index(old)) == NIL)
+				return nullptr;
+		} while (!__m_head.compare_exchange_weak(old, __pack(__m_next[idx].load(std::memory_order_relaxed), __tag(old) + 1),
+												std::memory_order_acq_rel, std::memory_order_acquire));
+		return reinterpret_cast<pointer>(__m_slots + idx);
+	}
+
+	/*!
+	return storage acquired by allocate() back to pool
+	*/
+	void deallocate(pointer __p)
+	{
+		uint32_t idx = static_cast<uint32_t>(reinterpret_cast<slot_type*>(__p) - __m_slots);
+		uint64_t old = __m_head.load(std::memory_order_relaxed);
+		do {
+			__m_next[idx].store(__index(old), std::memory_order_relaxed);
+		} while (!__m_head.compare_exchange_weak(old, __pack(idx, __tag(old) + 1),
+												std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	template<typename... _Args>
+	pointer construct(_Args&&... __args)
+	{
+		pointer p = allocate();
+		if (p == nullptr)
+			return nullptr;
+		try {
+			::new(static_cast<void*>(p)) T(std::forward<_Args>(__args)...);
+		}
+		catch (...) {
+			deallocate(p);
+			throw;
+		}
+		return p;
+	}
+
+	void destroy(pointer __p)
+	{
+		__p->~T();
+		deallocate(__p);
+	}
+
+	// check if __p points into pool storage
+	inline bool contains(const void* __p) const {
+		return (__p >= static_cast<const void*>(__m_slots) && __p < static_cast<const void*>(__m_slots + CAPACITY));
+	}
+
+	inline bool empty() const {
+		return (__index(__m_head.load(std::memory_order_relaxed)) == NIL);
+	}
+
+	inline size_t capacity() const {
+		return CAPACITY;
+	}
+
+private:
+	static inline uint32_t __index(uint64_t __value) {
+		return static_cast<uint32_t>(__value);
+	}
+
+	static inline uint32_t __tag(uint64_t __value) {
+		return static_cast<uint32_t>(__value >> 32);
+	}
+
+	static inline uint64_t __pack(uint32_t __idx, uint32_t __tag) {
+		return ((static_cast<uint64_t>(__tag) << 32) | __idx);
+	}
+
+private:
+	std::atomic<uint64_t> __m_head;
+	std::atomic<uint32_t> __m_next[CAPACITY];
+	slot_type __m_slots[CAPACITY];
+};
+
+_STDX_END
@@ -30,6 +30,7 @@
 
 #pragma once
 #include <memory>
+#include <type_traits>
 #include "freelist.hpp"
 
 _STDX_BEGIN
@@ -37,39 +38,54 @@ _STDX_BEGIN
 template<
 	typename T,
 	typename _Allocator = std::allocator<T>,
-	size_t _MaxCacheSize = 0
+	size_t _MaxCacheSize = 0,
+	template<size_t> class _FreeList = freelist
 >
 class pooled_object
 {
+	typedef _FreeList<_MaxCacheSize> freelist_type;
+	typedef typename std::allocator_traits<_Allocator>::template rebind_alloc<char> allocator_type;
 public:
 
 	inline void* operator new(size_t __nbytes)
 	{
 		void* result = nullptr;
 		if ((__nbytes - sizeof(T)) == 0) {
-			return (((result = __s_free.pop()) == nullptr) ?
-				__s_alloc.allocate(__nbytes) : result);
+			return (((result = __free_list().pop()) == nullptr) ?
+				static_cast<void*>(__s_alloc.allocate(__nbytes)) : result);
 		}
 		return __s_alloc.allocate(__nbytes);
 	}
 
 	inline void operator delete(void* __addr, size_t __nbytes) {
-		(__nbytes == sizeof(T) ?
-			__s_free.push(__addr) : 
-			__s_alloc.deallocate((point*)__addr, __nbytes));
+		if (__nbytes != sizeof(T) || !__free_list().push(__addr))
+			__s_alloc.deallocate(static_cast<char*>(__addr), __nbytes);
 	}
 
 private:
-	static __THREADLOCAL _Allocator __s_alloc;
-	static __THREADLOCAL freelist<_MaxCacheSize> __s_free;
+	// thread unsafe free list is kept per thread, 
+	// concurrent free list is shared by all threads
+	static inline freelist_type& __free_list() {
+		return __free_list(std::integral_constant<bool, freelist_type::concurrent>());
+	}
 
-};
+	static inline freelist_type& __free_list(std::false_type) {
+		static __THREADLOCAL freelist_type __s_free;
+		return __s_free;
+	}
 
-template<typename T, typename _Allocator, size_t _MaxCacheSize>
-__THREADLOCAL _Allocator pooled_object<T, _Allocator, _MaxCacheSize>::__s_alloc;
+	static inline freelist_type& __free_list(std::true_type) {
+		static freelist_type __s_free;
+		return __s_free;
+	}
+
+private:
+	static __THREADLOCAL allocator_type __s_alloc;
+};
 
-template<typename T, typename _Allocator, size_t _MaxCacheSize>
-__THREADLOCAL freelist<_MaxCacheSize> pooled_object<T, _Allocator, _MaxCacheSize>::__s_free;
+template<typename T, typename _Allocator, size_t _MaxCacheSize, template<size_t> class _FreeList>
+__THREADLOCAL typename pooled_object<T, _Allocator, _MaxCacheSize, _FreeList>::allocator_type
+pooled_object<T, _Allocator, _MaxCacheSize, _FreeList>::__s_alloc;
 
 
 _STDX_END
@@ -0,0 +1,344 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include "basic_arena.hpp"
+#include "arena_traits.hpp"
+#include "heap_arena.hpp"
+
+#include "../platform/bits.h"
+#include "../mathext/static_log2.hpp"
+
+_STDX_BEGIN
+
+/*!
+Size-class slab arena for small objects.
+
+Requests up to _MaxSize bytes are rounded up to one of fine-grained
+size classes: multiples of 8 bytes up to 64 bytes, then 8 classes
+per power of two, so internal fragmentation of objects larger
+than 64 bytes never exceeds 12.5%.
+Each size class allocates objects from _SlabSize slabs obtained from
+upstream arena. The slab header with free bitmap is embedded at the
+beginning of slab, and slab is aligned to _SlabSize, so slab of an
+object is found by masking it's address. Slab that became empty is
+returned to upstream arena unless it is the last partially used slab
+of it's class. Larger requests are forwarded to upstream arena.
+
+Upstream arena is expected to return _SlabSize aligned blocks (i.e.
+aligned_arena<_SlabSize>, the default), otherwise slab is carved 
+from a block of twice larger size.
+*/
+template<
+	typename _Arena = aligned_arena<4096>,
+	size_t _SlabSize = 4096,
+	size_t _MaxSize = (_SlabSize / 8),
+	typename _Mutex = void,
+	typename _Destroyer = empty_delete<>
+>
+class slab_arena :
+	public basic_arena<_Mutex, _Destroyer, false>
+{
+	__disable_copy(slab_arena)
+	typedef arena_traits<_Arena> traits_type;
+	typedef typename traits_type::member_type arena_t;
+
+	typedef uint64_t word_type;
+
+	static const size_t BITSPERWORD = sizeof(word_type) * CHAR_BIT;
+	static const size_t BITS_PER_SIZE_T = sizeof(size_t) * CHAR_BIT;
+
+public:
+	// size class granularity in bytes
+	static const size_t QUANTUM = 8;
+
+	// log2 of number of size classes per power of two
+	static const size_t LG_GROUP = 3;
+
+	// size of slab in bytes
+	static const size_t SLABSIZE = _SlabSize;
+
+	// maximum size of object served from slabs
+	static const size_t MAXSIZE = _MaxSize;
+
+private:
+	static const size_t GROUP = (size_t(1) << LG_GROUP);
+	static const size_t LG_LINEAR = 6; // log2(QUANTUM * GROUP)
+	static const size_t BITMAPSIZE = (SLABSIZE / QUANTUM + BITSPERWORD - 1) / BITSPERWORD;
+
+	struct slab
+	{
+		slab* prev;
+		slab* next;
+		void* origin;        // block returned by upstream arena
+		size_t span;         // size of upstream block
+		uint32_t sclass;     // size class index
+		uint32_t nfree;      // number of free objects
+		uint32_t hint;       // lowest bitmap word that may contain free bit
+		uint32_t capacity;   // total number of objects
+		word_type bitmap[BITMAPSIZE]; // 1 - free, 0 - used
+	};
+
+	struct slab_list
+	{
+		slab* partial; // slabs with free objects
+		slab* full;    // completely used slabs
+	};
+
+	// offset of first object in slab
+	static const size_t HEADERSIZE = (sizeof(slab) + 15) & ~size_t(15);
+
+	static_assert(SLABSIZE && !(SLABSIZE & (SLABSIZE - 1)), "slab size must be a power of two");
+	static_assert(MAXSIZE > QUANTUM * GROUP && !(MAXSIZE & (MAXSIZE - 1)), "maximum object size must be a power of two greater than 64");
+	static_assert(MAXSIZE <= (SLABSIZE - HEADERSIZE) / 2, "slab must hold at least two objects of maximum size");
+
+public:
+	// class index for size with value __nbytes (0 < __nbytes <= MAXSIZE)
+	static inline size_t size_class(size_t __nbytes)
+	{
+		if (__nbytes <= QUANTUM * GROUP)
+			return (__nbytes + QUANTUM - 1) / QUANTUM - 1;
+
+		size_t lg = BITS_PER_SIZE_T - 1 - stdx::__clz(__nbytes - 1);
+		size_t shift = lg - LG_GROUP;
+		size_t idx = ((__nbytes - (size_t(1) << lg)) + (size_t(1) << shift) - 1) >> shift;
+		return GROUP + (lg - LG_LINEAR) * GROUP + idx - 1;
+	}
+
+	// object size of size class __sclass
+	static inline size_t class_size(size_t __sclass)
+	{
+		if (__sclass < GROUP)
+			return (__sclass + 1) * QUANTUM;
+
+		size_t lg = LG_LINEAR + (__sclass - GROUP) / GROUP;
+		size_t idx = (__sclass - GROUP) % GROUP + 1;
+		return (size_t(1) << lg) + (idx << (lg - LG_GROUP));
+	}
+
+	// total number of size classes
+	static const size_t CLASSCOUNT = GROUP + (static_log2<MAXSIZE>::value - LG_LINEAR) * GROUP;
+
+	slab_arena() {
+		this->__init_from(traits_type::global(), __m_target);
+		__construct();
+	}
+
+	slab_arena(const _Arena& __a) {
+		this->__init_from(__a, __m_target);
+		__construct();
+	}
+
+	~slab_arena() {
+		__dispose();
+	}
+
+	void* allocate(size_t __nbytes)
+	{
+		if (__nbytes == 0)
+			return nullptr;
+
+		if (__nbytes > MAXSIZE)
+			return traits_type::allocate(__m_target, __nbytes);
+
+		size_t sclass = size_class(__nbytes);
+		slab_list& lst = __m_classes[sclass];
+		slab* s = lst.partial;
+		if (s == nullptr) {
+			if ((s = __new_slab(sclass)) == nullptr)
+				return nullptr;
+			__link(lst.partial, s);
+		}
+
+		size_t pos = __take(s);
+		if (s->nfree == 0) { // move to full slabs
+			__unlink(lst.partial, s);
+			__link(lst.full, s);
+		}
+		return (reinterpret_cast<char*>(s) + HEADERSIZE + pos * class_size(sclass));
+	}
+
+	void* reallocate(size_t __nbytes, void*) {
+		return allocate(__nbytes);
+	}
+
+	void* deallocate(void* __addr, size_t __nbytes)
+	{
+		if (__nbytes == 0 || __addr == nullptr)
+			return nullptr;
+
+		if (__nbytes > MAXSIZE)
+			return traits_type::deallocate(__m_target, __addr, __nbytes);
+
+		size_t sclass = size_class(__nbytes);
+		slab* s = __slab_of(__addr);
+		if (s->sclass != sclass)
+			return __addr; // sanity check only: address is not valid
+
+		slab_list& lst = __m_classes[sclass];
+		size_t pos = static_cast<size_t>(static_cast<char*>(__addr) - (reinterpret_cast<char*>(s) + HEADERSIZE)) / class_size(sclass);
+		__put(s, pos);
+		if (s->nfree == 1) { // was full
+			__unlink(lst.full, s);
+			__link(lst.partial, s);
+		}
+
+		// return empty slab to upstream, but keep the last one
+		// to avoid thrashing on alloc/free of single object
+		if (s->nfree == s->capacity && (s->prev != nullptr || s->next != nullptr)) {
+			__unlink(lst.partial, s);
+			__free_slab(s);
+		}
+		return nullptr;
+	}
+
+	template<typename T>
+	inline size_t max_size() const
+	{	// estimate maximum array size
+		return traits_type::template max_size<T>(__m_target);
+	}
+
+private:
+	inline void __construct() {
+		for (size_t i = 0; i < CLASSCOUNT; i++)
+			__m_classes[i].partial = __m_classes[i].full = nullptr;
+	}
+
+	void __dispose()
+	{
+		for (size_t i = 0; i < CLASSCOUNT; i++) {
+			__release(__m_classes[i].partial);
+			__release(__m_classes[i].full);
+		}
+	}
+
+	void __release(slab*& __head)
+	{
+		while (__head != nullptr) {
+			slab* s = __head;
+			__head = s->next;
+			__free_slab(s);
+		}
+	}
+
+	static inline slab* __slab_of(void* __addr) {
+		return reinterpret_cast<slab*>(reinterpret_cast<uintptr_t>(__addr) & ~uintptr_t(SLABSIZE - 1));
+	}
+
+	static inline void __link(slab*& __head, slab* __s)
+	{
+		__s->prev = nullptr;
+		__s->next = __head;
+		if (__head != nullptr)
+			__head->prev = __s;
+		__head = __s;
+	}
+
+	static inline void __unlink(slab*& __head, slab* __s)
+	{
+		if (__s->prev != nullptr)
+			__s->prev->next = __s->next;
+		else
+			__head = __s->next;
+		if (__s->next != nullptr)
+			__s->next->prev = __s->prev;
+		__s->prev = __s->next = nullptr;
+	}
+
+	// take first free object from slab
+	static inline size_t __take(slab* __s)
+	{
+		using stdx::__ctz;
+		size_t i = __s->hint;
+		while (__s->bitmap[i] == 0)
+			++i;
+		size_t bit = __ctz(__s->bitmap[i]);
+		__s->bitmap[i] &= (__s->bitmap[i] - 1);
+		__s->hint = static_cast<uint32_t>(i);
+		--__s->nfree;
+		return (i * BITSPERWORD + bit);
+	}
+
+	// put object at position __pos back to slab
+	static inline void __put(slab* __s, size_t __pos)
+	{
+		size_t i = __pos / BITSPERWORD;
+		__s->bitmap[i] |= (word_type(1) << (__pos % BITSPERWORD));
+		if (i < __s->hint)
+			__s->hint = static_cast<uint32_t>(i);
+		++__s->nfree;
+	}
+
+	slab* __new_slab(size_t __sclass)
+	{
+		void* block = traits_type::allocate(__m_target, SLABSIZE);
+		if (block == nullptr)
+			return nullptr;
+
+		slab* s = static_cast<slab*>(block);
+		size_t span = SLABSIZE;
+		if ((reinterpret_cast<uintptr_t>(block) & (SLABSIZE - 1)) != 0)
+		{	// upstream arena does not align blocks: carve slab from larger block
+			traits_type::deallocate(__m_target, block, SLABSIZE);
+			span = 2 * SLABSIZE;
+			if ((block = traits_type::allocate(__m_target, span)) == nullptr)
+				return nullptr;
+			s = __slab_of(static_cast<char*>(block) + SLABSIZE - 1);
+		}
+
+		size_t n = (SLABSIZE - HEADERSIZE) / class_size(__sclass);
+		s->prev = s->next = nullptr;
+		s->origin = block;
+		s->span = span;
+		s->sclass = static_cast<uint32_t>(__sclass);
+		s->nfree = static_cast<uint32_t>(n);
+		s->capacity = static_cast<uint32_t>(n);
+		s->hint = 0;
+		memset(s->bitmap, 0, sizeof(s->bitmap));
+		memset(s->bitmap, 0xFF, (n / BITSPERWORD) * sizeof(word_type));
+		if (n % BITSPERWORD)
+			s->bitmap[n / BITSPERWORD] = (word_type(1) << (n % BITSPERWORD)) - 1;
+		return s;
+	}
+
+	inline void __free_slab(slab* __s) {
+		traits_type::deallocate(__m_target, __s->origin, __s->span);
+	}
+
+private:
+	arena_t __m_target;
+	slab_list __m_classes[CLASSCOUNT];
+};
+
+
+_STDX_END
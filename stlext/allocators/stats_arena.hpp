@@ -0,0 +1,462 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <climits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <ostream>
+
+#include "basic_arena.hpp"
+#include "arena_traits.hpp"
+
+#include "../platform/bits.h"
+
+#if defined(STDX_OS_LINUX) && !defined(STDX_OS_ANDROID)
+#include <execinfo.h>
+#define _STDX_HAVE_BACKTRACE
+#endif
+
+// number of counter shards, threads are spread across shards
+#ifndef _STATS_ARENA_SHARDS
+#define _STATS_ARENA_SHARDS 16
+#endif
+
+// maximum depth of sampled stack trace
+#ifndef _STATS_ARENA_MAX_FRAMES
+#define _STATS_ARENA_MAX_FRAMES 16
+#endif
+
+// maximum number of retained stack trace samples
+#ifndef _STATS_ARENA_MAX_TRACES
+#define _STATS_ARENA_MAX_TRACES 64
+#endif
+
+_STDX_BEGIN
+
+enum stats_format
+{
+	stats_text,
+	stats_json
+};
+
+
+/*!
+Snapshot of arena usage statistics.
+Histogram bin i counts requests with size in range (2^(i-1), 2^i]
+*/
+struct arena_stats
+{
+	static const size_t BINCOUNT = (sizeof(size_t) * CHAR_BIT + 1);
+
+	uint64_t allocations;  // number of successfull allocations
+	uint64_t reallocations;// number of successfull reallocations
+	uint64_t deallocations;// number of successfull deallocations
+	uint64_t failures;     // number of failed allocations (fallback fired)
+	uint64_t rejects;      // number of deallocations of foreign addresses
+	uint64_t bytes_allocated;
+	uint64_t bytes_deallocated;
+	int64_t  bytes_in_use;
+	int64_t  peak_bytes_in_use;
+	uint64_t histogram[BINCOUNT];
+
+	static inline size_t bin_index(size_t __nbytes) {
+		return (__nbytes > 1 ? (sizeof(size_t) * CHAR_BIT - stdx::__clz(__nbytes - 1)) : 0);
+	}
+
+	static inline uint64_t bin_size(size_t __idx) {
+		return (__idx < sizeof(size_t) * CHAR_BIT ? (uint64_t(1) << __idx) : uint64_t(-1));
+	}
+
+	std::ostream& dump(std::ostream& __stream, stats_format __format = stats_text) const
+	{
+		if (__format == stats_json) {
+			__stream << "{\"allocations\":" << allocations
+					 << ",\"reallocations\":" << reallocations
+					 << ",\"deallocations\":" << deallocations
+					 << ",\"failures\":" << failures
+					 << ",\"rejects\":" << rejects
+					 << ",\"bytes_allocated\":" << bytes_allocated
+					 << ",\"bytes_deallocated\":" << bytes_deallocated
+					 << ",\"bytes_in_use\":" << bytes_in_use
+					 << ",\"peak_bytes_in_use\":" << peak_bytes_in_use
+					 << ",\"histogram\":{";
+			const char* sep = "";
+			for (size_t i = 0; i < BINCOUNT; i++) {
+				if (histogram[i] == 0)
+					continue;
+				__stream << sep << '"' << bin_size(i) << "\":" << histogram[i];
+				sep = ",";
+			}
+			return (__stream << "}}");
+		}
+
+		__stream << "allocations:       " << allocations << '\n'
+				 << "reallocations:     " << reallocations << '\n'
+				 << "deallocations:     " << deallocations << '\n'
+				 << "failures:          " << failures << '\n'
+				 << "rejects:           " << rejects << '\n'
+				 << "bytes allocated:   " << bytes_allocated << '\n'
+				 << "bytes deallocated: " << bytes_deallocated << '\n'
+				 << "bytes in use:      " << bytes_in_use << '\n'
+				 << "peak bytes in use: " << peak_bytes_in_use << '\n'
+				 << "histogram:" << '\n';
+		for (size_t i = 0; i < BINCOUNT; i++) {
+			if (histogram[i] != 0)
+				__stream << "  <= " << bin_size(i) << ": " << histogram[i] << '\n';
+		}
+		return __stream;
+	}
+};
+
+
+/*!
+Stack trace captured on sampled allocation
+*/
+struct arena_trace
+{
+	size_t nbytes;
+	size_t nframes;
+	void*  frames[_STATS_ARENA_MAX_FRAMES];
+};
+
+
+namespace detail {
+
+// index of counter shard owned by calling thread
+inline size_t __stats_shard_index()
+{
+	static std::atomic<size_t> __next(0);
+	static __THREADLOCAL size_t __index = __next.fetch_add(1, std::memory_order_relaxed) % _STATS_ARENA_SHARDS;
+	return __index;
+}
+
+inline void __json_escape(std::ostream& __stream, const char* __s)
+{
+	for (; *__s; ++__s) {
+		if (*__s == '"' || *__s == '\\')
+			__stream << '\\';
+		__stream << *__s;
+	}
+}
+
+} // end namespace detail
+
+
+
+/*!
+Arena decorator collecting usage statistics of underlying arena.
+
+Counters are kept in cache-line aligned shards, each thread updates
+it's own shard with relaxed atomic operations, so counting is cheap
+and shards are aggregated only when snapshot is requested.
+Allocation failures of underlying arena are counted separately: when
+stats_arena wraps primary arena of fallback_arena this is the number
+of times fallback fired. Optionally every N-th allocation stack trace
+is sampled (on platforms providing backtrace() only).
+*/
+template<
+	typename _Arena,
+	typename _Mutex = void,
+	typename _Destroyer = empty_delete<>
+>
+class stats_arena :
+	public basic_arena<_Mutex, _Destroyer, false>
+{
+	__disable_copy(stats_arena)
+	typedef arena_traits<_Arena> traits_type;
+	typedef typename traits_type::member_type arena_t;
+
+	static const size_t BINCOUNT = arena_stats::BINCOUNT;
+	static const size_t SHARDCOUNT = _STATS_ARENA_SHARDS;
+
+	enum counter_index
+	{
+		ALLOCS,
+		REALLOCS,
+		DEALLOCS,
+		FAILURES,
+		REJECTS,
+		BYTES_ALLOCATED,
+		BYTES_DEALLOCATED,
+		NCOUNTERS
+	};
+
+	struct __ALIGNAS(64) shard
+	{
+		std::atomic<uint64_t> counters[NCOUNTERS];
+		std::atomic<uint64_t> histogram[BINCOUNT];
+	};
+
+public:
+	stats_arena() : 
+		__m_sampling(0) {
+		this->__init_from(traits_type::global(), __m_target);
+		reset();
+	}
+
+	stats_arena(const _Arena& __a) : 
+		__m_sampling(0) {
+		this->__init_from(__a, __m_target);
+		reset();
+	}
+
+	inline void* allocate(size_t __nbytes) {
+		void* addr = traits_type::allocate(__m_target, __nbytes);
+		__on_allocated(ALLOCS, addr, __nbytes);
+		return addr;
+	}
+
+	/*!
+	the size of hint block is unknown here, so reallocation is 
+	accounted as a fresh allocation of __nbytes: this is exact for
+	arenas ignoring the hint, but realloc-based arenas (malloc_arena,
+	aligned_arena) release the hint block without it ever being 
+	deallocated, so bytes in use and peak are overestimated
+	*/
+	inline void* reallocate(size_t __nbytes, void* __hint) {
+		void* addr = traits_type::reallocate(__m_target, __nbytes, __hint);
+		__on_allocated(REALLOCS, addr, __nbytes);
+		return addr;
+	}
+
+	/*!
+	reallocate __hint block of __oldbytes, on success the hint 
+	block is accounted as deallocated (caller must not deallocate 
+	it anymore), so realloc-based arenas are tracked exactly
+	*/
+	inline void* reallocate(size_t __nbytes, void* __hint, size_t __oldbytes) {
+		void* addr = traits_type::reallocate(__m_target, __nbytes, __hint);
+		__on_allocated(REALLOCS, addr, __nbytes, (__hint != nullptr ? __oldbytes : 0));
+		return addr;
+	}
+
+	inline void* deallocate(void* __addr, size_t __nbytes) {
+		void* res = traits_type::deallocate(__m_target, __addr, __nbytes);
+		shard& s = __local_shard();
+		if (res != nullptr) {
+			__increment(s.counters[REJECTS], 1);
+			return res;
+		}
+		__increment(s.counters[DEALLOCS], 1);
+		__increment(s.counters[BYTES_DEALLOCATED], __nbytes);
+		__m_in_use.fetch_sub(static_cast<int64_t>(__nbytes), std::memory_order_relaxed);
+		return res;
+	}
+
+	template<typename T>
+	inline size_t max_size() const {
+		return traits_type::template max_size<T>(__m_target);
+	}
+
+	/*!
+	enable stack trace sampling of every __period allocation,
+	zero period disables sampling
+	*/
+	inline void set_sampling(size_t __period) {
+		__m_sampling.store(__period, std::memory_order_relaxed);
+	}
+
+	inline size_t sampling() const {
+		return __m_sampling.load(std::memory_order_relaxed);
+	}
+
+	/*!
+	aggregate counters of all shards
+	*/
+	arena_stats stats() const
+	{
+		arena_stats result;
+		uint64_t counters[NCOUNTERS] = { 0 };
+		std::fill(result.histogram, result.histogram + BINCOUNT, uint64_t(0));
+		for (size_t i = 0; i < SHARDCOUNT; i++) {
+			const shard& s = __m_shards[i];
+			for (size_t j = 0; j < NCOUNTERS; j++)
+				counters[j] += s.counters[j].load(std::memory_order_relaxed);
+			for (size_t j = 0; j < BINCOUNT; j++)
+				result.histogram[j] += s.histogram[j].load(std::memory_order_relaxed);
+		}
+		result.allocations = counters[ALLOCS];
+		result.reallocations = counters[REALLOCS];
+		result.deallocations = counters[DEALLOCS];
+		result.failures = counters[FAILURES];
+		result.rejects = counters[REJECTS];
+		result.bytes_allocated = counters[BYTES_ALLOCATED];
+		result.bytes_deallocated = counters[BYTES_DEALLOCATED];
+		result.bytes_in_use = __m_in_use.load(std::memory_order_relaxed);
+		result.peak_bytes_in_use = __m_peak.load(std::memory_order_relaxed);
+		return result;
+	}
+
+	/*!
+	retrieve sampled stack traces
+	*/
+	std::vector<arena_trace> traces() const
+	{
+		std::lock_guard<std::mutex> locker(__m_trace_mtx);
+		return __m_traces;
+	}
+
+	/*!
+	reset all counters and sampled traces, peak usage
+	is reset to the current number of bytes in use
+	*/
+	void reset()
+	{
+		for (size_t i = 0; i < SHARDCOUNT; i++) {
+			shard& s = __m_shards[i];
+			for (size_t j = 0; j < NCOUNTERS; j++)
+				s.counters[j].store(0, std::memory_order_relaxed);
+			for (size_t j = 0; j < BINCOUNT; j++)
+				s.histogram[j].store(0, std::memory_order_relaxed);
+		}
+		__m_peak.store(__m_in_use.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> locker(__m_trace_mtx);
+		__m_traces.clear();
+		__m_trace_pos = 0;
+	}
+
+	std::ostream& dump(std::ostream& __stream, stats_format __format = stats_text) const
+	{
+		arena_stats st = stats();
+		std::vector<arena_trace> samples = traces();
+		if (__format == stats_json) {
+			__stream << "{\"stats\":";
+			st.dump(__stream, __format);
+			__stream << ",\"traces\":[";
+			for (size_t i = 0; i < samples.size(); i++) {
+				__stream << (i > 0 ? "," : "") << "{\"nbytes\":" << samples[i].nbytes << ",\"frames\":[";
+				__dump_frames(__stream, samples[i], __format);
+				__stream << "]}";
+			}
+			return (__stream << "]}");
+		}
+
+		st.dump(__stream, __format);
+		for (size_t i = 0; i < samples.size(); i++) {
+			__stream << "trace #" << i << " (" << samples[i].nbytes << " bytes):" << '\n';
+			__dump_frames(__stream, samples[i], __format);
+		}
+		return __stream;
+	}
+
+private:
+	static inline void __increment(std::atomic<uint64_t>& __counter, uint64_t __n) {
+		__counter.fetch_add(__n, std::memory_order_relaxed);
+	}
+
+	inline shard& __local_shard() {
+		return __m_shards[detail::__stats_shard_index()];
+	}
+
+	// __released bytes of resized block are accounted as deallocated
+	inline void __on_allocated(counter_index __which, void* __addr, size_t __nbytes, size_t __released = 0)
+	{
+		shard& s = __local_shard();
+		if (__addr == nullptr) {
+			__increment(s.counters[FAILURES], 1);
+			return;
+		}
+
+		uint64_t n = s.counters[__which].fetch_add(1, std::memory_order_relaxed);
+		__increment(s.counters[BYTES_ALLOCATED], __nbytes);
+		__increment(s.histogram[arena_stats::bin_index(__nbytes)], 1);
+		if (__released != 0)
+			__increment(s.counters[BYTES_DEALLOCATED], __released);
+
+		int64_t delta = static_cast<int64_t>(__nbytes) - static_cast<int64_t>(__released);
+		int64_t used = __m_in_use.fetch_add(delta, std::memory_order_relaxed) + delta;
+		int64_t peak = __m_peak.load(std::memory_order_relaxed);
+		while (used > peak && !__m_peak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+		}
+
+		size_t period = __m_sampling.load(std::memory_order_relaxed);
+		if (period != 0 && (n % period) == 0)
+			__sample(__nbytes);
+	}
+
+	void __sample(size_t __nbytes)
+	{
+#ifdef _STDX_HAVE_BACKTRACE
+		arena_trace t;
+		t.nbytes = __nbytes;
+		t.nframes = static_cast<size_t>(::backtrace(t.frames, _STATS_ARENA_MAX_FRAMES));
+
+		std::lock_guard<std::mutex> locker(__m_trace_mtx);
+		if (__m_traces.size() < _STATS_ARENA_MAX_TRACES) {
+			__m_traces.push_back(t);
+		} else { // overwrite oldest sample
+			__m_traces[__m_trace_pos] = t;
+			__m_trace_pos = (__m_trace_pos + 1) % _STATS_ARENA_MAX_TRACES;
+		}
+#else
+		(void)__nbytes;
+#endif
+	}
+
+	static void __dump_frames(std::ostream& __stream, const arena_trace& __trace, stats_format __format)
+	{
+#ifdef _STDX_HAVE_BACKTRACE
+		char** symbols = ::backtrace_symbols(__trace.frames, static_cast<int>(__trace.nframes));
+		for (size_t i = 0; i < __trace.nframes; i++) {
+			const char* name = (symbols != nullptr ? symbols[i] : "??");
+			if (__format == stats_json) {
+				__stream << (i > 0 ? ",\"" : "\"");
+				detail::__json_escape(__stream, name);
+				__stream << '"';
+			} else {
+				__stream << "  " << name << '\n';
+			}
+		}
+		::free(symbols);
+#else
+		(void)__stream; (void)__trace; (void)__format;
+#endif
+	}
+
+private:
+	arena_t __m_target;
+	shard __m_shards[SHARDCOUNT];
+	std::atomic<int64_t> __m_in_use{ 0 };
+	std::atomic<int64_t> __m_peak{ 0 };
+	std::atomic<size_t> __m_sampling;
+
+	mutable std::mutex __m_trace_mtx;
+	std::vector<arena_trace> __m_traces;
+	size_t __m_trace_pos = 0;
+};
+
+
+_STDX_END
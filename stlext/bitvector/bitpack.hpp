@@ -187,6 +187,26 @@ class leb128_codec :
         w = result;
         return first;
     }
+
+public:
+    /*!
+     * \brief Encodes single value
+     * \return output iterator past the encoded value
+     */
+    template<class _OutIt>
+    _OutIt encode_value(_Word w, _OutIt out) const {
+        return pack(w, out);
+    }
+
+    /*!
+     * \brief Decodes single value
+     * \return input iterator past the decoded value
+     */
+    template<class _InIt>
+    _InIt decode_value(_InIt first, _InIt last, _Word& w) const {
+        first = unpack(first, last, w);
+        return ((first != last) ? ++first : first);
+    }
 };
 
 
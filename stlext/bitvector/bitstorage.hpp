@@ -291,6 +291,8 @@ protected:
 
         size_t blk = (n / bpw); // block index
         size_t bit = (n % bpw); // bit index
+        if (bit == 0)
+            return; // highest word is fully used, wp[blk] is past the end
 
         // mask bits higher than bit
         //_Word mask = (bit != 0) ? ((_Word(1) << bit) - 1) : (~_Word(0));
@@ -82,12 +82,17 @@ namespace compact
         class T,
         size_t _SizeBits,
         size_t _TagBits,
-        class _Alloc
+        class _Alloc,
+        bool _SSO = false
     >
     class vector_storage :
         public alloc_ebo<_Alloc>
     {
     protected:
+        static constexpr size_t local_bufsize = 0;
+
+        bool __is_local() const { return false; }
+        void __set_local(bool) {}
 
         union {
             struct {
@@ -118,10 +123,15 @@ namespace compact
         size_t _SizeBits,
         class _Alloc
     >
-    class vector_storage<T, _SizeBits, 1, _Alloc> :
+    class vector_storage<T, _SizeBits, 1, _Alloc, false> :
         public alloc_ebo<_Alloc>
     {
     protected:
+        static constexpr size_t local_bufsize = 0;
+
+        bool __is_local() const { return false; }
+        void __set_local(bool) {}
+
         union {
             struct {
                 uint64_t addr : ptr_bits;
@@ -151,10 +161,15 @@ namespace compact
         size_t _SizeBits,
         class _Alloc
     >
-    class vector_storage<T, _SizeBits, 0, _Alloc> :
+    class vector_storage<T, _SizeBits, 0, _Alloc, false> :
         public alloc_ebo<_Alloc>
     {
     protected:
+        static constexpr size_t local_bufsize = 0;
+
+        bool __is_local() const { return false; }
+        void __set_local(bool) {}
+
         union {
             struct {
                 uint64_t addr : ptr_bits;
@@ -176,19 +191,163 @@ namespace compact
 
 
 
+    /// SSO SPECIALISATION
+
+    // Trivially copyable elements that fit into the
+    // pointer bytes are stored inline; the extra
+    // 'inplace' bit tells inline storage from heap.
+
+    // General case
     template<
         class T,
         size_t _SizeBits,
         size_t _TagBits,
         class _Alloc
     >
+    class vector_storage<T, _SizeBits, _TagBits, _Alloc, true> :
+        public alloc_ebo<_Alloc>
+    {
+    protected:
+        static constexpr size_t local_bufsize = (ptr_bits / CHAR_BIT) / sizeof(T);
+
+        bool __is_local() const { return static_cast<bool>(__m_data.inplace); }
+        void __set_local(bool on) { __m_data.inplace = on; }
+
+        // SSO optimization
+        union {
+            struct {
+                uint64_t addr : ptr_bits;
+                uint64_t size : _SizeBits;
+                uint64_t inplace : 1;
+                uint64_t tag : _TagBits;
+            };
+            T local[local_bufsize];
+            uint64_t storage;
+        } __m_data;
+
+    public:
+        vector_storage() {
+            __m_data.storage = 0;
+        }
+
+        explicit vector_storage(const _Alloc& al) :
+            alloc_ebo<_Alloc>(al) {
+            __m_data.storage = 0;
+        }
+
+        uint16_t tag() const { return static_cast<uint16_t>(__m_data.tag); }
+        void tag(uint16_t t) { __m_data.tag = t; }
+    };
+
+    // Specialization for boolean (1-bit) tag
+    template<
+        class T,
+        size_t _SizeBits,
+        class _Alloc
+    >
+    class vector_storage<T, _SizeBits, 1, _Alloc, true> :
+        public alloc_ebo<_Alloc>
+    {
+    protected:
+        static constexpr size_t local_bufsize = (ptr_bits / CHAR_BIT) / sizeof(T);
+
+        bool __is_local() const { return static_cast<bool>(__m_data.inplace); }
+        void __set_local(bool on) { __m_data.inplace = on; }
+
+        // SSO optimization
+        union {
+            struct {
+                uint64_t addr : ptr_bits;
+                uint64_t size : _SizeBits;
+                uint64_t inplace : 1;
+                uint64_t tag : 1;
+            };
+            T local[local_bufsize];
+            uint64_t storage;
+        } __m_data;
+
+    public:
+        vector_storage() {
+            __m_data.storage = 0;
+        }
+
+        explicit vector_storage(const _Alloc& al) :
+            alloc_ebo<_Alloc>(al) {
+            __m_data.storage = 0;
+        }
+
+        bool tag() const { return static_cast<bool>(__m_data.tag); }
+        void tag(bool on) { __m_data.tag = on; }
+    };
+
+    // Specialization for empty tag
+    template<
+        class T,
+        size_t _SizeBits,
+        class _Alloc
+    >
+    class vector_storage<T, _SizeBits, 0, _Alloc, true> :
+        public alloc_ebo<_Alloc>
+    {
+    protected:
+        static constexpr size_t local_bufsize = (ptr_bits / CHAR_BIT) / sizeof(T);
+
+        bool __is_local() const { return static_cast<bool>(__m_data.inplace); }
+        void __set_local(bool on) { __m_data.inplace = on; }
+
+        // SSO optimization
+        union {
+            struct {
+                uint64_t addr : ptr_bits;
+                uint64_t size : _SizeBits;
+                uint64_t inplace : 1;
+            };
+            T local[local_bufsize];
+            uint64_t storage;
+        } __m_data;
+
+    public:
+        vector_storage() {
+            __m_data.storage = 0;
+        }
+
+        explicit vector_storage(const _Alloc& al) :
+            alloc_ebo<_Alloc>(al) {
+            __m_data.storage = 0;
+        }
+    };
+
+
+    // Number of bits spent on log2(capacity) by
+    // growth-buffered vectors: capacity is always
+    // a power of two not greater than 2^_SizeBits,
+    // so 4 bits cover every admissible size width
+    static constexpr size_t capacity_bits = 4;
+
+
+    template<
+        class T,
+        size_t _SizeBits,
+        size_t _TagBits,
+        class _Alloc,
+        bool _Buffered = false,
+        bool _SSO = false
+    >
     class basic_vector :
-            public vector_storage<T, _SizeBits, _TagBits, _Alloc>
+            public vector_storage<T, _SizeBits + (_Buffered ? capacity_bits : 0), _TagBits, _Alloc, _SSO>
     {
-        typedef vector_storage<T, _SizeBits, _TagBits, _Alloc> storage_type;
+        typedef vector_storage<T, _SizeBits + (_Buffered ? capacity_bits : 0), _TagBits, _Alloc, _SSO> storage_type;
         static_assert(_SizeBits > 0, "size bits cannot be 0");
-        static_assert(_SizeBits + _TagBits <= 16, "incorrect number of bits for size and tag");
+        static_assert(_SizeBits + _TagBits + (_Buffered ? capacity_bits : 0) + (_SSO ? 1 : 0) <= 16,
+                      "incorrect number of bits for size, capacity and tag");
+        static_assert(!_SSO || (std::is_trivially_copyable<T>::value && sizeof(T) <= ptr_bits / CHAR_BIT),
+                      "inline storage requires small trivially copyable type");
 
+        // In buffered mode the storage size field is
+        // split in two parts: the low _SizeBits hold
+        // the actual size, the high capacity_bits hold
+        // log2 of the allocated capacity.
+        static constexpr size_t size_mask = (size_t(1) << _SizeBits) - 1;
 
     protected:
 
@@ -197,23 +356,91 @@ namespace compact
         }
 
         void __deallocate(T* ptr, size_t n) {
-            if (this->size() > 0)
+            if (ptr != nullptr && ptr != __local_ptr())
                 this->get_allocator().deallocate(ptr, n);
         }
 
+        T* __local_ptr() {
+            return reinterpret_cast<T*>(&this->__m_data);
+        }
+
+        static bool __fit_local(size_t n) {
+            return (_SSO && n <= storage_type::local_bufsize);
+        }
+
+        // Allocate room for n elements, preferring the
+        // inline buffer when it is big enough. The caller
+        // must read everything it needs from the current
+        // heap pointer before writing to the result.
+        T* __allocate_at_least(size_t n, size_t c) {
+            return (__fit_local(n) ? __local_ptr() : __allocate(c));
+        }
+
         void __destroy_range(T* first, T* last) {
             for (; first != last; ++first)
                 first->~T();
         }
 
+        static size_t __recommend(size_t n) {
+            if (!_Buffered)
+                return n;
+            size_t c = 1;
+            while (c < n)
+                c <<= 1;
+            return c;
+        }
+
+        static size_t __log2(size_t c) {
+            size_t l = 0;
+            while ((size_t(1) << l) < c)
+                ++l;
+            return l;
+        }
 
-        void __clear()
+        size_t __capacity() const {
+            if (this->__is_local())
+                return storage_type::local_bufsize;
+            if (!_Buffered)
+                return size();
+            return (this->__m_data.addr != 0 ? (size_t(1) << (this->__m_data.size >> _SizeBits)) : 0);
+        }
+
+        void __set_size(size_t n) {
+            this->__m_data.size = (this->__m_data.size & ~uint64_t(size_mask)) | n;
+        }
+
+        void __reset(T* space, size_t n, size_t c) {
+            if (space != nullptr && space == __local_ptr()) {
+                this->__set_local(true);
+                this->__m_data.size = n;
+                return;
+            }
+            this->__set_local(false);
+            this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
+            this->__m_data.size = (_Buffered && c > 0) ? ((__log2(c) << _SizeBits) | n) : n;
+        }
+
+        void __relocate(size_t c)
         {
             size_t s = size();
-            if (s > 0) {
-                T* ptr = data();
-                __destroy_range(ptr, ptr + s);
-                __deallocate(ptr, s);
+            size_t __old = __capacity();
+            T* ptr = data();
+            T* space = (c > 0 ? __allocate_at_least(c, c) : nullptr);
+            std::uninitialized_copy(std::make_move_iterator(ptr),
+                                    std::make_move_iterator(ptr + s),
+                                    space);
+            __destroy_range(ptr, ptr + s);
+            __deallocate(ptr, __old);
+            __reset(space, s, c);
+        }
+
+
+        void __clear()
+        {
+            T* ptr = data();
+            if (ptr != nullptr) {
+                __destroy_range(ptr, ptr + size());
+                __deallocate(ptr, __capacity());
                 this->__m_data.storage = 0;
             }
         }
@@ -229,6 +456,14 @@ namespace compact
                 throw std::out_of_range("pos/size is out of valid range");
             }*/
 
+            if (_Buffered || this->__is_local()) { // shift the tail down, keep the buffer
+                T* pos = const_cast<T*>(where);
+                T* last = std::move(pos + n, ptr + s, pos);
+                __destroy_range(last, ptr + s);
+                __set_size(s - n);
+                return pos;
+            }
+
             size_t __size = s - n;
             if (__size == 0) { // special case - clear
                 __destroy_range(ptr, ptr + s);
@@ -236,7 +471,7 @@ namespace compact
                 this->__m_data.storage = 0;
                 return nullptr;
             } else {
-                T* space = __allocate(__size);
+                T* space = __allocate_at_least(__size, __size);
                 T* mid = std::uninitialized_copy(ptr, const_cast<T*>(where), space);
                 std::uninitialized_copy(const_cast<T*>(where + n), ptr + s, mid);
 
@@ -244,8 +479,7 @@ namespace compact
                 __destroy_range(ptr, ptr + s);
                 __deallocate(ptr, s);
 
-                this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
-                this->__m_data.size = __size;
+                __reset(space, __size, __size);
                 return mid;
             }
         }
@@ -267,7 +501,17 @@ namespace compact
                 throw std::out_of_range("pointer is out of valid range");
             }*/
 
-            T* space = __allocate(__size);
+            size_t c = __capacity();
+            if (__size <= c) { // enough room: append and rotate in place
+                T* pos = const_cast<T*>(where);
+                std::uninitialized_copy_n(std::make_move_iterator(first), n, ptr + s);
+                std::rotate(pos, ptr + s, ptr + __size);
+                __set_size(__size);
+                return pos;
+            }
+
+            size_t __cap = __recommend(__size);
+            T* space = __allocate_at_least(__size, __cap);
             T* it = std::uninitialized_copy(std::make_move_iterator(ptr),
                                             std::make_move_iterator(const_cast<T*>(where)),
                                             space);
@@ -277,10 +521,9 @@ namespace compact
                                     std::make_move_iterator(ptr + s), it);
 
             __destroy_range(ptr, ptr + s);
-            __deallocate(ptr, s);
+            __deallocate(ptr, c);
 
-            this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
-            this->__m_data.size = __size;
+            __reset(space, __size, __cap);
             return pos;
         }
 
@@ -302,17 +545,26 @@ namespace compact
                 throw std::out_of_range("pointer is out of valid range");
             }*/
 
-            T* space = __allocate(__size);
+            size_t c = __capacity();
+            if (__size <= c) { // enough room: append and rotate in place
+                T* pos = const_cast<T*>(where);
+                std::uninitialized_fill_n(ptr + s, n, v);
+                std::rotate(pos, ptr + s, ptr + __size);
+                __set_size(__size);
+                return pos;
+            }
+
+            size_t __cap = __recommend(__size);
+            T* space = __allocate_at_least(__size, __cap);
             T* it = std::uninitialized_copy(ptr, const_cast<T*>(where), space);
             T* pos = it;
             it = std::uninitialized_fill_n(it, n, v);
             std::uninitialized_copy(const_cast<T*>(where), ptr + s, it);
 
             __destroy_range(ptr, ptr + s);
-            __deallocate(ptr, s);
+            __deallocate(ptr, c);
 
-            this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
-            this->__m_data.size = __size;
+            __reset(space, __size, __cap);
 
             return pos;
         }
@@ -326,22 +578,33 @@ namespace compact
                 return;
             }
 
+            if ((_Buffered || this->__is_local()) && n <= __capacity()) { // reuse the buffer
+                if (n < s) {
+                    std::copy_n(what, n, ptr);
+                    __destroy_range(ptr + n, ptr + s);
+                } else {
+                    std::copy_n(what, s, ptr);
+                    std::uninitialized_copy(what + s, what + n, ptr + s);
+                }
+                __set_size(n);
+                return;
+            }
+
             if (n == 0) { // special case -- clear
-                __destroy_range(ptr, ptr + s);
-                __deallocate(ptr, s);
-                this->__m_data.storage = 0;
+                __clear();
                 return;
             }
 
-            T* space = __allocate(n);
-            std::copy_n(what, n, space);
+            size_t c = __capacity();
+            size_t __cap = __recommend(n);
+            T* space = __allocate_at_least(n, __cap);
+            std::uninitialized_copy_n(what, n, space);
 
             // deallocate old storage if any
             __destroy_range(ptr, ptr + s);
-            __deallocate(ptr, s);
+            __deallocate(ptr, c);
 
-            this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
-            this->__m_data.size = n;
+            __reset(space, n, __cap);
         }
 
         void __assign(const T& val, size_t n)
@@ -353,24 +616,33 @@ namespace compact
                 return;
             }
 
-            if (n == 0) { // special case -- clear
-                if (s > 0) {
-                    __destroy_range(ptr, ptr + s);
-                    __deallocate(ptr, s);
-                    this->__m_data.storage = 0;
+            if ((_Buffered || this->__is_local()) && n <= __capacity()) { // reuse the buffer
+                if (n < s) {
+                    std::fill_n(ptr, n, val);
+                    __destroy_range(ptr + n, ptr + s);
+                } else {
+                    std::fill_n(ptr, s, val);
+                    std::uninitialized_fill_n(ptr + s, n - s, val);
                 }
+                __set_size(n);
                 return;
             }
 
-            T* space = __allocate(n);
+            if (n == 0) { // special case -- clear
+                __clear();
+                return;
+            }
+
+            size_t c = __capacity();
+            size_t __cap = __recommend(n);
+            T* space = __allocate_at_least(n, __cap);
             std::uninitialized_fill_n(space, n, val);
 
             // deallocate old storage if any
             __destroy_range(ptr, ptr + s);
-            __deallocate(ptr, s);
+            __deallocate(ptr, c);
 
-            this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
-            this->__m_data.size = n;
+            __reset(space, n, __cap);
         }
 
 
@@ -382,8 +654,15 @@ namespace compact
                 throw std::length_error("maximum vector size exceeded");
             }
 
+            size_t c = __capacity();
+            if (__size <= c) { // enough room
+                __set_size(__size);
+                return data();
+            }
+
             T* ptr = data();
-            T* space = __allocate(__size);
+            size_t __cap = __recommend(__size);
+            T* space = __allocate_at_least(__size, __cap);
             //std::uninitialized_copy(ptr, ptr + s, space);
             std::uninitialized_copy(std::make_move_iterator(ptr),
                                     std::make_move_iterator(ptr + s),
@@ -391,13 +670,29 @@ namespace compact
 
             // ???
             __destroy_range(ptr, ptr + s);
-            __deallocate(ptr, s);
+            __deallocate(ptr, c);
 
-            this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
-            this->__m_data.size = __size;
+            __reset(space, __size, __cap);
             return space;
         }
 
+        void __reserve(size_t n)
+        {
+            if (!_Buffered || n <= __capacity())
+                return;
+            if (n > this->max_size())
+                throw std::length_error("maximum vector size exceeded");
+            __relocate(__recommend(n));
+        }
+
+        void __shrink_to_fit()
+        {
+            size_t s = size();
+            size_t __cap = (s == 0 ? 0 : __fit_local(s) ? s : __recommend(s));
+            if (_Buffered && !this->__is_local() && __cap < __capacity())
+                __relocate(__cap);
+        }
+
         template<class _It>
         void __assign_range(_It first, _It last, std::input_iterator_tag)
         {
@@ -406,6 +701,12 @@ namespace compact
                 return;
 
             __clear();
+            if (_Buffered) { // geometric growth is already amortized
+                for (size_t s = 0; first != last; ++first, ++s)
+                    new (__expand(1) + s) T(*first);
+                return;
+            }
+
             size_t s = 0;
             size_t n = sizeof(uintmax_t); // initial capacity
             T* ptr = this->__expand(n); // intitial reallocation
@@ -445,10 +746,16 @@ namespace compact
         explicit basic_vector(const _Alloc& al) : storage_type(al) {}
 
         size_t max_size() const { return ((size_t(1) << _SizeBits) - 1); }
-        uint16_t size() const { return static_cast<uint16_t>(this->__m_data.size); }
+        uint16_t size() const { return static_cast<uint16_t>(this->__m_data.size & size_mask); }
+        size_t capacity() const { return __capacity(); }
 
-        T* data() { return reinterpret_cast<T*>(this->__m_data.addr & ptr_mask); }
-        const T* data() const { return reinterpret_cast<const T*>(this->__m_data.addr & ptr_mask); }
+        T* data() {
+            return (this->__is_local() ? __local_ptr() : reinterpret_cast<T*>(this->__m_data.addr & ptr_mask));
+        }
+        const T* data() const {
+            return (this->__is_local() ? reinterpret_cast<const T*>(&this->__m_data)
+                                       : reinterpret_cast<const T*>(this->__m_data.addr & ptr_mask));
+        }
     };
 
 
@@ -794,7 +1101,7 @@ namespace compact
             _Traits::move(space + pos, ptr + pos + n, __how_much);
 
             if (!__is_local())
-                this->get_allocator().deallocate(ptr, s);
+                this->get_allocator().deallocate(ptr, s + 1);
 
             if (space != this->__local_ptr()) {
                 this->__m_data.addr = reinterpret_cast<uint64_t>(space) & ptr_mask;
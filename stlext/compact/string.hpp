@@ -31,14 +31,129 @@
 #pragma once
 
 #include <iosfwd>
+#include <cstring>
 
 #include "../compability/string_view"
+#include "../platform/bits.h"
 
 #include "storages.hpp"
 
 
 namespace compact {
 
+namespace detail
+{
+    // Byte scans used by basic_string<char> when the string is long
+    // enough for vector loads. All return n when nothing is found.
+    // Single characters are left to memchr(), which libc already
+    // dispatches to the widest vector unit at run time.
+
+    // memchr() jumps between occurrences of the first byte as long
+    // as they are rare; once they get dense, candidates are taken
+    // only where both the first and the last byte of the needle
+    // match, 16 or 32 positions at a time.
+    // Precondition: 1 < m <= n
+    inline size_t __scan_substr(const char* p, size_t n, const char* s, size_t m)
+    {
+        const size_t end = n - m + 1; // candidate positions
+        size_t i = 0;
+        for (size_t misses = 0; i < end; )
+        {
+            const void* q = std::memchr(p + i, s[0], end - i);
+            if (q == nullptr)
+                return n;
+            size_t k = static_cast<const char*>(q) - p;
+            if (p[k + m - 1] == s[m - 1] && std::memcmp(p + k + 1, s + 1, m - 2) == 0)
+                return k;
+            i = k + 1;
+            if (++misses > 8 && misses * 32 > i)
+                break;
+        }
+#ifndef __STDX_DISABLE_SIMD_OPTIMIZATION__
+#ifdef __AVX2__
+        const __m256i yf = _mm256_set1_epi8(s[0]);
+        const __m256i yl = _mm256_set1_epi8(s[m - 1]);
+        for (; i + 32 <= end; i += 32)
+        {
+            __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + m - 1));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(f, yf), _mm256_cmpeq_epi8(l, yl))));
+            for (; mask != 0; mask &= mask - 1) {
+                size_t k = i + __builtin_ctz(mask);
+                if (std::memcmp(p + k + 1, s + 1, m - 2) == 0)
+                    return k;
+            }
+        }
+#endif
+#ifdef __SSE2__
+        const __m128i xf = _mm_set1_epi8(s[0]);
+        const __m128i xl = _mm_set1_epi8(s[m - 1]);
+        for (; i + 16 <= end; i += 16)
+        {
+            __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + m - 1));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(f, xf), _mm_cmpeq_epi8(l, xl))));
+            for (; mask != 0; mask &= mask - 1) {
+                size_t k = i + __builtin_ctz(mask);
+                if (std::memcmp(p + k + 1, s + 1, m - 2) == 0)
+                    return k;
+            }
+        }
+#endif
+#endif
+        for (; i < end; i++)
+            if (p[i] == s[0] && p[i + m - 1] == s[m - 1] &&
+                std::memcmp(p + i + 1, s + 1, m - 2) == 0)
+                return i;
+        return n;
+    }
+
+    // first byte of p contained in set s
+    inline size_t __scan_any(const char* p, size_t n, const char* s, size_t m)
+    {
+        size_t i = 0;
+#if !defined(__STDX_DISABLE_SIMD_OPTIMIZATION__) && defined(__SSE4_2__)
+        if (m <= 16)
+        {
+            char buf[16] = { 0 };
+            std::memcpy(buf, s, m);
+            const __m128i set = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+            for (; i + 16 <= n; i += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                int k = _mm_cmpestri(set, static_cast<int>(m), v, 16,
+                                     _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+                if (k < 16)
+                    return i + k;
+            }
+        }
+#endif
+        uint64_t table[4] = { 0, 0, 0, 0 };
+        for (size_t j = 0; j < m; j++) {
+            unsigned char c = static_cast<unsigned char>(s[j]);
+            table[c >> 6] |= uint64_t(1) << (c & 63);
+        }
+        for (; i < n; i++) {
+            unsigned char c = static_cast<unsigned char>(p[i]);
+            if ((table[c >> 6] >> (c & 63)) & 1)
+                return i;
+        }
+        return n;
+    }
+
+    // 64-bit finalizer of MurmurHash3
+    inline uint64_t __hash_word(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+}
+
     template<
         class _Char,
         class _Traits = std::char_traits<_Char>,
@@ -519,8 +634,20 @@ namespace compact {
             return { this->data(), this->size() };
         }
 
-        inline size_t hash_code() const {
-            return std::_Hash_bytes(this->data(), this->size() * sizeof(_Char), 0xc70f6907UL);
+        /**
+         *  @brief  Hash of the string contents.
+         *
+         *  In-place strings are hashed as a single word, so
+         *  for them hash_code() differs from std::hash of the
+         *  same std::string (heap strings still agree).
+         */
+        inline size_t hash_code() const
+        {
+            const size_t __size = this->size();
+            if (__in_place(__size))
+                return static_cast<size_t>(detail::__hash_word(__local_word(this->data(), __size) ^
+                                                               (uint64_t(__size) << 56)));
+            return std::_Hash_bytes(this->data(), __size * sizeof(_Char), 0xc70f6907UL);
         }
 
 
@@ -564,8 +691,26 @@ namespace compact {
         }
 
         template<class _AllocT, size_t _NSizeBits, size_t _NTagBits>
-        int compare(const basic_string<_Char, _Traits, _AllocT, _NSizeBits, _NTagBits>& other) const {
+        int compare(const basic_string<_Char, _Traits, _AllocT, _NSizeBits, _NTagBits>& other) const
+        {
             if (&other == static_cast<const void*>(this)) return 0;
+
+            // both in-place: compare words instead of characters;
+            // locality depends on size only, the same for all widths
+            const size_t __size = this->size(), __osize = other.size();
+            if (__std_traits && __in_place(__size) && __in_place(__osize))
+            {
+                uint64_t __a = __local_word(this->data(), __size);
+                uint64_t __b = __local_word(other.data(), __osize);
+                if (__a == __b)
+                    return this->__compare(__size, __osize);
+                if (sizeof(_Char) == 1) {
+                    // zero padding sorts below any byte, as a prefix does
+                    __a = __ordered(__a);
+                    __b = __ordered(__b);
+                    return ((__a < __b) ? -1 : 1);
+                }
+            }
             return compare(other.data(), other.size());
         }
 
@@ -575,6 +720,155 @@ namespace compact {
         }
 
 
+        /**
+         *  @brief  Find position of a character.
+         *  @param c  Character to locate.
+         *  @param pos  Index of character to search from (default 0).
+         *  @return  Index of first occurrence or npos.
+         */
+        size_t find(value_type c, size_t pos = 0) const noexcept
+        {
+            const size_t __size = this->size();
+            if (pos >= __size)
+                return npos;
+
+            const _Char* __p = this->data();
+            const _Char* __r = traits_type::find(__p + pos, __size - pos, c);
+            return (__r ? static_cast<size_t>(__r - __p) : npos);
+        }
+
+        /**
+         *  @brief  Find position of a C substring.
+         *  @param s  C string to locate.
+         *  @param pos  Index of character to search from.
+         *  @param n  Number of characters from @a s to search for.
+         *  @return  Index of start of first occurrence or npos.
+         */
+        size_t find(const_pointer s, size_t pos, size_t n) const
+        {
+            const size_t __size = this->size();
+            if (n == 0)
+                return ((pos <= __size) ? pos : npos);
+            if (pos >= __size || n > __size - pos)
+                return npos;
+            if (n == 1)
+                return find(s[0], pos);
+
+            const _Char* __p = this->data() + pos;
+            const size_t __len = __size - pos;
+            size_t __i = __len;
+            if (__byte_scan && __len >= 16)
+                __i = detail::__scan_substr(reinterpret_cast<const char*>(__p), __len,
+                                            reinterpret_cast<const char*>(s), n);
+            else {
+                for (size_t __k = 0; __k + n <= __len; __k++)
+                    if (traits_type::eq(__p[__k], s[0]) && traits_type::compare(__p + __k + 1, s + 1, n - 1) == 0) {
+                        __i = __k;
+                        break;
+                    }
+            }
+            return ((__i == __len) ? npos : pos + __i);
+        }
+
+        size_t find(const_pointer s, size_t pos = 0) const {
+            return find(s, pos, traits_type::length(s));
+        }
+
+        template<class _AllocT, size_t _NSizeBits, size_t _NTagBits>
+        size_t find(const basic_string<_Char, _Traits, _AllocT, _NSizeBits, _NTagBits>& s, size_t pos = 0) const {
+            return find(s.data(), pos, s.size());
+        }
+
+        template<class _AllocT>
+        size_t find(const std::basic_string<_Char, _Traits, _AllocT>& s, size_t pos = 0) const {
+            return find(s.data(), pos, s.size());
+        }
+
+
+        /**
+         *  @brief  Find position of a character of C substring.
+         *  @param s  String containing characters to locate.
+         *  @param pos  Index of character to search from.
+         *  @param n  Number of characters from s to search for.
+         *  @return  Index of first occurrence or npos.
+         */
+        size_t find_first_of(const_pointer s, size_t pos, size_t n) const
+        {
+            const size_t __size = this->size();
+            if (n == 0 || pos >= __size)
+                return npos;
+
+            const _Char* __p = this->data() + pos;
+            const size_t __len = __size - pos;
+            size_t __i = __len;
+            if (__byte_scan && __len >= 16)
+                __i = detail::__scan_any(reinterpret_cast<const char*>(__p), __len,
+                                         reinterpret_cast<const char*>(s), n);
+            else {
+                for (size_t __k = 0; __k < __len; __k++)
+                    if (traits_type::find(s, n, __p[__k])) {
+                        __i = __k;
+                        break;
+                    }
+            }
+            return ((__i == __len) ? npos : pos + __i);
+        }
+
+        size_t find_first_of(const_pointer s, size_t pos = 0) const {
+            return find_first_of(s, pos, traits_type::length(s));
+        }
+
+        size_t find_first_of(value_type c, size_t pos = 0) const noexcept {
+            return find(c, pos);
+        }
+
+        template<class _AllocT, size_t _NSizeBits, size_t _NTagBits>
+        size_t find_first_of(const basic_string<_Char, _Traits, _AllocT, _NSizeBits, _NTagBits>& s, size_t pos = 0) const {
+            return find_first_of(s.data(), pos, s.size());
+        }
+
+        template<class _AllocT>
+        size_t find_first_of(const std::basic_string<_Char, _Traits, _AllocT>& s, size_t pos = 0) const {
+            return find_first_of(s.data(), pos, s.size());
+        }
+
+    private:
+        // word and byte tricks are only valid for plain char_traits
+        static constexpr bool __std_traits = std::is_same<_Traits, std::char_traits<_Char> >::value;
+        static constexpr bool __byte_scan = __std_traits && (sizeof(_Char) == 1);
+
+        // strings of this size live inside the storage word
+        static constexpr bool __in_place(size_t n) {
+            return (n < base_type::max_local_capacity);
+        }
+
+        // characters of an in-place string are the low addressed bytes
+        // of the storage word; bytes past the size may be stale
+        static inline uint64_t __local_word(const _Char* p, size_t n)
+        {
+            uint64_t __w;
+            std::memcpy(&__w, p, sizeof(__w));
+            n *= sizeof(_Char) * CHAR_BIT;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            return (n ? (__w & (~uint64_t(0) << (64 - n))) : 0);
+#else
+            return (__w & ((uint64_t(1) << n) - 1));
+#endif
+        }
+
+        // word whose unsigned order is the memcmp order of its bytes
+        static inline uint64_t __ordered(uint64_t w)
+        {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            return w;
+#else
+            return stdx::__byte_swap(w);
+#endif
+        }
+
+    public:
+
+
 
 
         /**
@@ -635,7 +929,8 @@ namespace compact {
 
     };
 
-
+    template<class _Char, class _Traits, class _Alloc, size_t _TagBits, size_t _SizeBits>
+    constexpr size_t basic_string<_Char, _Traits, _Alloc, _TagBits, _SizeBits>::npos;
 
 
 
@@ -856,7 +1151,7 @@ namespace compact {
     >
     inline bool operator==(const basic_string<_Char, _Traits, _Alloc1, _TagBits1, _SizeBits1>& __lhs,
                            const basic_string<_Char, _Traits, _Alloc2, _TagBits2, _SizeBits2>& __rhs)
-    { return (__lhs.compare(__rhs) == 0); }
+    { return (__lhs.size() == __rhs.size() && __lhs.compare(__rhs) == 0); }
 
 
     // operator ==
@@ -876,7 +1171,7 @@ namespace compact {
     >
     inline bool operator==(const basic_string<_Char, _Traits, _Alloc1, _TagBits, _SizeBits>& __lhs,
                            const std::basic_string<_Char, _Traits, _Alloc2>& __rhs)
-    { return (__lhs.compare(__rhs) == 0); }
+    { return (__lhs.size() == __rhs.size() && __lhs.compare(__rhs) == 0); }
 
 
 
@@ -897,7 +1192,7 @@ namespace compact {
     >
     inline bool operator==(const std::basic_string<_Char, _Traits, _Alloc1>& __lhs,
                            const basic_string<_Char, _Traits, _Alloc2, _TagBits, _SizeBits>& __rhs)
-    { return (__rhs.compare(__lhs) == 0); }
+    { return (__lhs.size() == __rhs.size() && __rhs.compare(__lhs) == 0); }
 
 
     /**
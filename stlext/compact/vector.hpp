@@ -55,12 +55,14 @@ namespace compact
         class T,
         class _Alloc = std::allocator<T>,
         size_t _TagBits = 0,
-        size_t _SizeBits = 16 - _TagBits
+        size_t _SizeBits = 16 - _TagBits,
+        bool _Buffered = false,
+        bool _SSO = false
     >
     class vector :
-        public basic_vector<T, _SizeBits, _TagBits, _Alloc >
+        public basic_vector<T, _SizeBits, _TagBits, _Alloc, _Buffered, _SSO>
     {
-        typedef basic_vector<T, _SizeBits, _TagBits, _Alloc> base_type;
+        typedef basic_vector<T, _SizeBits, _TagBits, _Alloc, _Buffered, _SSO> base_type;
     public:
         typedef T value_type;
         typedef T* pointer;
@@ -139,8 +141,8 @@ namespace compact
         }
 
 
-        template<class _AllocT, size_t _NTagBits, size_t _NSizeBits>
-        vector(const vector<T, _AllocT, _NTagBits, _NSizeBits>& other, const _Alloc& al = _Alloc()) :
+        template<class _AllocT, size_t _NTagBits, size_t _NSizeBits, bool _NBuffered, bool _NSSO>
+        vector(const vector<T, _AllocT, _NTagBits, _NSizeBits, _NBuffered, _NSSO>& other, const _Alloc& al = _Alloc()) :
             base_type(al)
         {
             assign(other);
@@ -159,8 +161,8 @@ namespace compact
             return (*this);
         }
 
-        template<class _AllocT, size_t _NTagBits, size_t _NSizeBits>
-        vector& operator=(const vector<T, _AllocT, _NTagBits, _NSizeBits>& other)
+        template<class _AllocT, size_t _NTagBits, size_t _NSizeBits, bool _NBuffered, bool _NSSO>
+        vector& operator=(const vector<T, _AllocT, _NTagBits, _NSizeBits, _NBuffered, _NSSO>& other)
         {
             assign(other);
             return (*this);
@@ -191,8 +193,8 @@ namespace compact
             this->__assign(ilist.begin(), ilist.size());
         }
 
-        template<class _AllocT, size_t _NTagBits, size_t _NSizeBits>
-        void assign(const vector<T, _AllocT, _NTagBits, _NSizeBits>& other)
+        template<class _AllocT, size_t _NTagBits, size_t _NSizeBits, bool _NBuffered, bool _NSSO>
+        void assign(const vector<T, _AllocT, _NTagBits, _NSizeBits, _NBuffered, _NSSO>& other)
         {
             if (static_cast<const void*>(&other) != static_cast<const void*>(this))  // escape self-assignment
                 this->__assign(other.data(), other.size());
@@ -259,6 +261,15 @@ namespace compact
 
         void clear() { this->__clear(); }
 
+        /*!
+         * Preallocate room for at least n elements.
+         * Exact-size vectors have no spare capacity,
+         * so this is a no-op unless _Buffered is set.
+         */
+        void reserve(size_t n) { this->__reserve(n); }
+
+        void shrink_to_fit() { this->__shrink_to_fit(); }
+
         iterator erase(const_iterator where) {
             assert(where >= begin() && where < end());
             return this->__erase(where, 1);
@@ -342,11 +353,15 @@ namespace compact
         class _Alloc2,
         size_t _TagBits1,
         size_t _SizeBits1,
+        bool _Buffered1,
+        bool _SSO1,
         size_t _TagBits2,
-        size_t _SizeBits2
+        size_t _SizeBits2,
+        bool _Buffered2,
+        bool _SSO2
     >
-    inline bool operator== (const vector<T, _Alloc1, _TagBits1, _SizeBits1>& lhs,
-                            const vector<T, _Alloc2, _TagBits2, _SizeBits2>& rhs)
+    inline bool operator== (const vector<T, _Alloc1, _TagBits1, _SizeBits1, _Buffered1, _SSO1>& lhs,
+                            const vector<T, _Alloc2, _TagBits2, _SizeBits2, _Buffered2, _SSO2>& rhs)
     {
         if (static_cast<const void*>(&lhs) == static_cast<const void*>(&rhs))
             return true;
@@ -359,9 +374,11 @@ namespace compact
         class _Alloc1,
         class _Alloc2,
         size_t _TagBits,
-        size_t _SizeBits
+        size_t _SizeBits,
+        bool _Buffered,
+        bool _SSO
     >
-    inline bool operator== (const vector<T, _Alloc1, _TagBits, _SizeBits>& lhs,
+    inline bool operator== (const vector<T, _Alloc1, _TagBits, _SizeBits, _Buffered, _SSO>& lhs,
                             const std::vector<T, _Alloc2>& rhs)
     {
         return (lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin()));
@@ -373,10 +390,12 @@ namespace compact
         class _Alloc1,
         class _Alloc2,
         size_t _TagBits,
-        size_t _SizeBits
+        size_t _SizeBits,
+        bool _Buffered,
+        bool _SSO
     >
     inline bool operator== (const std::vector<T, _Alloc1>& lhs,
-                            const vector<T, _Alloc2, _TagBits, _SizeBits>& rhs)
+                            const vector<T, _Alloc2, _TagBits, _SizeBits, _Buffered, _SSO>& rhs)
     {
         return (lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin()));
     }
@@ -389,11 +408,15 @@ namespace compact
         class _Alloc2,
         size_t _TagBits1,
         size_t _SizeBits1,
+        bool _Buffered1,
+        bool _SSO1,
         size_t _TagBits2,
-        size_t _SizeBits2
+        size_t _SizeBits2,
+        bool _Buffered2,
+        bool _SSO2
     >
-    inline bool operator!= (const vector<T, _Alloc1, _TagBits1, _SizeBits1>& lhs,
-                            const vector<T, _Alloc2, _TagBits2, _SizeBits2>& rhs)
+    inline bool operator!= (const vector<T, _Alloc1, _TagBits1, _SizeBits1, _Buffered1, _SSO1>& lhs,
+                            const vector<T, _Alloc2, _TagBits2, _SizeBits2, _Buffered2, _SSO2>& rhs)
     {
         return !(lhs == rhs);
     }
@@ -404,9 +427,11 @@ namespace compact
         class _Alloc1,
         class _Alloc2,
         size_t _TagBits,
-        size_t _SizeBits
+        size_t _SizeBits,
+        bool _Buffered,
+        bool _SSO
     >
-    inline bool operator!= (const vector<T, _Alloc1, _TagBits, _SizeBits>& lhs,
+    inline bool operator!= (const vector<T, _Alloc1, _TagBits, _SizeBits, _Buffered, _SSO>& lhs,
                             const std::vector<T, _Alloc2>& rhs)
     {
         return !(lhs == rhs);
@@ -418,10 +443,12 @@ namespace compact
         class _Alloc1,
         class _Alloc2,
         size_t _TagBits,
-        size_t _SizeBits
+        size_t _SizeBits,
+        bool _Buffered,
+        bool _SSO
     >
     inline bool operator!= (const std::vector<T, _Alloc1>& lhs,
-                            const vector<T, _Alloc2, _TagBits, _SizeBits>& rhs)
+                            const vector<T, _Alloc2, _TagBits, _SizeBits, _Buffered, _SSO>& rhs)
     {
         return !(lhs == rhs);
     }
@@ -431,6 +458,23 @@ namespace compact
     template<class T, size_t _TagBits>
     using tagged_vector = vector< T, std::allocator<T>, _TagBits >;
 
+    /*!
+     * Growth-buffered vector: log2(capacity) is kept in
+     * capacity_bits taken from the size field, so push_back
+     * is amortized O(1) and erase works in place while the
+     * object still fits in 8 bytes.
+     */
+    template<class T, size_t _TagBits = 0>
+    using buffered_vector = vector< T, std::allocator<T>, _TagBits, 16 - capacity_bits - _TagBits, true >;
+
+    /*!
+     * Small vector: up to 6 bytes of trivially copyable
+     * elements (e.g. 3 uint16_t or 6 uint8_t) are kept
+     * inline in place of the pointer, no heap involved.
+     */
+    template<class T, size_t _TagBits = 0>
+    using small_vector = vector< T, std::allocator<T>, _TagBits, 15 - _TagBits, false, true >;
+
 } // end namespace compact
 
 #undef _INPUT_ITERATOR_REQUIRED 
@@ -440,13 +484,14 @@ namespace std
 {
     template<
         class _Char,
-        class _Traits,
         class _Alloc,
         size_t _TagBits,
-        size_t _SizeBits
+        size_t _SizeBits,
+        bool _Buffered,
+        bool _SSO
     >
-    void swap(compact::vector<_Char, _Alloc, _TagBits, _SizeBits>& lhs,
-              compact::vector<_Char, _Alloc, _TagBits, _SizeBits>& rhs) {
+    void swap(compact::vector<_Char, _Alloc, _TagBits, _SizeBits, _Buffered, _SSO>& lhs,
+              compact::vector<_Char, _Alloc, _TagBits, _SizeBits, _Buffered, _SSO>& rhs) {
         lhs.swap(rhs);
     }
 } // end namespace std
@@ -32,8 +32,10 @@
 #include <memory>
 #include <deque>
 #include <iterator>
+#include <algorithm>
 
 #include "../platform/common.h"
+#include "ring_buffer.hpp"
 
 #include <queue>
 
@@ -50,6 +52,11 @@ _STDX_BEGIN
  * When insert take place if queue is full then front element 
  * (i.e. last recently inserted) will be evicted to free space 
  * for newly insertable element
+ * 
+ * Any sequence with push_back/pop_front can be used as _Container;
+ * stdx::ring_buffer keeps elements contiguous, reserves the whole
+ * capacity on construction and copies bulk push/pop ranges in at
+ * most two segments.
  */
 template<
 	typename _ValueType,
@@ -82,6 +89,7 @@ public:
 	// construct with specified size
 	circular_queue(size_type size) :
 		__m_max_size(size) {
+		__reserve(__m_buffer, size);
 	}
 
 	// push element into back of queue
@@ -92,17 +100,39 @@ public:
 		__m_buffer.push_back(val);
 	}
 
+	// push elements of range [first, last) into back of queue
+	// side-effect: front elements are evicted on overflow,
+	// so only last max_size() elements of range may remain
+	template<typename _InIt>
+	void push(_InIt first, _InIt last) {
+		__push(__m_buffer, first, last, typename std::iterator_traits<_InIt>::iterator_category());
+	}
+
 	// emplace element into back of queue
 	template<typename... _Args>
 	void emplace(_Args&&... args) {
-		if (full()) // evict last element on overflow
+		if (full()) // evict front element on overflow
 			pop(); 
-		__m_buffer.emplace(std::forward<_Args>(args)...);
+		__m_buffer.emplace_back(std::forward<_Args>(args)...);
 	}
 
 	// pop front element from queue
 	void pop()                     { __m_buffer.pop_front(); }
 
+	// pop n front elements from queue
+	void pop_n(size_type n) { 
+		__pop_n(__m_buffer, (std::min)(n, size())); 
+	}
+
+	// pop n front elements from queue copying them into out
+	template<typename _OutIt>
+	_OutIt pop_n(size_type n, _OutIt out) {
+		n = (std::min)(n, size());
+		out = __read(__m_buffer, n, out);
+		__pop_n(__m_buffer, n);
+		return out;
+	}
+
 	// return first element of mutable queue
 	reference front()              { return (__m_buffer.front()); }
 
@@ -155,6 +185,66 @@ public:
 	// return currently used memory allocator
 	allocator_type get_allocator() const { return (__m_buffer.get_allocator()); }
 
+private:
+	template<typename _C>
+	static void __reserve(_C&, size_type) {
+	}
+
+	template<typename _Tp, typename _Alloc>
+	static void __reserve(ring_buffer<_Tp, _Alloc>& c, size_type n) {
+		c.reserve(n);
+	}
+
+	template<typename _C>
+	static void __pop_n(_C& c, size_type n) {
+		c.erase(c.begin(), std::next(c.begin(), n));
+	}
+
+	template<typename _Tp, typename _Alloc>
+	static void __pop_n(ring_buffer<_Tp, _Alloc>& c, size_type n) {
+		c.pop_front(n);
+	}
+
+	template<typename _C, typename _OutIt>
+	static _OutIt __read(_C& c, size_type n, _OutIt out) {
+		return std::copy_n(c.begin(), n, out);
+	}
+
+	template<typename _Tp, typename _Alloc, typename _OutIt>
+	static _OutIt __read(ring_buffer<_Tp, _Alloc>& c, size_type n, _OutIt out) {
+		return c.read(out, n);
+	}
+
+	template<typename _C, typename _InIt, typename _Tag>
+	void __push(_C&, _InIt first, _InIt last, _Tag) {
+		for (; first != last; ++first)
+			push(*first);
+	}
+
+	template<typename _Tp, typename _Alloc, typename _FwdIt>
+	void __push(ring_buffer<_Tp, _Alloc>& c, _FwdIt first, _FwdIt last, std::forward_iterator_tag) 
+	{
+		size_type n = std::distance(first, last);
+		if (n >= __m_max_size) { // only tail of range survives
+			std::advance(first, n - __m_max_size);
+			c.clear();
+		}
+		else if (c.size() + n > __m_max_size) {
+			c.pop_front(c.size() + n - __m_max_size);
+		}
+		c.append(first, last);
+	}
+
+	template<typename _Tp, typename _Alloc, typename _RanIt>
+	void __push(ring_buffer<_Tp, _Alloc>& c, _RanIt first, _RanIt last, std::random_access_iterator_tag) {
+		__push(c, first, last, std::forward_iterator_tag());
+	}
+
+	template<typename _Tp, typename _Alloc, typename _BidIt>
+	void __push(ring_buffer<_Tp, _Alloc>& c, _BidIt first, _BidIt last, std::bidirectional_iterator_tag) {
+		__push(c, first, last, std::forward_iterator_tag());
+	}
+
 private:
 	container_type __m_buffer;
 	size_type __m_max_size;
@@ -0,0 +1,500 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <iterator>
+#include <type_traits>
+
+#include "../platform/common.h"
+
+/*
+ * Size of the cache line used to keep producer and 
+ * consumer indices apart (prevents false sharing).
+ */
+#ifndef _CQUEUE_CACHE_LINE
+#define _CQUEUE_CACHE_LINE 64
+#endif
+
+/*
+ * Number of failed attempts before blocking push/pop
+ * operations start to yield the time slice.
+ */
+#ifndef _CQUEUE_SPIN_COUNT
+#define _CQUEUE_SPIN_COUNT 64
+#endif
+
+_STDX_BEGIN
+
+namespace detail
+{
+	inline size_t __cqueue_capacity(size_t n) {
+		size_t cap = 2;
+		while (cap < n)
+			cap <<= 1;
+		return cap;
+	}
+
+	// spin for a while, then give up time slice
+	inline void __cqueue_backoff(unsigned& spins) {
+		if (++spins > _CQUEUE_SPIN_COUNT)
+			std::this_thread::yield();
+	}
+}
+
+
+/*!
+ * \brief spsc_circular_queue lock-free single producer/single consumer queue
+ *
+ * Bounded queue for handing elements from exactly one producer
+ * thread to exactly one consumer thread. Capacity is rounded up 
+ * to the power of two.
+ * 
+ * Producer and consumer indices live on separate cache lines, 
+ * each side also keeps a cached copy of the opposite index and 
+ * reloads it only when the queue looks full (empty), so in steady 
+ * state push and pop touch no shared cache line but the slot itself.
+ * 
+ * Batch operations publish the whole batch with a single store.
+ */
+template<class _Tp>
+class spsc_circular_queue
+{
+	typedef typename std::aligned_storage<sizeof(_Tp), alignof(_Tp)>::type slot_type;
+
+public:
+	typedef _Tp value_type;
+	typedef size_t size_type;
+	typedef value_type& reference;
+	typedef const value_type& const_reference;
+
+	explicit spsc_circular_queue(size_type n) :
+		__m_mask(detail::__cqueue_capacity(n) - 1),
+		__m_slots(new slot_type[__m_mask + 1]),
+		__m_tail(0), __m_head_cache(0),
+		__m_head(0), __m_tail_cache(0) {
+	}
+
+	spsc_circular_queue(const spsc_circular_queue&) = delete;
+	spsc_circular_queue& operator=(const spsc_circular_queue&) = delete;
+
+	~spsc_circular_queue() {
+		size_t tail = __m_tail.load(std::memory_order_relaxed);
+		for (size_t i = __m_head.load(std::memory_order_relaxed); i != tail; ++i)
+			__at(i)->~_Tp();
+		delete[] __m_slots;
+	}
+
+	// producer side
+
+	template<class... _Args>
+	bool try_emplace(_Args&&... args) {
+		size_t tail = __m_tail.load(std::memory_order_relaxed);
+		if (tail - __m_head_cache > __m_mask) {
+			__m_head_cache = __m_head.load(std::memory_order_acquire);
+			if (tail - __m_head_cache > __m_mask)
+				return false;
+		}
+		::new (__at(tail)) _Tp(std::forward<_Args>(args)...);
+		__m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool try_push(const value_type& val) { return try_emplace(val); }
+	bool try_push(value_type&& val) { return try_emplace(std::move(val)); }
+
+	template<class... _Args>
+	void emplace(_Args&&... args) {
+		unsigned spins = 0;
+		while (!__free_slots(1))
+			detail::__cqueue_backoff(spins);
+		try_emplace(std::forward<_Args>(args)...);
+	}
+
+	void push(const value_type& val) { emplace(val); }
+	void push(value_type&& val) { emplace(std::move(val)); }
+
+	// push up to n elements starting at first, 
+	// return number of pushed elements
+	template<class _InIt>
+	size_type try_push_n(_InIt first, size_type n) {
+		size_t tail = __m_tail.load(std::memory_order_relaxed);
+		size_t k = (std::min)(n, __free_slots(n));
+		for (size_t i = 0; i < k; ++i, ++first)
+			::new (__at(tail + i)) _Tp(*first);
+		__m_tail.store(tail + k, std::memory_order_release);
+		return k;
+	}
+
+	// push all n elements starting at first
+	template<class _InIt>
+	void push_n(_InIt first, size_type n) {
+		unsigned spins = 0;
+		while (n > 0) {
+			size_type k = try_push_n(first, n);
+			if (k == 0) {
+				detail::__cqueue_backoff(spins);
+				continue;
+			}
+			std::advance(first, k);
+			n -= k;
+			spins = 0;
+		}
+	}
+
+	// consumer side
+
+	bool try_pop(value_type& out) {
+		size_t head = __m_head.load(std::memory_order_relaxed);
+		if (head == __m_tail_cache) {
+			__m_tail_cache = __m_tail.load(std::memory_order_acquire);
+			if (head == __m_tail_cache)
+				return false;
+		}
+		_Tp* p = __at(head);
+		out = std::move(*p);
+		p->~_Tp();
+		__m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	void pop(value_type& out) {
+		unsigned spins = 0;
+		while (!try_pop(out))
+			detail::__cqueue_backoff(spins);
+	}
+
+	// pop up to n elements into out, 
+	// return number of popped elements
+	template<class _OutIt>
+	size_type try_pop_n(_OutIt out, size_type n) {
+		size_t head = __m_head.load(std::memory_order_relaxed);
+		if (__m_tail_cache - head < n)
+			__m_tail_cache = __m_tail.load(std::memory_order_acquire);
+		size_t k = (std::min)(n, __m_tail_cache - head);
+		for (size_t i = 0; i < k; ++i, ++out) {
+			_Tp* p = __at(head + i);
+			*out = std::move(*p);
+			p->~_Tp();
+		}
+		__m_head.store(head + k, std::memory_order_release);
+		return k;
+	}
+
+	// pop exactly n elements into out
+	template<class _OutIt>
+	_OutIt pop_n(_OutIt out, size_type n) {
+		unsigned spins = 0;
+		while (n > 0) {
+			size_type k = try_pop_n(out, n);
+			if (k == 0) {
+				detail::__cqueue_backoff(spins);
+				continue;
+			}
+			std::advance(out, k);
+			n -= k;
+			spins = 0;
+		}
+		return out;
+	}
+
+	// approximate number of elements (exact if called 
+	// by producer or consumer while the other side is idle)
+	size_type size() const {
+		size_t head = __m_head.load(std::memory_order_acquire);
+		return __m_tail.load(std::memory_order_acquire) - head;
+	}
+
+	bool empty() const { return size() == 0; }
+
+	size_type capacity() const { return __m_mask + 1; }
+
+private:
+	inline _Tp* __at(size_t i) const {
+		return reinterpret_cast<_Tp*>(__m_slots + (i & __m_mask));
+	}
+
+	// called by producer, reloads consumer index 
+	// only if cached one leaves less than n free slots
+	inline size_t __free_slots(size_t n) {
+		size_t tail = __m_tail.load(std::memory_order_relaxed);
+		if (__m_mask + 1 - (tail - __m_head_cache) < n)
+			__m_head_cache = __m_head.load(std::memory_order_acquire);
+		return __m_mask + 1 - (tail - __m_head_cache);
+	}
+
+private:
+	const size_t __m_mask;
+	slot_type* const __m_slots;
+	char __m_pad0[_CQUEUE_CACHE_LINE];
+
+	// producer cache line
+	std::atomic<size_t> __m_tail;
+	size_t __m_head_cache;
+	char __m_pad1[_CQUEUE_CACHE_LINE];
+
+	// consumer cache line
+	std::atomic<size_t> __m_head;
+	size_t __m_tail_cache;
+	char __m_pad2[_CQUEUE_CACHE_LINE];
+};
+
+
+
+/*!
+ * \brief mpmc_circular_queue lock-free multi producer/multi consumer queue
+ *
+ * Bounded queue after D. Vyukov: every slot carries a sequence 
+ * number telling whether it is ready for the producer (seq == pos)
+ * or for the consumer (seq == pos + 1) of the ticket pos. Producers 
+ * and consumers claim tickets with a CAS on their own index and 
+ * never touch the opposite one. Capacity is rounded up to the 
+ * power of two.
+ * 
+ * push_overwrite() keeps circular_queue semantics: when the queue 
+ * is full the producer evicts the oldest element itself.
+ * 
+ * Batch operations are sequences of single operations, elements 
+ * of one batch may interleave with elements of other producers.
+ * 
+ * A claimed slot must always be published, so the element is
+ * constructed before the slot is claimed unless its constructor 
+ * cannot throw, and it is moved out of the slot before assigning 
+ * it to the caller's object. If that assignment throws the 
+ * element is lost, the queue stays usable.
+ */
+template<class _Tp>
+class mpmc_circular_queue
+{
+	static_assert(std::is_nothrow_move_constructible<_Tp>::value,
+				  "mpmc_circular_queue requires nothrow move constructible type");
+
+	struct cell
+	{
+		std::atomic<size_t> seq;
+		typename std::aligned_storage<sizeof(_Tp), alignof(_Tp)>::type data;
+
+		inline _Tp* get() { return reinterpret_cast<_Tp*>(&data); }
+	};
+
+public:
+	typedef _Tp value_type;
+	typedef size_t size_type;
+	typedef value_type& reference;
+	typedef const value_type& const_reference;
+
+	explicit mpmc_circular_queue(size_type n) :
+		__m_mask(detail::__cqueue_capacity(n) - 1),
+		__m_cells(new cell[__m_mask + 1]),
+		__m_enqueue_pos(0),
+		__m_dequeue_pos(0) {
+		for (size_t i = 0; i <= __m_mask; i++)
+			__m_cells[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	mpmc_circular_queue(const mpmc_circular_queue&) = delete;
+	mpmc_circular_queue& operator=(const mpmc_circular_queue&) = delete;
+
+	~mpmc_circular_queue() {
+		size_t tail = __m_enqueue_pos.load(std::memory_order_relaxed);
+		for (size_t i = __m_dequeue_pos.load(std::memory_order_relaxed); i != tail; ++i)
+			__m_cells[i & __m_mask].get()->~_Tp();
+		delete[] __m_cells;
+	}
+
+	template<class... _Args>
+	bool try_emplace(_Args&&... args) {
+		return __try_emplace(std::is_nothrow_constructible<_Tp, _Args&&...>(), std::forward<_Args>(args)...);
+	}
+
+	bool try_push(const value_type& val) { return try_emplace(val); }
+	bool try_push(value_type&& val) { return try_emplace(std::move(val)); }
+
+	template<class... _Args>
+	void emplace(_Args&&... args) {
+		unsigned spins = 0;
+		while (!try_emplace(std::forward<_Args>(args)...))
+			detail::__cqueue_backoff(spins);
+	}
+
+	void push(const value_type& val) { emplace(val); }
+	void push(value_type&& val) { emplace(std::move(val)); }
+
+	// push element evicting the oldest ones while queue is full,
+	// return number of evicted elements
+	size_type push_overwrite(const value_type& val) {
+		size_type evicted = 0;
+		while (!try_push(val)) {
+			if (__discard())
+				++evicted;
+		}
+		return evicted;
+	}
+
+	bool try_pop(value_type& out)
+	{
+		size_t pos = __m_dequeue_pos.load(std::memory_order_relaxed);
+		cell* c;
+		for (;;) {
+			c = &__m_cells[pos & __m_mask];
+			size_t seq = c->seq.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0) {
+				if (__m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0) // empty
+				return false;
+			else
+				pos = __m_dequeue_pos.load(std::memory_order_relaxed);
+		}
+		_Tp* p = c->get();
+		_Tp val(std::move(*p));
+		p->~_Tp();
+		c->seq.store(pos + __m_mask + 1, std::memory_order_release);
+		out = std::move(val);
+		return true;
+	}
+
+	void pop(value_type& out) {
+		unsigned spins = 0;
+		while (!try_pop(out))
+			detail::__cqueue_backoff(spins);
+	}
+
+	// push up to n elements starting at first, 
+	// return number of pushed elements
+	template<class _InIt>
+	size_type try_push_n(_InIt first, size_type n) {
+		size_type k = 0;
+		for (; k < n && try_push(*first); ++k)
+			++first;
+		return k;
+	}
+
+	template<class _InIt>
+	void push_n(_InIt first, size_type n) {
+		for (; n > 0; --n, ++first)
+			push(*first);
+	}
+
+	// pop up to n elements into out, 
+	// return number of popped elements
+	template<class _OutIt>
+	size_type try_pop_n(_OutIt out, size_type n) {
+		size_type k = 0;
+		value_type val;
+		for (; k < n && try_pop(val); ++k, ++out)
+			*out = std::move(val);
+		return k;
+	}
+
+	template<class _OutIt>
+	_OutIt pop_n(_OutIt out, size_type n) {
+		value_type val;
+		for (; n > 0; --n, ++out) {
+			pop(val);
+			*out = std::move(val);
+		}
+		return out;
+	}
+
+	// approximate number of elements
+	size_type size() const {
+		size_t head = __m_dequeue_pos.load(std::memory_order_acquire);
+		size_t tail = __m_enqueue_pos.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	bool empty() const { return size() == 0; }
+
+	size_type capacity() const { return __m_mask + 1; }
+
+private:
+	// claim slot for producer, null if queue is full
+	cell* __claim(size_t& pos) 
+	{
+		pos = __m_enqueue_pos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell* c = &__m_cells[pos & __m_mask];
+			size_t seq = c->seq.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (__m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					return c;
+			}
+			else if (diff < 0) // full
+				return nullptr;
+			else
+				pos = __m_enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	template<class... _Args>
+	bool __try_emplace(std::true_type, _Args&&... args) 
+	{
+		size_t pos;
+		cell* c = __claim(pos);
+		if (!c)
+			return false;
+		::new (c->get()) _Tp(std::forward<_Args>(args)...);
+		c->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// constructor may throw: construct before claiming the slot
+	template<class... _Args>
+	bool __try_emplace(std::false_type, _Args&&... args) {
+		_Tp val(std::forward<_Args>(args)...);
+		return __try_emplace(std::true_type(), std::move(val));
+	}
+
+	bool __discard() {
+		value_type val;
+		return try_pop(val);
+	}
+
+private:
+	const size_t __m_mask;
+	cell* const __m_cells;
+	char __m_pad0[_CQUEUE_CACHE_LINE];
+
+	std::atomic<size_t> __m_enqueue_pos;
+	char __m_pad1[_CQUEUE_CACHE_LINE];
+
+	std::atomic<size_t> __m_dequeue_pos;
+	char __m_pad2[_CQUEUE_CACHE_LINE];
+};
+
+_STDX_END
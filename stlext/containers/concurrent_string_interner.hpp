@@ -0,0 +1,421 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstring>
+#include <climits>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <string>
+
+#include <stdexcept>
+
+#include <experimental/string_view>
+
+#include "../platform/common.h"
+
+/*
+ * Number of independently locked insertion stripes.
+ * Must be a power of two.
+ */
+#ifndef _INTERNER_STRIPES
+#define _INTERNER_STRIPES 64
+#endif
+
+/*
+ * Size of the string arena chunk allocated per stripe.
+ */
+#ifndef _INTERNER_CHUNK_SIZE
+#define _INTERNER_CHUNK_SIZE (64 * 1024)
+#endif
+
+_STDX_BEGIN
+
+/*!
+ * Thread-safe string interning table.
+ *
+ * Every distinct string receives a dense uint32_t id and a
+ * copy of its characters that never moves, so ids and views
+ * returned by intern() stay valid for the interner lifetime.
+ *
+ * Lookups are lock-free: they probe the currently published
+ * hash index with acquire loads only. Inserters are serialized
+ * per stripe (chosen by hash) and publish new entries with CAS,
+ * so threads interning different strings rarely contend.
+ * Growing the index blocks inserters, but not readers: a new
+ * index is built aside and published atomically, the retired
+ * one is kept until destruction (tables double, so all retired
+ * tables take less memory than the live one).
+ */
+template<
+    class _Char = char,
+    class _Traits = std::char_traits<_Char>
+>
+class basic_concurrent_string_interner
+{
+    struct entry
+    {
+        size_t   hash_code;
+        uint32_t id;
+        uint32_t length;
+
+        const _Char* data() const {
+            return reinterpret_cast<const _Char*>(this + 1);
+        }
+    };
+
+    struct table
+    {
+        size_t mask;
+        table* retired;
+        std::atomic<const entry*> slots[1];
+
+        static table* create(size_t n, table* prev)
+        {
+            void* p = ::operator new(sizeof(table) + (n - 1) * sizeof(std::atomic<const entry*>));
+            table* t = static_cast<table*>(p);
+            t->mask = n - 1;
+            t->retired = prev;
+            for (size_t i = 0; i < n; i++)
+                new (&t->slots[i]) std::atomic<const entry*>(nullptr);
+            return t;
+        }
+
+        static void destroy(table* t)
+        {
+            while (t != nullptr) {
+                table* prev = t->retired;
+                ::operator delete(t);
+                t = prev;
+            }
+        }
+    };
+
+    struct stripe
+    {
+        std::mutex mutex;
+        char* cursor;
+        size_t left;
+        std::vector<char*> chunks;
+
+        stripe() : cursor(nullptr), left(0) {}
+    };
+
+    // id -> entry map: segment k holds first_segment << k ids,
+    // so 32-bit id space needs only a few dozen segments
+    static constexpr size_t first_segment = 1024;
+    static constexpr size_t max_segments = 24;
+
+public:
+    typedef std::experimental::basic_string_view<_Char, _Traits> view_type;
+    typedef uint32_t id_type;
+
+    static constexpr id_type npos = id_type(-1);
+
+    basic_concurrent_string_interner(size_t n = 1024) :
+        __m_index(table::create(__bucket_count_for(n), nullptr)),
+        __m_size(0), __m_next(0)
+    {
+        for (size_t i = 0; i < max_segments; i++)
+            __m_ids[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    basic_concurrent_string_interner(const basic_concurrent_string_interner&) = delete;
+    basic_concurrent_string_interner& operator=(const basic_concurrent_string_interner&) = delete;
+
+    ~basic_concurrent_string_interner()
+    {
+        table::destroy(__m_index.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < max_segments; i++)
+            delete[] __m_ids[i].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < _INTERNER_STRIPES; i++) {
+            for (char* chunk : __m_stripes[i].chunks)
+                delete[] chunk;
+        }
+    }
+
+    template<class _TTraits, class _TAlloc>
+    inline id_type intern(const std::basic_string<_Char, _TTraits, _TAlloc>& s) {
+        return intern(s.data(), s.size());
+    }
+
+    inline id_type intern(view_type s) {
+        return intern(s.data(), s.size());
+    }
+
+    inline id_type intern(const _Char* s) {
+        return intern(s, _Traits::length(s));
+    }
+
+    /*!
+     * Return id of string [s, s + n), adding it on first use.
+     */
+    id_type intern(const _Char* s, size_t n)
+    {
+        if (n > UINT32_MAX)
+            throw std::length_error("string is too long to intern");
+
+        size_t hs = __hash_bytes(s, n);
+        const entry* e = __find(__m_index.load(std::memory_order_acquire), hs, s, n);
+        if (e != nullptr)
+            return e->id;
+        return __insert(hs, s, n);
+    }
+
+    template<class _TTraits, class _TAlloc>
+    inline id_type find(const std::basic_string<_Char, _TTraits, _TAlloc>& s) const {
+        return find(s.data(), s.size());
+    }
+
+    inline id_type find(view_type s) const {
+        return find(s.data(), s.size());
+    }
+
+    inline id_type find(const _Char* s) const {
+        return find(s, _Traits::length(s));
+    }
+
+    /*!
+     * Return id of string [s, s + n), or npos if it was
+     * never interned. Never blocks.
+     */
+    id_type find(const _Char* s, size_t n) const
+    {
+        const entry* e = __find(__m_index.load(std::memory_order_acquire), __hash_bytes(s, n), s, n);
+        return (e != nullptr ? e->id : npos);
+    }
+
+    /*!
+     * Return interned string by id. View is empty for
+     * ids not (yet) published by intern().
+     */
+    view_type view(id_type id) const
+    {
+        size_t k = __segment(id);
+        if (k >= max_segments)
+            return view_type();
+        const std::atomic<const entry*>* seg = __m_ids[k].load(std::memory_order_acquire);
+        if (seg == nullptr)
+            return view_type();
+        const entry* e = seg[id - __segment_base(k)].load(std::memory_order_acquire);
+        return (e != nullptr ? view_type(e->data(), e->length) : view_type());
+    }
+
+    inline view_type operator[](id_type id) const {
+        return view(id);
+    }
+
+    size_t size() const {
+        return __m_next.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return (size() == 0);
+    }
+
+    size_t bucket_count() const {
+        return __m_index.load(std::memory_order_acquire)->mask + 1;
+    }
+
+    double max_load_factor() const {
+        return 0.5;
+    }
+
+private:
+    static inline size_t __hash_bytes(const _Char* p, size_t n) {
+#ifdef STDX_CMPLR_MSVC
+        return std::_Hash_seq(reinterpret_cast<const unsigned char*>(p), n * sizeof(_Char));
+#else
+        return std::_Hash_bytes(p, n * sizeof(_Char), 0xc70f6907UL);
+#endif
+    }
+
+    static size_t __bucket_count_for(size_t n)
+    {
+        size_t buckets = 16;
+        while (buckets < 2 * n)
+            buckets <<= 1;
+        return buckets;
+    }
+
+    static inline size_t __segment(size_t id) {
+        size_t k = 0;
+        while ((first_segment << (k + 1)) - first_segment <= id)
+            ++k;
+        return k;
+    }
+
+    static inline size_t __segment_base(size_t k) {
+        return (first_segment << k) - first_segment;
+    }
+
+    static const entry* __find(const table* t, size_t hs, const _Char* s, size_t n)
+    {
+        for (size_t i = hs & t->mask; ; i = (i + 1) & t->mask)
+        {
+            const entry* e = t->slots[i].load(std::memory_order_acquire);
+            if (e == nullptr)
+                return nullptr;
+            if (e->hash_code == hs && e->length == n && _Traits::compare(e->data(), s, n) == 0)
+                return e;
+        }
+    }
+
+    static void __publish(table* t, const entry* e)
+    {
+        for (size_t i = e->hash_code & t->mask; ; i = (i + 1) & t->mask)
+        {
+            const entry* expected = nullptr;
+            if (t->slots[i].compare_exchange_strong(expected, e, std::memory_order_release,
+                                                    std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    entry* __allocate(stripe& st, size_t n)
+    {
+        size_t bytes = sizeof(entry) + n * sizeof(_Char);
+        bytes = (bytes + alignof(entry) - 1) & ~(alignof(entry) - 1);
+        if (bytes > st.left)
+        {
+            if (bytes > _INTERNER_CHUNK_SIZE / 4) { // dedicated chunk
+                char* chunk = new char[bytes];
+                st.chunks.push_back(chunk);
+                return reinterpret_cast<entry*>(chunk);
+            }
+            st.cursor = new char[_INTERNER_CHUNK_SIZE];
+            st.left = _INTERNER_CHUNK_SIZE;
+            st.chunks.push_back(st.cursor);
+        }
+        entry* e = reinterpret_cast<entry*>(st.cursor);
+        st.cursor += bytes;
+        st.left -= bytes;
+        return e;
+    }
+
+    std::atomic<const entry*>* __id_segment(size_t k)
+    {
+        std::atomic<const entry*>* seg = __m_ids[k].load(std::memory_order_acquire);
+        if (seg != nullptr)
+            return seg;
+
+        size_t n = first_segment << k;
+        std::atomic<const entry*>* fresh = new std::atomic<const entry*>[n];
+        for (size_t i = 0; i < n; i++)
+            fresh[i].store(nullptr, std::memory_order_relaxed);
+        if (__m_ids[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel))
+            return fresh;
+        delete[] fresh; // somebody was faster
+        return seg;
+    }
+
+    id_type __insert(size_t hs, const _Char* s, size_t n)
+    {
+        stripe& st = __m_stripes[(hs >> 7) & (_INTERNER_STRIPES - 1)];
+        for (;;)
+        {
+            {
+                std::shared_lock<std::shared_timed_mutex> resize_guard(__m_resize);
+                std::lock_guard<std::mutex> guard(st.mutex);
+
+                // equal strings always go to the same stripe,
+                // so nobody could add ours after this check
+                table* t = __m_index.load(std::memory_order_acquire);
+                const entry* e = __find(t, hs, s, n);
+                if (e != nullptr)
+                    return e->id;
+
+                // reserve a slot first: index never gets
+                // fuller than max_load_factor()
+                size_t used = __m_size.fetch_add(1, std::memory_order_acq_rel);
+                if (used < (t->mask + 1) * max_load_factor())
+                    return __emplace(st, t, hs, s, n)->id;
+                __m_size.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            __grow();
+        }
+    }
+
+    const entry* __emplace(stripe& st, table* t, size_t hs, const _Char* s, size_t n)
+    {
+        size_t id = __m_next.fetch_add(1, std::memory_order_relaxed);
+        if (id >= npos)
+            throw std::length_error("interner id space exhausted");
+
+        entry* e = __allocate(st, n);
+        e->hash_code = hs;
+        e->id = static_cast<id_type>(id);
+        e->length = static_cast<uint32_t>(n);
+        _Traits::copy(const_cast<_Char*>(e->data()), s, n);
+
+        size_t k = __segment(id);
+        __id_segment(k)[id - __segment_base(k)].store(e, std::memory_order_release);
+        __publish(t, e);
+        return e;
+    }
+
+    void __grow()
+    {
+        std::unique_lock<std::shared_timed_mutex> guard(__m_resize);
+        table* t = __m_index.load(std::memory_order_relaxed);
+        size_t n = t->mask + 1;
+        if (__m_size.load(std::memory_order_relaxed) + 1 < n * max_load_factor())
+            return; // already grown by other thread
+
+        table* bigger = table::create(n * 2, t);
+        for (size_t i = 0; i < n; i++) {
+            const entry* e = t->slots[i].load(std::memory_order_relaxed);
+            if (e != nullptr)
+                __publish(bigger, e);
+        }
+        __m_index.store(bigger, std::memory_order_release);
+    }
+
+private:
+    std::atomic<table*> __m_index;
+    std::atomic<size_t> __m_size;
+    std::atomic<size_t> __m_next;
+    std::atomic<std::atomic<const entry*>*> __m_ids[max_segments];
+    std::shared_timed_mutex __m_resize;
+    stripe __m_stripes[_INTERNER_STRIPES];
+};
+
+template<class _Char, class _Traits>
+constexpr typename basic_concurrent_string_interner<_Char, _Traits>::id_type
+basic_concurrent_string_interner<_Char, _Traits>::npos;
+
+typedef basic_concurrent_string_interner<char>    concurrent_string_interner;
+typedef basic_concurrent_string_interner<wchar_t> concurrent_wstring_interner;
+
+_STDX_END
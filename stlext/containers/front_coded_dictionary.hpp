@@ -0,0 +1,411 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstring>
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include <stdexcept>
+
+#include "../platform/common.h"
+#include "../bitvector/bitpack.hpp"
+
+
+_STDX_BEGIN
+
+/*!
+ * Immutable sorted dictionary of strings compressed by front coding.
+ *
+ * Strings are grouped into buckets of _BucketSize. The first string
+ * of a bucket (its header) is stored in full, every other one as the
+ * length of the prefix shared with its predecessor and the remaining
+ * suffix; all lengths are LEB128 varints. Ids are ranks in sorted
+ * order. Searches binary search the bucket headers, then decode at
+ * most one bucket.
+ */
+template<
+    class _Char = char,
+    class _Traits = std::char_traits<_Char>,
+    class _Alloc = std::allocator<_Char>,
+    size_t _BucketSize = 16
+>
+class basic_front_coded_dictionary
+{
+    static_assert(_BucketSize > 0, "bucket size must be positive");
+
+    typedef std::basic_string<
+        char,
+        std::char_traits<char>,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<char>
+    > buffer_type;
+
+    typedef std::vector<
+        size_t,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<size_t>
+    > header_map;
+
+    typedef const char* raw_pointer;
+    typedef leb128_codec<size_t> codec_type;
+
+public:
+    typedef size_t size_type;
+    typedef _Char char_type;
+    typedef std::basic_string<_Char, _Traits, _Alloc> string_type;
+
+    static constexpr size_t npos = size_t(-1);
+    static constexpr size_t bucket_size = _BucketSize;
+
+    class iterator
+    {
+        friend class basic_front_coded_dictionary;
+
+        iterator(const basic_front_coded_dictionary* d, size_t id, size_t pos) :
+            __m_dict(d), __m_id(id), __m_pos(pos) {
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef string_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const string_type& reference;
+        typedef const string_type* pointer;
+
+        iterator() :
+            __m_dict(nullptr), __m_id(0), __m_pos(0) {
+        }
+
+        // rank of the current string
+        size_t id() const { return __m_id; }
+
+        inline reference operator*() const {
+            return __m_str;
+        }
+
+        inline pointer operator->() const {
+            return &__m_str;
+        }
+
+        inline iterator& operator++() {
+            __m_dict->__next(*this);
+            return (*this);
+        }
+
+        inline iterator operator++(int) {
+            iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        friend inline bool operator== (const iterator& lhs,
+                                       const iterator& rhs) {
+            return (lhs.__m_id == rhs.__m_id);
+        }
+
+        friend inline bool operator!= (const iterator& lhs,
+                                       const iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        const basic_front_coded_dictionary* __m_dict;
+        size_t __m_id;   // rank of __m_str
+        size_t __m_pos;  // offset of the next entry
+        string_type __m_str;
+    };
+
+    typedef iterator const_iterator;
+
+    basic_front_coded_dictionary() :
+        __m_size(0) {
+    }
+
+    /*!
+     * Build from a sorted range of strings (or anything having
+     * data() and size()). Repeated strings are stored once,
+     * unsorted input throws std::invalid_argument.
+     */
+    template<class _InIt>
+    basic_front_coded_dictionary(_InIt first, _InIt last) :
+        basic_front_coded_dictionary()
+    {
+        string_type prev;
+        for (; first != last; ++first)
+            __append(prev, first->data(), first->size());
+        __m_data.shrink_to_fit();
+        __m_headers.shrink_to_fit();
+    }
+
+    /*!
+     * Id of the string or npos
+     */
+    size_t locate(const _Char* str, size_t len) const
+    {
+        iterator it = lower_bound(str, len);
+        return ((it != end() && __compare(*it, str, len) == 0) ? it.id() : npos);
+    }
+
+    size_t locate(const _Char* str) const {
+        return locate(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    size_t locate(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return locate(key.data(), key.size());
+    }
+
+    /*!
+     * String by id, throws std::out_of_range
+     */
+    string_type extract(size_t id) const
+    {
+        if (id >= __m_size)
+            throw std::out_of_range("front_coded_dictionary: id is out of range");
+
+        iterator it = __bucket_begin(id / _BucketSize);
+        while (it.__m_id != id)
+            __next(it);
+        return std::move(it.__m_str);
+    }
+
+    // first string not less than the key
+    iterator lower_bound(const _Char* str, size_t len) const
+    {
+        return __partition([this, str, len](const string_type& s) {
+            return (__compare(s, str, len) < 0);
+        });
+    }
+
+    iterator lower_bound(const _Char* str) const {
+        return lower_bound(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    iterator lower_bound(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return lower_bound(key.data(), key.size());
+    }
+
+    /*!
+     * Range of strings starting with prefix, in sorted order
+     */
+    std::pair<iterator, iterator> prefix_range(const _Char* prefix, size_t len) const
+    {
+        iterator first = lower_bound(prefix, len);
+        if (first == end() || !__has_prefix(*first, prefix, len))
+            return std::make_pair(first, first);
+
+        iterator last = __partition([this, prefix, len](const string_type& s) {
+            return (__compare(s, prefix, len) <= 0 || __has_prefix(s, prefix, len));
+        });
+        return std::make_pair(first, last);
+    }
+
+    std::pair<iterator, iterator> prefix_range(const _Char* prefix) const {
+        return prefix_range(prefix, _Traits::length(prefix));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    std::pair<iterator, iterator> prefix_range(const std::basic_string<_Char, _TTraits, _TAlloc>& prefix) const {
+        return prefix_range(prefix.data(), prefix.size());
+    }
+
+    iterator begin() const {
+        return (__m_size ? __bucket_begin(0) : end());
+    }
+
+    iterator end() const {
+        return iterator(this, __m_size, __m_data.size());
+    }
+
+    bool empty() const { return (__m_size == 0); }
+
+    size_t size() const { return __m_size; }
+
+    size_t bucket_count() const { return __m_headers.size(); }
+
+    // bytes of encoded strings and bucket offsets
+    size_t size_in_bytes() const {
+        return (__m_data.size() + __m_headers.size() * sizeof(size_t));
+    }
+
+    void swap(basic_front_coded_dictionary& other)
+    {
+        __m_data.swap(other.__m_data);
+        __m_headers.swap(other.__m_headers);
+        std::swap(__m_size, other.__m_size);
+    }
+
+private:
+    static int __compare(const string_type& s, const _Char* str, size_t len)
+    {
+        int r = _Traits::compare(s.data(), str, (std::min)(s.size(), len));
+        if (r != 0)
+            return r;
+        return ((s.size() < len) ? -1 : (s.size() > len));
+    }
+
+    static bool __has_prefix(const string_type& s, const _Char* prefix, size_t len) {
+        return (s.size() >= len && _Traits::compare(s.data(), prefix, len) == 0);
+    }
+
+    static size_t __common_prefix(const string_type& s, const _Char* str, size_t len)
+    {
+        size_t n = (std::min)(s.size(), len), i = 0;
+        while (i < n && _Traits::eq(s[i], str[i]))
+            i++;
+        return i;
+    }
+
+    void __put(size_t v) {
+        codec_type().encode_value(v, std::back_inserter(__m_data));
+    }
+
+    size_t __get(size_t& pos) const
+    {
+        size_t v;
+        raw_pointer first = __m_data.data() + pos;
+        raw_pointer last = codec_type().decode_value(first, __m_data.data() + __m_data.size(), v);
+        pos += (last - first);
+        return v;
+    }
+
+    void __append(string_type& prev, const _Char* str, size_t len)
+    {
+        size_t lcp = 0;
+        if (__m_size > 0)
+        {
+            int r = __compare(prev, str, len);
+            if (r > 0)
+                throw std::invalid_argument("front_coded_dictionary: input is not sorted");
+            if (r == 0)
+                return;
+            lcp = __common_prefix(prev, str, len);
+        }
+
+        if (__m_size % _BucketSize == 0) {
+            __m_headers.push_back(__m_data.size());
+            lcp = 0;
+        } else
+            __put(lcp);
+        __put(len - lcp);
+        __m_data.append(reinterpret_cast<raw_pointer>(str + lcp), (len - lcp) * sizeof(_Char));
+
+        prev.assign(str, len);
+        __m_size++;
+    }
+
+    // decodes entry at __m_pos into it, which holds its predecessor
+    void __decode(iterator& it, bool header) const
+    {
+        size_t pos = it.__m_pos;
+        size_t lcp = (header ? 0 : __get(pos));
+        size_t n = __get(pos);
+        it.__m_str.resize(lcp + n);
+        if (n > 0)
+            std::memcpy(&it.__m_str[lcp], __m_data.data() + pos, n * sizeof(_Char));
+        it.__m_pos = pos + n * sizeof(_Char);
+    }
+
+    void __next(iterator& it) const
+    {
+        if (++it.__m_id >= __m_size) {
+            it.__m_id = __m_size;
+            it.__m_pos = __m_data.size();
+            return;
+        }
+        __decode(it, (it.__m_id % _BucketSize == 0));
+    }
+
+    iterator __bucket_begin(size_t b) const
+    {
+        iterator it(this, b * _BucketSize, __m_headers[b]);
+        __decode(it, true);
+        return it;
+    }
+
+    // first string for which __before() is false; __before()
+    // must hold for a (possibly empty) prefix of the dictionary
+    template<class _Pred>
+    iterator __partition(_Pred __before) const
+    {
+        if (__m_size == 0)
+            return end();
+
+        // last bucket whose header is before
+        size_t lo = 0, hi = __m_headers.size();
+        iterator it;
+        while (hi - lo > 1)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            it = __bucket_begin(mid);
+            if (__before(it.__m_str))
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        it = __bucket_begin(lo);
+        if (lo == 0 && !__before(it.__m_str))
+            return it;
+        // buckets are contiguous, so stepping past the last
+        // string lands on the next header (or end)
+        size_t last = (std::min)((lo + 1) * _BucketSize, __m_size);
+        do {
+            __next(it);
+        } while (it.__m_id < last && __before(it.__m_str));
+        return it;
+    }
+
+private:
+    buffer_type __m_data;
+    header_map  __m_headers;  // bucket -> offset of its header
+    size_type   __m_size;
+};
+
+template<class _Char, class _Traits, class _Alloc, size_t _BucketSize>
+constexpr size_t basic_front_coded_dictionary<_Char, _Traits, _Alloc, _BucketSize>::npos;
+
+
+template<class _Char, class _Traits, class _Alloc, size_t _BucketSize>
+inline void swap(basic_front_coded_dictionary<_Char, _Traits, _Alloc, _BucketSize>& lhs,
+                 basic_front_coded_dictionary<_Char, _Traits, _Alloc, _BucketSize>& rhs) {
+    lhs.swap(rhs);
+}
+
+
+typedef basic_front_coded_dictionary<char, std::char_traits<char>, std::allocator<char> >           front_coded_dictionary;
+typedef basic_front_coded_dictionary<wchar_t, std::char_traits<wchar_t>, std::allocator<wchar_t> > wfront_coded_dictionary;
+
+_STDX_END
@@ -0,0 +1,281 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <stdexcept>
+
+#include "../platform/common.h"
+#include "stringset.hpp"
+
+#ifdef STDX_OS_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+_STDX_BEGIN
+
+/*!
+ * Read-only view of a stringset image written by
+ * basic_stringset::save(). Lookups go directly against
+ * the image, nothing is rebuilt or copied, so a large
+ * dictionary can be memory-mapped and served at once.
+ */
+template<
+    class _Char = char,
+    class _Length = uint16_t,
+    class _Traits = std::char_traits<_Char>
+>
+class basic_mapped_stringset
+{
+    typedef basic_stringset<_Char, _Length, _Traits> set_type;
+    typedef typename set_type::node node;
+    typedef typename set_type::raw_pointer raw_pointer;
+
+public:
+    typedef size_t size_type;
+    typedef _Length length_type;
+    typedef _Char char_type;
+    typedef typename set_type::iterator iterator;
+
+    basic_mapped_stringset() :
+        __m_header(nullptr), __m_buckets(nullptr), __m_ctrl(nullptr),
+        __m_buffer(nullptr), __m_map(nullptr), __m_mapsize(0) {
+    }
+
+    /*!
+     * View image placed at [data, data + size). Memory must
+     * outlive the view and be aligned to at least 8 bytes.
+     * With verify set all checksums are recomputed, which
+     * touches the whole image.
+     */
+    basic_mapped_stringset(const void* data, size_t size, bool verify = true) :
+        basic_mapped_stringset()
+    {
+        __attach(static_cast<raw_pointer>(data), size, verify);
+    }
+
+#ifdef STDX_OS_UNIX
+    /*!
+     * Map image file into memory
+     */
+    explicit basic_mapped_stringset(const std::string& path, bool verify = true) :
+        basic_mapped_stringset()
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("unable to open stringset image " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("unable to map stringset image " + path);
+        }
+
+        void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("unable to map stringset image " + path);
+
+        __m_map = p;
+        __m_mapsize = st.st_size;
+        try {
+            __attach(static_cast<raw_pointer>(p), __m_mapsize, verify);
+        } catch (...) {
+            __unmap();
+            throw;
+        }
+    }
+#endif
+
+    basic_mapped_stringset(basic_mapped_stringset&& other) :
+        basic_mapped_stringset() {
+        swap(other);
+    }
+
+    basic_mapped_stringset& operator=(basic_mapped_stringset&& other) {
+        basic_mapped_stringset tmp(std::move(other));
+        swap(tmp);
+        return (*this);
+    }
+
+    basic_mapped_stringset(const basic_mapped_stringset&) = delete;
+    basic_mapped_stringset& operator=(const basic_mapped_stringset&) = delete;
+
+    ~basic_mapped_stringset() {
+        __unmap();
+    }
+
+    void swap(basic_mapped_stringset& other)
+    {
+        std::swap(__m_header, other.__m_header);
+        std::swap(__m_buckets, other.__m_buckets);
+        std::swap(__m_ctrl, other.__m_ctrl);
+        std::swap(__m_buffer, other.__m_buffer);
+        std::swap(__m_map, other.__m_map);
+        std::swap(__m_mapsize, other.__m_mapsize);
+    }
+
+    iterator find(const _Char* str, size_t len) const
+    {
+        if (bucket_count() == 0)
+            return end();
+
+        size_t hs = set_type::__hash_bytes(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char));
+        size_t i = set_type::__probe(__m_buckets, __m_ctrl, bucket_count(), __m_buffer, hs, str, len);
+        return ((i == set_type::npos) ? end() : iterator(__m_buffer + __m_buckets[i].offset, __buffer_end()));
+    }
+
+    iterator find(const _Char* str) const {
+        return find(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    iterator find(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return find(key.data(), key.size());
+    }
+
+    size_t count(const _Char* str, size_t len) const {
+        return static_cast<size_t>(find(str, len) != end());
+    }
+
+    size_t count(const _Char* str) const {
+        return count(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    size_t count(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return count(key.data(), key.size());
+    }
+
+    iterator begin() const {
+        return iterator(__m_buffer, __buffer_end());
+    }
+
+    iterator end() const {
+        return iterator(__buffer_end(), __buffer_end());
+    }
+
+    bool empty() const { return (size() == 0); }
+
+    size_t size() const { return (__m_header ? __m_header->size : 0); }
+
+    size_t bucket_count() const { return (__m_header ? __m_header->bucket_count : 0); }
+
+private:
+    raw_pointer __buffer_end() const {
+        return (__m_header ? __m_buffer + __m_header->buffer_size : __m_buffer);
+    }
+
+    static void __fail(const char* what) {
+        throw std::runtime_error(std::string("invalid stringset image: ") + what);
+    }
+
+    void __attach(raw_pointer data, size_t size, bool verify)
+    {
+        if (size < sizeof(stringset_header))
+            __fail("truncated header");
+
+        const stringset_header* h = reinterpret_cast<const stringset_header*>(data);
+        if (std::memcmp(h->magic, "STDXSSET", sizeof(h->magic)) != 0)
+            __fail("bad magic");
+        if (h->version != stringset_header::current_version)
+            __fail("unsupported version");
+        if (h->header_checksum != stringset_header::checksum(h, offsetof(stringset_header, header_checksum)))
+            __fail("header checksum mismatch");
+        if (h->byte_order != 0x01020304 || h->word_size != sizeof(size_t) ||
+            h->char_size != sizeof(_Char) || h->length_size != sizeof(_Length))
+            __fail("incompatible layout");
+        if (h->hash_probe != set_type::__hash_probe())
+            __fail("incompatible hash function");
+
+        size_t nb = h->bucket_count;
+        size_t nc = (nb ? nb + set_type::group_width : 0);
+        size_t bucket_bytes = nb * sizeof(node);
+        size_t ctrl_bytes = stringset_header::align(nc);
+        if ((nb & (nb - 1)) != 0 ||
+            size - sizeof(stringset_header) < bucket_bytes + ctrl_bytes ||
+            size - sizeof(stringset_header) - bucket_bytes - ctrl_bytes < h->buffer_size)
+            __fail("truncated image");
+
+        raw_pointer buckets = data + sizeof(stringset_header);
+        raw_pointer ctrl = buckets + bucket_bytes;
+        raw_pointer buffer = ctrl + ctrl_bytes;
+        if (verify) {
+            if (h->buckets_checksum != stringset_header::checksum(buckets, bucket_bytes) ||
+                h->ctrl_checksum != stringset_header::checksum(ctrl, nc) ||
+                h->buffer_checksum != stringset_header::checksum(buffer, h->buffer_size))
+                __fail("checksum mismatch");
+        }
+
+        __m_header = h;
+        __m_buckets = reinterpret_cast<const node*>(buckets);
+        __m_ctrl = reinterpret_cast<const int8_t*>(ctrl);
+        __m_buffer = buffer;
+    }
+
+    void __unmap()
+    {
+#ifdef STDX_OS_UNIX
+        if (__m_map != nullptr)
+            ::munmap(__m_map, __m_mapsize);
+#endif
+        __m_map = nullptr;
+        __m_mapsize = 0;
+    }
+
+private:
+    const stringset_header* __m_header;
+    const node*   __m_buckets;
+    const int8_t* __m_ctrl;
+    raw_pointer   __m_buffer;
+    void*         __m_map;     // owned mapping, if any
+    size_t        __m_mapsize;
+};
+
+
+template<class _Char, class _Length, class _Traits>
+inline void swap(basic_mapped_stringset<_Char, _Length, _Traits>& lhs,
+                 basic_mapped_stringset<_Char, _Length, _Traits>& rhs) {
+    lhs.swap(rhs);
+}
+
+
+typedef basic_mapped_stringset<char, uint16_t, std::char_traits<char> >        mapped_stringset;
+typedef basic_mapped_stringset<wchar_t, uint16_t, std::char_traits<wchar_t> > mapped_wstringset;
+
+_STDX_END
@@ -29,8 +29,10 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <set>
+#include <vector>
 #include <unordered_map>
 #include <iterator>
 #include <algorithm>
@@ -122,7 +124,7 @@ public:
     typedef std::multiset<node, std::less<node>, node_allocator> nodelist;
 
 
-    typedef std::pair<const key_type*, typename nodelist::iterator> pair_type;
+    typedef std::pair<key_type* const, typename nodelist::iterator> pair_type;
     // type of nodemap allocator
     typedef typename _Alloc::template rebind<pair_type>::other nodemap_allocator;
     // type of node mapping
@@ -166,7 +168,7 @@ public:
     }
 
     size_type count(const _Key& key) const {
-        return __m_lookup.count(key);
+        return __m_lookup.count(key_pointer(key));
     }
 
     void reserve(size_type size) {
@@ -207,20 +209,13 @@ public:
         return __m_nodes.rend();
     }
 
+    // set elements are immutable
     const node_type& front() const {
-        return __m_nodes.front();
+        return *__m_nodes.begin();
     }
 
     const node_type& back() const {
-        return __m_nodes.back();
-    }
-
-    node_type& front() {
-        return __m_nodes.front();
-    }
-
-    node_type& back() {
-        return __m_nodes.back();
+        return *std::prev(__m_nodes.end());
     }
 
     const_iterator find(const _Key& key) {
@@ -246,7 +241,7 @@ public:
         if (mapIt == __m_lookup.end())
         {
             // insert node to set
-            auto it = __m_nodes.emplace(key, priority);
+            it = __m_nodes.emplace(key, priority);
             // update lookup
             __m_lookup[key_pointer(*it)] = it;
         }
@@ -261,12 +256,14 @@ public:
             // assign new priority
             *(const_cast<_Priority*>(&n.priority)) = priority;
 
+            // lookup is keyed by the node's own key, drop it first
+            __m_lookup.erase(mapIt);
             // erase node O(1)
             __m_nodes.erase(it);
             // insert node (O(logN))
-            auto it = __m_nodes.emplace(n);
+            it = __m_nodes.emplace(n);
             // insert into lookup
-            __m_lookup[key_pointer(*it)] = it;
+            __m_lookup.emplace(key_pointer(*it), it);
         }
 
         return it;
@@ -287,12 +284,14 @@ public:
         // assign new priority
         *(const_cast<_Priority*>(&n.priority)) = priority;
 
+        // lookup is keyed by the node's own key, drop it first
+        __m_lookup.erase(mapIt);
         // erase node O(1)
         __m_nodes.erase(mit);
         // insert node (O(logN))
         auto it = __m_nodes.emplace(n);
         // insert into lookup
-        __m_lookup[key_pointer(*it)] = it;
+        __m_lookup.emplace(key_pointer(*it), it);
 
         return it;
     }
@@ -318,6 +317,404 @@ private:
 
 
 
+/*!
+ * Heap backend of priority_set with the same interface.
+ *
+ * Nodes live in a contiguous _Arity-ary min-heap. Every node 
+ * carries a handle indexing dense array of heap positions, so 
+ * moving a node during sifting is one array store and never 
+ * hashes. Keys are mapped to handles by linear probing table 
+ * of handles, released handles are reused through free list,
+ * so insert and update do not allocate beyond amortized growth 
+ * of the arrays. An update is one lookup plus O(log n) moves; 
+ * front()/pop_front() give the lowest priority.
+ *
+ * Unlike priority_set, iteration runs in heap order, not
+ * sorted, back() and pop_back() are linear and equal priorities
+ * are not kept in insertion order.
+ */
+template<
+    class _Key,
+    class _Priority,
+    class _Hasher = std::hash<_Key>,
+    class _Comp = std::equal_to<_Key>,
+    class _Alloc = std::allocator<char>,
+    size_t _Arity = 4
+>
+class heap_priority_set
+{
+    static_assert(_Arity >= 2, "heap arity must be at least 2");
+
+    static const size_t npos = size_t(-1);
+
+public:
+    typedef _Key   key_type;
+    typedef _Priority priority_type;
+
+    typedef key_type value_type;
+
+    typedef _Hasher hasher;
+    typedef _Comp   key_equal;
+
+    typedef _Alloc allocator_type;
+
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+
+    typedef size_t size_type;
+
+    struct node
+    {
+        key_type key;
+        _Priority priority;
+
+        node(const key_type& k, const _Priority& p, size_t handle) :
+            key(k), priority(p), __m_handle(handle) {
+        }
+
+        friend inline bool operator< (const node& lhs, const node& rhs) {
+            return (lhs.priority < rhs.priority);
+        }
+
+    private:
+        friend class heap_priority_set;
+        size_t __m_handle; // index of position entry of this key
+    };
+    typedef node node_type;
+
+    // type of node allocator
+    typedef typename _Alloc::template rebind<node>::other node_allocator;
+    // type of heap
+    typedef std::vector<node, node_allocator> nodelist;
+
+private:
+    // position of node with handle, or next free handle,
+    // hash of key is kept to rehash and probe without keys
+    struct slot
+    {
+        size_t pos;
+        uint64_t hash;
+    };
+    typedef typename _Alloc::template rebind<slot>::other slot_allocator;
+    typedef std::vector<slot, slot_allocator> slotlist;
+
+    // table of handles + 1, zero marks empty bucket
+    typedef typename _Alloc::template rebind<size_t>::other bucket_allocator;
+    typedef std::vector<size_t, bucket_allocator> buckettable;
+
+public:
+    // nodes are immutable outside, as heap order depends on them
+    typedef typename nodelist::const_iterator iterator;
+    typedef typename nodelist::const_iterator const_iterator;
+    typedef typename nodelist::const_reverse_iterator reverse_iterator;
+    typedef typename nodelist::const_reverse_iterator const_reverse_iterator;
+
+    heap_priority_set() :
+        __m_free(npos) {
+    }
+
+    ~heap_priority_set() {
+    }
+
+    bool empty() const {
+        return __m_nodes.empty();
+    }
+
+    size_type size() const {
+        return __m_nodes.size();
+    }
+    size_type max_size() const {
+        return __m_nodes.max_size();
+    }
+
+    size_type bucket_count() const {
+        return __m_buckets.size();
+    }
+
+    size_type count(const _Key& key) const {
+        return (__find(key, __hash_of(key)) != npos ? 1 : 0);
+    }
+
+    void reserve(size_type size) {
+        __m_nodes.reserve(size);
+        __m_slots.reserve(size);
+        __reserve_buckets(size);
+    }
+
+    void clear() {
+        __m_nodes.clear();
+        __m_slots.clear();
+        std::fill(__m_buckets.begin(), __m_buckets.end(), size_t(0));
+        __m_free = npos;
+    }
+
+
+    const_iterator begin() const {
+        return __m_nodes.cbegin();
+    }
+
+    const_iterator end() const {
+        return __m_nodes.cend();
+    }
+
+    const_reverse_iterator rbegin() const {
+        return __m_nodes.crbegin();
+    }
+
+    const_reverse_iterator rend() const {
+        return __m_nodes.crend();
+    }
+
+    // node with the lowest priority
+    const node_type& front() const {
+        return __m_nodes.front();
+    }
+
+    // node with the highest priority: one of the leaves
+    const node_type& back() const {
+        return __m_nodes[__max_leaf()];
+    }
+
+    const_iterator find(const _Key& key) const {
+        size_t h = __find(key, __hash_of(key));
+        return (h == npos ? __m_nodes.end() : __m_nodes.begin() + __m_slots[h].pos);
+    }
+
+    void pop_back() {
+        __erase_at(__max_leaf());
+    }
+
+    void pop_front() {
+        __erase_at(0);
+    }
+
+    iterator insert(const _Key& key, const _Priority& priority)
+    {
+        const uint64_t hash = __hash_of(key);
+        size_t h = __find(key, hash);
+        if (h != npos)
+            return __update_at(__m_slots[h].pos, priority);
+
+        __reserve_buckets(__m_nodes.size() + 1);
+        h = __acquire(hash);
+        try {
+            __m_nodes.emplace_back(key, priority, h);
+        } catch (...) {
+            __release(h);
+            throw;
+        }
+        __m_slots[h].pos = __m_nodes.size() - 1;
+        __link(h);
+        return (__m_nodes.begin() + __sift_up(__m_nodes.size() - 1));
+    }
+
+    iterator update(const _Key& key, const priority_type priority)
+    {
+        size_t h = __find(key, __hash_of(key));
+        if (h == npos)
+            return __m_nodes.end();
+        return __update_at(__m_slots[h].pos, priority);
+    }
+
+    size_type erase(const _Key& key)
+    {
+        size_t h = __find(key, __hash_of(key));
+        if (h == npos)
+            return 0;
+        __erase_at(__m_slots[h].pos);
+        return 1;
+    }
+
+private:
+    static inline size_t __parent(size_t i) {
+        return ((i - 1) / _Arity);
+    }
+
+    static inline size_t __first_child(size_t i) {
+        return (i * _Arity + 1);
+    }
+
+    inline uint64_t __hash_of(const _Key& key) const {
+        return static_cast<uint64_t>(__m_hash(key)) * 0x9E3779B97F4A7C15ULL; // spread low bits
+    }
+
+    static inline size_t __home(uint64_t hash, size_t mask) {
+        return (static_cast<size_t>(hash >> 32) & mask);
+    }
+
+    // handle of key, npos if there is none
+    size_t __find(const _Key& key, uint64_t hash) const
+    {
+        if (__m_buckets.empty())
+            return npos;
+        const size_t mask = __m_buckets.size() - 1;
+        for (size_t b = __home(hash, mask); __m_buckets[b] != 0; b = (b + 1) & mask) {
+            size_t h = __m_buckets[b] - 1;
+            if (__m_slots[h].hash == hash && __m_eq(__m_nodes[__m_slots[h].pos].key, key))
+                return h;
+        }
+        return npos;
+    }
+
+    // keep load factor of bucket table at most 1/2
+    void __reserve_buckets(size_t n)
+    {
+        if (2 * n <= __m_buckets.size())
+            return;
+        size_t nbuckets = (__m_buckets.empty() ? 16 : __m_buckets.size());
+        while (nbuckets < 2 * n)
+            nbuckets *= 2;
+
+        buckettable buckets(nbuckets, size_t(0), __m_buckets.get_allocator());
+        __m_buckets.swap(buckets);
+        for (size_t b : buckets) {
+            if (b != 0)
+                __link(b - 1);
+        }
+    }
+
+    // put handle into first empty bucket of its probe sequence
+    void __link(size_t h)
+    {
+        const size_t mask = __m_buckets.size() - 1;
+        size_t b = __home(__m_slots[h].hash, mask);
+        while (__m_buckets[b] != 0)
+            b = (b + 1) & mask;
+        __m_buckets[b] = h + 1;
+    }
+
+    // remove handle from bucket table, following entries
+    // are shifted back so no probe sequence gets broken
+    void __unlink(size_t h)
+    {
+        const size_t mask = __m_buckets.size() - 1;
+        size_t b = __home(__m_slots[h].hash, mask);
+        while (__m_buckets[b] != h + 1)
+            b = (b + 1) & mask;
+        for (size_t next = (b + 1) & mask; __m_buckets[next] != 0; next = (next + 1) & mask) {
+            size_t home = __home(__m_slots[__m_buckets[next] - 1].hash, mask);
+            // entry may move to b if its home is not in (b, next]
+            if (((next - home) & mask) >= ((next - b) & mask)) {
+                __m_buckets[b] = __m_buckets[next];
+                b = next;
+            }
+        }
+        __m_buckets[b] = 0;
+    }
+
+    size_t __acquire(uint64_t hash)
+    {
+        size_t h = __m_free;
+        if (h != npos) {
+            __m_free = __m_slots[h].pos;
+        } else {
+            h = __m_slots.size();
+            __m_slots.push_back(slot());
+        }
+        __m_slots[h].hash = hash;
+        return h;
+    }
+
+    inline void __release(size_t h) {
+        __m_slots[h].pos = __m_free;
+        __m_free = h;
+    }
+
+    // node is moved, not swapped, along the path
+    // and dropped once into its final place
+    size_t __sift_up(size_t i)
+    {
+        node x = std::move(__m_nodes[i]);
+        while (i > 0)
+        {
+            size_t p = __parent(i);
+            if (!(x.priority < __m_nodes[p].priority))
+                break;
+            __place(i, std::move(__m_nodes[p]));
+            i = p;
+        }
+        __place(i, std::move(x));
+        return i;
+    }
+
+    size_t __sift_down(size_t i)
+    {
+        const size_t n = __m_nodes.size();
+        node x = std::move(__m_nodes[i]);
+        for (size_t c = __first_child(i); c < n; c = __first_child(i))
+        {
+            size_t last = (std::min)(c + _Arity, n);
+            size_t m = c;
+            for (size_t k = c + 1; k < last; k++)
+                if (__m_nodes[k].priority < __m_nodes[m].priority)
+                    m = k;
+            if (!(__m_nodes[m].priority < x.priority))
+                break;
+            __place(i, std::move(__m_nodes[m]));
+            i = m;
+        }
+        __place(i, std::move(x));
+        return i;
+    }
+
+    inline void __place(size_t i, node&& x) {
+        __m_nodes[i] = std::move(x);
+        __m_slots[__m_nodes[i].__m_handle].pos = i;
+    }
+
+    iterator __update_at(size_t i, const _Priority& priority)
+    {
+        node& x = __m_nodes[i];
+        if (priority < x.priority) {
+            x.priority = priority;
+            i = __sift_up(i);
+        } else if (x.priority < priority) {
+            x.priority = priority;
+            i = __sift_down(i);
+        }
+        return (__m_nodes.begin() + i);
+    }
+
+    void __erase_at(size_t i)
+    {
+        size_t h = __m_nodes[i].__m_handle;
+        __unlink(h);
+        __release(h);
+        if (i + 1 < __m_nodes.size()) {
+            __place(i, std::move(__m_nodes.back()));
+            __m_nodes.pop_back();
+            if (i > 0 && __m_nodes[i].priority < __m_nodes[__parent(i)].priority)
+                __sift_up(i);
+            else
+                __sift_down(i);
+        } else
+            __m_nodes.pop_back();
+    }
+
+    // maximum is among the leaves, the nodes past the last parent
+    size_t __max_leaf() const
+    {
+        const size_t n = __m_nodes.size();
+        size_t m = (n > 1 ? __parent(n - 1) + 1 : 0);
+        for (size_t k = m + 1; k < n; k++)
+            if (__m_nodes[m].priority < __m_nodes[k].priority)
+                m = k;
+        return m;
+    }
+
+private:
+    nodelist __m_nodes;
+    slotlist __m_slots;
+    buckettable __m_buckets;
+    size_t __m_free;   // head of free handle list
+    hasher __m_hash;
+    key_equal __m_eq;
+};
+
+
 
 
 
@@ -410,7 +807,7 @@ public:
     typedef std::multiset<node, std::less<node>, node_allocator> nodelist;
 
 
-    typedef std::pair<const key_type*, typename nodelist::iterator> pair_type;
+    typedef std::pair<key_type* const, typename nodelist::iterator> pair_type;
     // type of nodemap allocator
     typedef typename _Alloc::template rebind<pair_type>::other nodemap_allocator;
     // type of node mapping
@@ -458,7 +855,7 @@ public:
     }
 
     size_type count(const _Key& key) const {
-        return __m_lookup.count(key);
+        return __m_lookup.count(key_pointer(key));
     }
 
     void reserve(size_type size) {
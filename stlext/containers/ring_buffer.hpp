@@ -0,0 +1,482 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+
+#include "../platform/common.h"
+
+_STDX_BEGIN
+
+namespace detail
+{
+	// random access iterator over ring_buffer elements
+	// position is kept unmasked (head + index), so iterators
+	// compare and subtract as plain integers
+	template<class _Tp, class _Pointer, class _Reference>
+	class ring_buffer_iterator
+	{
+		template<class, class, class>
+		friend class ring_buffer_iterator;
+
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef _Tp        value_type;
+		typedef ptrdiff_t  difference_type;
+		typedef _Pointer   pointer;
+		typedef _Reference reference;
+
+		ring_buffer_iterator() :
+			__m_data(nullptr), __m_mask(0), __m_pos(0) {
+		}
+
+		ring_buffer_iterator(_Tp* data, size_t mask, size_t pos) :
+			__m_data(data), __m_mask(mask), __m_pos(pos) {
+		}
+
+		// iterator -> const_iterator conversion
+		template<class _P, class _R, 
+			class = typename std::enable_if<std::is_convertible<_P, _Pointer>::value>::type>
+		ring_buffer_iterator(const ring_buffer_iterator<_Tp, _P, _R>& other) :
+			__m_data(other.__m_data), __m_mask(other.__m_mask), __m_pos(other.__m_pos) {
+		}
+
+		inline reference operator*() const { return __m_data[__m_pos & __m_mask]; }
+		inline pointer operator->() const { return __m_data + (__m_pos & __m_mask); }
+		inline reference operator[](difference_type n) const { return __m_data[(__m_pos + n) & __m_mask]; }
+
+		inline ring_buffer_iterator& operator++() { ++__m_pos; return *this; }
+		inline ring_buffer_iterator& operator--() { --__m_pos; return *this; }
+
+		inline ring_buffer_iterator operator++(int) {
+			ring_buffer_iterator tmp(*this);
+			++__m_pos;
+			return tmp;
+		}
+
+		inline ring_buffer_iterator operator--(int) {
+			ring_buffer_iterator tmp(*this);
+			--__m_pos;
+			return tmp;
+		}
+
+		inline ring_buffer_iterator& operator+=(difference_type n) { __m_pos += n; return *this; }
+		inline ring_buffer_iterator& operator-=(difference_type n) { __m_pos -= n; return *this; }
+
+		inline ring_buffer_iterator operator+(difference_type n) const {
+			return ring_buffer_iterator(__m_data, __m_mask, __m_pos + n);
+		}
+
+		inline ring_buffer_iterator operator-(difference_type n) const {
+			return ring_buffer_iterator(__m_data, __m_mask, __m_pos - n);
+		}
+
+		friend inline ring_buffer_iterator operator+(difference_type n, const ring_buffer_iterator& it) {
+			return it + n;
+		}
+
+		template<class _P, class _R>
+		inline difference_type operator-(const ring_buffer_iterator<_Tp, _P, _R>& other) const {
+			return static_cast<difference_type>(__m_pos - other.__m_pos);
+		}
+
+		template<class _P, class _R>
+		inline bool operator==(const ring_buffer_iterator<_Tp, _P, _R>& other) const { return __m_pos == other.__m_pos; }
+		template<class _P, class _R>
+		inline bool operator!=(const ring_buffer_iterator<_Tp, _P, _R>& other) const { return __m_pos != other.__m_pos; }
+		template<class _P, class _R>
+		inline bool operator< (const ring_buffer_iterator<_Tp, _P, _R>& other) const { return __m_pos <  other.__m_pos; }
+		template<class _P, class _R>
+		inline bool operator> (const ring_buffer_iterator<_Tp, _P, _R>& other) const { return __m_pos >  other.__m_pos; }
+		template<class _P, class _R>
+		inline bool operator<=(const ring_buffer_iterator<_Tp, _P, _R>& other) const { return __m_pos <= other.__m_pos; }
+		template<class _P, class _R>
+		inline bool operator>=(const ring_buffer_iterator<_Tp, _P, _R>& other) const { return __m_pos >= other.__m_pos; }
+
+	private:
+		_Tp*   __m_data;
+		size_t __m_mask;
+		size_t __m_pos;
+	};
+}
+
+
+/*!
+ * \brief ring_buffer contiguous double-ended queue
+ *
+ * ring_buffer keeps elements in a single power-of-two sized
+ * array and addresses them by masking (head + index), so
+ * push/pop at both ends never allocate once capacity is 
+ * reserved and iteration never crosses chunk boundaries.
+ * 
+ * Capacity grows by doubling when an element is pushed into 
+ * a full buffer; circular_queue reserves the required capacity 
+ * up front and thus never triggers growth.
+ * 
+ * Ranges of trivially copyable elements are copied in and out
+ * with at most two memcpy calls (one per contiguous segment).
+ */
+template<
+	class _Tp,
+	class _Alloc = std::allocator<_Tp>
+>
+class ring_buffer
+{
+	typedef std::allocator_traits<_Alloc> alloc_traits;
+
+public:
+	typedef _Tp value_type;
+	typedef _Alloc allocator_type;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	typedef value_type& reference;
+	typedef const value_type& const_reference;
+	typedef value_type* pointer;
+	typedef const value_type* const_pointer;
+
+	typedef detail::ring_buffer_iterator<_Tp, pointer, reference> iterator;
+	typedef detail::ring_buffer_iterator<_Tp, const_pointer, const_reference> const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	explicit ring_buffer(const allocator_type& alloc = allocator_type()) :
+		__m_alloc(alloc), __m_data(nullptr), __m_capacity(0), __m_head(0), __m_size(0) {
+	}
+
+	// construct empty buffer able to hold at least n elements
+	explicit ring_buffer(size_type n, const allocator_type& alloc = allocator_type()) :
+		ring_buffer(alloc) {
+		reserve(n);
+	}
+
+	ring_buffer(const ring_buffer& other) :
+		ring_buffer(alloc_traits::select_on_container_copy_construction(other.__m_alloc)) {
+		reserve(other.__m_capacity);
+		append(other.begin(), other.end());
+	}
+
+	ring_buffer(ring_buffer&& other) noexcept :
+		__m_alloc(std::move(other.__m_alloc)), __m_data(other.__m_data), 
+		__m_capacity(other.__m_capacity), __m_head(other.__m_head), __m_size(other.__m_size) {
+		other.__m_data = nullptr;
+		other.__m_capacity = other.__m_head = other.__m_size = 0;
+	}
+
+	ring_buffer& operator=(ring_buffer other) {
+		swap(other);
+		return *this;
+	}
+
+	~ring_buffer() {
+		clear();
+		if (__m_data)
+			alloc_traits::deallocate(__m_alloc, __m_data, __m_capacity);
+	}
+
+	void swap(ring_buffer& other) noexcept {
+		using std::swap;
+		swap(__m_alloc, other.__m_alloc);
+		swap(__m_data, other.__m_data);
+		swap(__m_capacity, other.__m_capacity);
+		swap(__m_head, other.__m_head);
+		swap(__m_size, other.__m_size);
+	}
+
+	iterator begin() { return iterator(__m_data, __mask(), __m_head); }
+	const_iterator begin() const { return const_iterator(__m_data, __mask(), __m_head); }
+	const_iterator cbegin() const { return begin(); }
+
+	iterator end() { return iterator(__m_data, __mask(), __m_head + __m_size); }
+	const_iterator end() const { return const_iterator(__m_data, __mask(), __m_head + __m_size); }
+	const_iterator cend() const { return end(); }
+
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	const_reverse_iterator crbegin() const { return rbegin(); }
+
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+	const_reverse_iterator crend() const { return rend(); }
+
+	reference operator[](size_type i) { return __m_data[(__m_head + i) & __mask()]; }
+	const_reference operator[](size_type i) const { return __m_data[(__m_head + i) & __mask()]; }
+
+	reference at(size_type i) {
+		if (i >= __m_size)
+			throw std::out_of_range("ring_buffer::at(): index out of range");
+		return (*this)[i];
+	}
+
+	const_reference at(size_type i) const {
+		if (i >= __m_size)
+			throw std::out_of_range("ring_buffer::at(): index out of range");
+		return (*this)[i];
+	}
+
+	reference front() { return __m_data[__m_head]; }
+	const_reference front() const { return __m_data[__m_head]; }
+
+	reference back() { return (*this)[__m_size - 1]; }
+	const_reference back() const { return (*this)[__m_size - 1]; }
+
+	bool empty() const { return __m_size == 0; }
+	bool full() const { return __m_size == __m_capacity; }
+	size_type size() const { return __m_size; }
+	size_type capacity() const { return __m_capacity; }
+	size_type max_size() const { return alloc_traits::max_size(__m_alloc); }
+
+	allocator_type get_allocator() const { return __m_alloc; }
+
+	// make room for at least n elements,
+	// capacity is rounded up to the power of two
+	void reserve(size_type n) {
+		if (n <= __m_capacity)
+			return;
+		size_type cap = __round_capacity(n);
+		__relocate(alloc_traits::allocate(__m_alloc, cap), cap);
+	}
+
+	void clear() {
+		pop_front(__m_size);
+		__m_head = 0;
+	}
+
+	void push_back(const value_type& val) { emplace_back(val); }
+	void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+	void push_front(const value_type& val) { emplace_front(val); }
+	void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+	template<class... _Args>
+	reference emplace_back(_Args&&... args) 
+	{
+		if (__m_size == __m_capacity) {
+			// construct new element first: args may refer to an element of this buffer
+			size_type cap = __round_capacity(__m_size + 1);
+			pointer data = alloc_traits::allocate(__m_alloc, cap);
+			try {
+				alloc_traits::construct(__m_alloc, data + __m_size, std::forward<_Args>(args)...);
+			}
+			catch (...) {
+				alloc_traits::deallocate(__m_alloc, data, cap);
+				throw;
+			}
+			__relocate(data, cap);
+		}
+		else {
+			alloc_traits::construct(__m_alloc, __m_data + ((__m_head + __m_size) & __mask()), 
+									std::forward<_Args>(args)...);
+		}
+		++__m_size;
+		return back();
+	}
+
+	template<class... _Args>
+	reference emplace_front(_Args&&... args)
+	{
+		if (__m_size == __m_capacity) {
+			size_type cap = __round_capacity(__m_size + 1);
+			pointer data = alloc_traits::allocate(__m_alloc, cap);
+			try {
+				alloc_traits::construct(__m_alloc, data + cap - 1, std::forward<_Args>(args)...);
+			}
+			catch (...) {
+				alloc_traits::deallocate(__m_alloc, data, cap);
+				throw;
+			}
+			__relocate(data, cap);
+		}
+		else {
+			alloc_traits::construct(__m_alloc, __m_data + ((__m_head - 1) & __mask()),
+									std::forward<_Args>(args)...);
+		}
+		__m_head = (__m_head - 1) & __mask();
+		++__m_size;
+		return front();
+	}
+
+	void pop_front() {
+		alloc_traits::destroy(__m_alloc, __m_data + __m_head);
+		__m_head = (__m_head + 1) & __mask();
+		--__m_size;
+	}
+
+	void pop_back() {
+		--__m_size;
+		alloc_traits::destroy(__m_alloc, __m_data + ((__m_head + __m_size) & __mask()));
+	}
+
+	// remove n first elements
+	void pop_front(size_type n) {
+		__destroy(__m_head, n, std::is_trivially_destructible<_Tp>());
+		__m_head = (__m_head + n) & __mask();
+		__m_size -= n;
+	}
+
+	// remove n last elements
+	void pop_back(size_type n) {
+		__m_size -= n;
+		__destroy(__m_head + __m_size, n, std::is_trivially_destructible<_Tp>());
+	}
+
+	// append elements of range [first, last) to the back of buffer
+	template<class _InIt>
+	void append(_InIt first, _InIt last) {
+		__append(first, last, typename std::iterator_traits<_InIt>::iterator_category());
+	}
+
+	// copy n first elements to out
+	template<class _OutIt>
+	_OutIt read(_OutIt out, size_type n) const {
+		size_type pos = __m_head;
+		size_type len = (std::min)(n, __m_capacity - pos);
+		out = __copy_out(__m_data + pos, len, out, __is_memcpy_able<_OutIt, _Tp*>());
+		return __copy_out(__m_data, n - len, out, __is_memcpy_able<_OutIt, _Tp*>());
+	}
+
+private:
+	// raw pointer ranges of trivially copyable elements are copied with memcpy
+	template<class _It, class _Ptr = const _Tp*>
+	using __is_memcpy_able = std::integral_constant<bool,
+		std::is_trivially_copyable<_Tp>::value &&
+		(std::is_same<_It, _Tp*>::value || std::is_same<_It, _Ptr>::value)>;
+
+	inline size_type __mask() const { 
+		return __m_capacity - 1; 
+	}
+
+	static inline size_type __round_capacity(size_type n) {
+		size_type cap = 8;
+		while (cap < n)
+			cap <<= 1;
+		return cap;
+	}
+
+	// move elements into new storage starting at offset 0
+	// and release old storage
+	void __relocate(pointer data, size_type cap) 
+	{
+		if (__m_data) {
+			for (size_type i = 0; i < __m_size; i++) {
+				pointer p = __m_data + ((__m_head + i) & __mask());
+				alloc_traits::construct(__m_alloc, data + i, std::move(*p));
+				alloc_traits::destroy(__m_alloc, p);
+			}
+			alloc_traits::deallocate(__m_alloc, __m_data, __m_capacity);
+		}
+		__m_data = data;
+		__m_capacity = cap;
+		__m_head = 0;
+	}
+
+	void __destroy(size_type, size_type, std::true_type) {
+	}
+
+	void __destroy(size_type pos, size_type n, std::false_type) {
+		for (; n > 0; --n, ++pos)
+			alloc_traits::destroy(__m_alloc, __m_data + (pos & __mask()));
+	}
+
+	template<class _InIt>
+	void __append(_InIt first, _InIt last, std::input_iterator_tag) {
+		for (; first != last; ++first)
+			emplace_back(*first);
+	}
+
+	template<class _FwdIt>
+	void __append(_FwdIt first, _FwdIt last, std::forward_iterator_tag) 
+	{
+		size_type n = std::distance(first, last);
+		reserve(__m_size + n);
+
+		// first segment: from the tail up to the end of storage, 
+		// second segment: wrapped part from the start of storage
+		size_type pos = (__m_head + __m_size) & __mask();
+		size_type len = (std::min)(n, __m_capacity - pos);
+		first = __copy_in(first, len, __m_data + pos, __is_memcpy_able<_FwdIt>());
+		__m_size += len;
+		__copy_in(first, n - len, __m_data, __is_memcpy_able<_FwdIt>());
+		__m_size += n - len;
+	}
+
+	template<class _FwdIt>
+	static _FwdIt __copy_in(_FwdIt first, size_type n, pointer dst, std::true_type) {
+		if (n > 0)
+			std::memcpy(dst, first, n * sizeof(_Tp));
+		return first + n;
+	}
+
+	template<class _FwdIt>
+	_FwdIt __copy_in(_FwdIt first, size_type n, pointer dst, std::false_type) {
+		size_type i = 0;
+		try {
+			for (; i < n; ++i, ++first)
+				alloc_traits::construct(__m_alloc, dst + i, *first);
+		}
+		catch (...) {
+			while (i > 0)
+				alloc_traits::destroy(__m_alloc, dst + --i);
+			throw;
+		}
+		return first;
+	}
+
+	template<class _OutIt>
+	static _OutIt __copy_out(const_pointer src, size_type n, _OutIt out, std::true_type) {
+		if (n > 0)
+			std::memcpy(out, src, n * sizeof(_Tp));
+		return out + n;
+	}
+
+	template<class _OutIt>
+	static _OutIt __copy_out(const_pointer src, size_type n, _OutIt out, std::false_type) {
+		return std::copy(src, src + n, out);
+	}
+
+private:
+	allocator_type __m_alloc;
+	pointer   __m_data;
+	size_type __m_capacity;
+	size_type __m_head;
+	size_type __m_size;
+};
+
+template<class _Tp, class _Alloc>
+inline void swap(ring_buffer<_Tp, _Alloc>& x, ring_buffer<_Tp, _Alloc>& y) noexcept {
+	x.swap(y);
+}
+
+_STDX_END
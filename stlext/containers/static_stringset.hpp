@@ -0,0 +1,464 @@
+// Copyright (c) 2016, Michael Polukarov (Russia).
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// - Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+//
+// - Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer listed
+//   in this license in the documentation and/or other materials
+//   provided with the distribution.
+//
+// - Neither the name of the copyright holders nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstring>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <stdexcept>
+
+#include "../platform/common.h"
+#include "stringset.hpp"
+
+#ifndef _STATIC_STRINGSET_BUCKET_SIZE
+#define _STATIC_STRINGSET_BUCKET_SIZE 4    // average keys per displacement bucket
+#endif
+
+#ifndef _STATIC_STRINGSET_MAX_ATTEMPTS
+#define _STATIC_STRINGSET_MAX_ATTEMPTS 16  // seeds tried before giving up
+#endif
+
+
+_STDX_BEGIN
+
+/*!
+ * Immutable set of strings indexed by a minimal perfect hash.
+ *
+ * Strings are kept in the same length-prefixed layout as
+ * basic_stringset. Keys are spread over small buckets and every
+ * bucket gets a 16-bit pilot, chosen so that all its keys land in
+ * distinct slots (hash and displace). Slots are built for 1% more
+ * keys than stored; the few keys landing past size() are remapped
+ * to the free slots below it, so index() is a bijection onto
+ * [0, size()). A lookup costs one hash, one slot and one compare.
+ */
+template<
+    class _Char = char,
+    class _Length = uint16_t,
+    class _Traits = std::char_traits<_Char>,
+    class _Alloc = std::allocator<_Char>
+>
+class basic_static_stringset
+{
+    typedef basic_stringset<_Char, _Length, _Traits, _Alloc> set_type;
+
+    typedef std::basic_string<
+        char,
+        std::char_traits<char>,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<char>
+    > buffer_type;
+
+    typedef std::vector<
+        uint16_t,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<uint16_t>
+    > pilot_map;
+
+    typedef std::vector<
+        uint32_t,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<uint32_t>
+    > offset_map;
+
+    typedef const char* raw_pointer;
+
+public:
+    typedef size_t size_type;
+    typedef _Length length_type;
+    typedef _Char char_type;
+    typedef typename set_type::iterator iterator;
+
+    static constexpr size_t npos = size_t(-1);
+    static constexpr size_t max_length = set_type::max_length;
+
+    basic_static_stringset() :
+        __m_seed(0), __m_slots(0) {
+    }
+
+    /*!
+     * Build from a range of strings (or anything having
+     * data() and size()). Duplicates are stored once.
+     */
+    template<class _InIt>
+    basic_static_stringset(_InIt first, _InIt last) :
+        basic_static_stringset()
+    {
+        for (; first != last; ++first)
+            __append(first->data(), first->size());
+        __build();
+    }
+
+    template<class _OtherAlloc>
+    explicit basic_static_stringset(const basic_stringset<_Char, _Length, _Traits, _OtherAlloc>& s) :
+        basic_static_stringset(s.begin(), s.end()) {
+    }
+
+    /*!
+     * Position of the string in [0, size()) or npos
+     */
+    size_t index(const _Char* str, size_t len) const
+    {
+        if (__m_offsets.empty())
+            return npos;
+
+        uint64_t hs = __hash_bytes(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char), __m_seed);
+        size_t i = __slot(hs, __m_pilots[__bucket(hs, __m_pilots.size())], __m_slots);
+        if (i >= __m_offsets.size())
+            i = __m_remap[i - __m_offsets.size()];
+        return (__equal(__m_offsets[i], str, len) ? i : npos);
+    }
+
+    size_t index(const _Char* str) const {
+        return index(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    size_t index(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return index(key.data(), key.size());
+    }
+
+    iterator find(const _Char* str, size_t len) const
+    {
+        size_t i = index(str, len);
+        return ((i == npos) ? end() : iterator(__m_buffer.data() + __m_offsets[i],
+                                               __m_buffer.data() + __m_buffer.size()));
+    }
+
+    iterator find(const _Char* str) const {
+        return find(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    iterator find(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return find(key.data(), key.size());
+    }
+
+    size_t count(const _Char* str, size_t len) const {
+        return static_cast<size_t>(index(str, len) != npos);
+    }
+
+    size_t count(const _Char* str) const {
+        return count(str, _Traits::length(str));
+    }
+
+    template<class _TTraits, class _TAlloc>
+    size_t count(const std::basic_string<_Char, _TTraits, _TAlloc>& key) const {
+        return count(key.data(), key.size());
+    }
+
+    iterator begin() const {
+        return iterator(__m_buffer.data(),
+                        __m_buffer.data() + __m_buffer.size());
+    }
+
+    iterator end() const {
+        return iterator(__m_buffer.data() + __m_buffer.size(),
+                        __m_buffer.data() + __m_buffer.size());
+    }
+
+    bool empty() const { return __m_offsets.empty(); }
+
+    size_t size() const { return __m_offsets.size(); }
+
+    /*!
+     * Bytes taken by the hash function itself,
+     * i.e. besides strings and their offsets
+     */
+    size_t hash_size() const {
+        return (__m_pilots.size() * sizeof(uint16_t) + __m_remap.size() * sizeof(uint32_t));
+    }
+
+    void swap(basic_static_stringset& other)
+    {
+        __m_buffer.swap(other.__m_buffer);
+        __m_offsets.swap(other.__m_offsets);
+        __m_pilots.swap(other.__m_pilots);
+        __m_remap.swap(other.__m_remap);
+        std::swap(__m_seed, other.__m_seed);
+        std::swap(__m_slots, other.__m_slots);
+    }
+
+private:
+    static inline uint64_t __hash_bytes(raw_pointer p, size_t n, uint64_t seed) {
+#if defined(STDX_CMPLR_MSVC) || !defined(__SIZEOF_INT128__)
+        return stringset_header::checksum(p, n, 0xcbf29ce484222325ULL ^ seed);
+#else
+        return std::_Hash_bytes(p, n, static_cast<size_t>(seed));
+#endif
+    }
+
+    // maps uniformly distributed x to [0, n)
+    static inline size_t __range(uint64_t x, size_t n) {
+#ifdef __SIZEOF_INT128__
+        return static_cast<size_t>((static_cast<unsigned __int128>(x) * n) >> 64);
+#else
+        return static_cast<size_t>(x % n);
+#endif
+    }
+
+    // bucket is taken from the low half of the hash,
+    // slot from the whole hash mixed with the pilot
+    static inline size_t __bucket(uint64_t hs, size_t n) {
+        return __range((hs & 0xFFFFFFFFULL) << 32, n);
+    }
+
+    // the product after xor matters: with a plain xor two keys
+    // would keep the same relative slots under every pilot
+    static inline size_t __slot(uint64_t hs, uint16_t pilot, size_t n)
+    {
+        uint64_t x = (pilot + 1) * 0x9E3779B97F4A7C15ULL;
+        x ^= (x >> 29);
+        x = (hs ^ x) * 0xD6E8FEB86659FD93ULL;
+        return __range(x ^ (x >> 32), n);
+    }
+
+    inline bool __equal(uint32_t offset, const _Char* str, size_t len) const
+    {
+        raw_pointer ptr = __m_buffer.data() + offset;
+        length_type n;
+        std::memcpy(&n, ptr, sizeof(n));
+        return (n == len && std::memcmp(ptr + sizeof(length_type), str, len * sizeof(_Char)) == 0);
+    }
+
+    void __append(const _Char* str, size_t len)
+    {
+        if (len > max_length)
+            throw std::length_error("string is too long");
+        if (__m_buffer.size() + sizeof(length_type) + len * sizeof(_Char) > UINT32_MAX)
+            throw std::length_error("static_stringset is too large");
+
+        length_type n = static_cast<length_type>(len);
+        __m_offsets.push_back(static_cast<uint32_t>(__m_buffer.size()));
+        __m_buffer.append(reinterpret_cast<raw_pointer>(&n), sizeof(n));
+        __m_buffer.append(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char));
+    }
+
+    struct entry
+    {
+        uint64_t hash_code;
+        uint32_t offset;
+        uint32_t bucket;
+    };
+
+    // one pass over duplicates; false if two
+    // different strings have the same hash
+    bool __unique(std::vector<entry>& entries)
+    {
+        std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+            return (a.hash_code < b.hash_code || (a.hash_code == b.hash_code && a.offset < b.offset));
+        });
+
+        size_t k = 0;
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (k > 0 && entries[k - 1].hash_code == entries[i].hash_code)
+            {
+                raw_pointer p = __m_buffer.data() + entries[i].offset;
+                length_type n;
+                std::memcpy(&n, p, sizeof(n));
+                if (!__equal(entries[k - 1].offset, reinterpret_cast<const _Char*>(p + sizeof(n)), n))
+                    return false;
+                continue;
+            }
+            entries[k++] = entries[i];
+        }
+        entries.resize(k);
+        return true;
+    }
+
+    // drop duplicates from the buffer, keeping insertion order
+    void __shrink(std::vector<entry>& entries)
+    {
+        std::vector<uint32_t> order(entries.size());
+        for (size_t i = 0; i < entries.size(); i++)
+            order[i] = static_cast<uint32_t>(i);
+        std::sort(order.begin(), order.end(), [&entries](uint32_t a, uint32_t b) {
+            return (entries[a].offset < entries[b].offset);
+        });
+
+        buffer_type buffer;
+        for (uint32_t i : order)
+        {
+            raw_pointer p = __m_buffer.data() + entries[i].offset;
+            length_type n;
+            std::memcpy(&n, p, sizeof(n));
+            entries[i].offset = static_cast<uint32_t>(buffer.size());
+            buffer.append(p, sizeof(n) + n * sizeof(_Char));
+        }
+        __m_buffer.swap(buffer);
+    }
+
+    // place every bucket, largest first; false if some bucket
+    // has no pilot sending all its keys to free slots
+    bool __place(std::vector<entry>& entries, std::vector<uint32_t>& slot_of)
+    {
+        const size_t nb = __m_pilots.size();
+        for (entry& e : entries)
+            e.bucket = static_cast<uint32_t>(__bucket(e.hash_code, nb));
+
+        std::vector<uint32_t> first(nb + 1, 0);
+        for (const entry& e : entries)
+            first[e.bucket + 1]++;
+        for (size_t b = 0; b < nb; b++)
+            first[b + 1] += first[b];
+
+        std::vector<uint32_t> keys(entries.size());
+        std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+        for (size_t i = 0; i < entries.size(); i++)
+            keys[fill[entries[i].bucket]++] = static_cast<uint32_t>(i);
+
+        std::vector<uint32_t> order(nb);
+        for (size_t b = 0; b < nb; b++)
+            order[b] = static_cast<uint32_t>(b);
+        std::stable_sort(order.begin(), order.end(), [&first](uint32_t a, uint32_t b) {
+            return (first[a + 1] - first[a] > first[b + 1] - first[b]);
+        });
+
+        std::vector<bool> taken(__m_slots, false);
+        std::vector<size_t> pos;
+        for (uint32_t b : order)
+        {
+            const uint32_t* kb = keys.data() + first[b];
+            const size_t kn = first[b + 1] - first[b];
+            if (kn == 0)
+                break;
+
+            bool placed = false;
+            for (uint32_t pilot = 0; pilot <= UINT16_MAX && !placed; pilot++)
+            {
+                pos.clear();
+                for (size_t j = 0; j < kn; j++) {
+                    size_t i = __slot(entries[kb[j]].hash_code, static_cast<uint16_t>(pilot), __m_slots);
+                    if (taken[i] || std::find(pos.begin(), pos.end(), i) != pos.end())
+                        break;
+                    pos.push_back(i);
+                }
+                if (pos.size() == kn)
+                {
+                    for (size_t j = 0; j < kn; j++) {
+                        taken[pos[j]] = true;
+                        slot_of[kb[j]] = static_cast<uint32_t>(pos[j]);
+                    }
+                    __m_pilots[b] = static_cast<uint16_t>(pilot);
+                    placed = true;
+                }
+            }
+            if (!placed)
+                return false;
+        }
+        return true;
+    }
+
+    void __build()
+    {
+        std::vector<entry> entries(__m_offsets.size());
+        std::vector<uint32_t> slot_of;
+        for (uint64_t seed = 0; seed < _STATIC_STRINGSET_MAX_ATTEMPTS; seed++)
+        {
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                raw_pointer p = __m_buffer.data() + __m_offsets[i];
+                length_type n;
+                std::memcpy(&n, p, sizeof(n));
+                entries[i].hash_code = __hash_bytes(p + sizeof(n), n * sizeof(_Char), seed);
+                entries[i].offset = __m_offsets[i];
+            }
+            if (!__unique(entries)) {
+                entries.resize(__m_offsets.size());
+                continue;
+            }
+
+            const size_t n = entries.size();
+            __m_seed = seed;
+            __m_slots = n + n / 100 + 1;
+            __m_pilots.assign(n / _STATIC_STRINGSET_BUCKET_SIZE + 1, 0);
+            slot_of.assign(n, 0);
+            if (__place(entries, slot_of))
+            {
+                if (n != __m_offsets.size())
+                    __shrink(entries);
+
+                // keys past n move to the free slots below n
+                std::vector<bool> used(n, false);
+                for (uint32_t s : slot_of)
+                    if (s < n)
+                        used[s] = true;
+
+                __m_remap.assign(__m_slots - n, 0);
+                size_t hole = 0;
+                for (uint32_t& s : slot_of)
+                {
+                    if (s < n)
+                        continue;
+                    while (used[hole])
+                        hole++;
+                    used[hole] = true;
+                    __m_remap[s - n] = static_cast<uint32_t>(hole);
+                    s = static_cast<uint32_t>(hole);
+                }
+
+                __m_offsets.assign(n, 0);
+                for (size_t i = 0; i < n; i++)
+                    __m_offsets[slot_of[i]] = entries[i].offset;
+                if (n == 0)
+                    __m_pilots.clear();
+                return;
+            }
+            entries.resize(__m_offsets.size());
+        }
+        throw std::runtime_error("unable to build perfect hash");
+    }
+
+private:
+    buffer_type __m_buffer;
+    offset_map  __m_offsets;  // slot -> string
+    pilot_map   __m_pilots;   // bucket -> displacement
+    offset_map  __m_remap;    // slots past size() -> free slot
+    uint64_t    __m_seed;
+    size_t      __m_slots;    // slots addressed by pilots
+};
+
+template<class _Char, class _Length, class _Traits, class _Alloc>
+constexpr size_t basic_static_stringset<_Char, _Length, _Traits, _Alloc>::npos;
+
+
+template<class _Char, class _Length, class _Traits, class _Alloc>
+inline void swap(basic_static_stringset<_Char, _Length, _Traits, _Alloc>& lhs,
+                 basic_static_stringset<_Char, _Length, _Traits, _Alloc>& rhs) {
+    lhs.swap(rhs);
+}
+
+
+typedef basic_static_stringset<char, uint16_t, std::char_traits<char>, std::allocator<char> >           static_stringset;
+typedef basic_static_stringset<wchar_t, uint16_t, std::char_traits<wchar_t>, std::allocator<wchar_t> > static_wstringset;
+
+_STDX_END
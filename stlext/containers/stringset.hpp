@@ -30,11 +30,13 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstring>
 #include <climits>
 
 #include <vector>
 #include <string>
+#include <ostream>
 
 #include <stdexcept>
 
@@ -42,10 +44,67 @@
 #include <experimental/string_view>
 
 #include "../platform/common.h"
+#include "../platform/bits.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef STDX_OS_UNIX
+#include <unistd.h>
+#include <cerrno>
+#endif
 
 
 _STDX_BEGIN
 
+/*!
+ * Header of a stringset image written by basic_stringset::save().
+ * Image consists of the header followed by the bucket array, the
+ * control bytes and the string buffer, each section aligned to
+ * 8 bytes. Image is only valid on the same kind of machine it was
+ * built on, that's what byte_order/word_size/hash_probe verify.
+ */
+struct stringset_header
+{
+    static constexpr uint32_t current_version = 1;
+
+    char     magic[8];         // "STDXSSET"
+    uint32_t version;
+    uint32_t byte_order;       // 0x01020304 as written by the producer
+    uint8_t  char_size;
+    uint8_t  length_size;
+    uint8_t  word_size;        // sizeof(size_t)
+    uint8_t  reserved;
+    uint32_t hash_probe;       // hash of a fixed string: hash function must match
+    uint64_t size;             // number of strings
+    uint64_t bucket_count;
+    uint64_t buffer_size;
+    uint64_t buckets_checksum;
+    uint64_t ctrl_checksum;
+    uint64_t buffer_checksum;
+    uint64_t header_checksum;  // of all fields above
+
+    // FNV-1a over a byte range
+    static uint64_t checksum(const void* p, size_t n, uint64_t h = 0xcbf29ce484222325ULL)
+    {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; i++)
+            h = (h ^ b[i]) * 0x100000001b3ULL;
+        return h;
+    }
+
+    static size_t align(size_t n) {
+        return (n + 7) & ~size_t(7);
+    }
+};
+
+template<class _Char, class _Length, class _Traits>
+class basic_mapped_stringset;
+
+template<class _Char, class _Length, class _Traits, class _Alloc>
+class basic_static_stringset;
+
 template<
     class _Char = char,
     class _Length = uint16_t,
@@ -54,6 +113,8 @@ template<
 >
 class basic_stringset
 {
+    friend class basic_mapped_stringset<_Char, _Length, _Traits>;
+
 private:
     struct node
     {
@@ -72,16 +133,33 @@ private:
     typedef std::basic_string<
         char,
         std::char_traits<char>,
-        _Alloc
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<char>
     > buffer_type;
 
     typedef std::vector<
         node,
-        _Alloc
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<node>
     > bucket_map;
 
+    // one control byte per bucket: either a state below
+    // or 7 low bits of the hash of a string in the bucket
+    typedef std::vector<
+        int8_t,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<int8_t>
+    > control_map;
+
     typedef const char* raw_pointer;
 
+    static constexpr int8_t ctrl_empty   = -128;
+    static constexpr int8_t ctrl_deleted = -2;
+
+    // buckets are probed in groups of 16 control bytes;
+    // first group is mirrored past the end, so a group
+    // can be loaded at any position without wrapping
+    static constexpr size_t group_width = 16;
+    static constexpr size_t npos = size_t(-1);
+    static constexpr double max_load = 0.8;
+
 public:
     typedef size_t size_type;
     typedef _Length length_type;
@@ -91,13 +169,17 @@ public:
 
     typedef std::basic_string<_Char, _Traits, _Alloc> string_type;
 
-    static constexpr size_t max_length = (1ULL << sizeof(length_type) * CHAR_BIT) - 1;
+    // the highest bit of the length prefix marks an erased string
+    static constexpr length_type dead_bit = length_type(1) << (sizeof(length_type) * CHAR_BIT - 1);
+    static constexpr size_t max_length = dead_bit - 1;
 
 
 
     class iterator
     {
         friend class basic_stringset;
+        friend class basic_mapped_stringset<_Char, _Length, _Traits>;
+        friend class basic_static_stringset<_Char, _Length, _Traits, _Alloc>;
 
         //typedef stdx::basic_string_view<_Char, _Traits> view_type;
         typedef std::experimental::basic_string_view<_Char, _Traits> view_type;
@@ -110,12 +192,16 @@ public:
 
         inline iterator& assign(raw_pointer p)
         {
+            length_type n = 0;
+            // skip erased strings (length prefix may be unaligned)
+            while (p < __m_end && (std::memcpy(&n, p, sizeof(n)), (n & dead_bit)))
+                p += sizeof(length_type) + (n & ~dead_bit) * sizeof(_Char);
+
             if (p >= __m_end)
                 __m_view = std::move(view_type(reinterpret_cast<const _Char*>(p), 0));
             else {
                 __m_view = std::move(view_type(
-                    reinterpret_cast<const _Char*>(p + sizeof(length_type)),
-                    *reinterpret_cast<const length_type*>(p) / sizeof(_Char)
+                    reinterpret_cast<const _Char*>(p + sizeof(length_type)), n
                  ));
             };
             return (*this);
@@ -175,32 +261,20 @@ public:
         raw_pointer __m_end;
     };
 
-    basic_stringset() : __m_size(0) {}
+    basic_stringset() : __m_size(0), __m_deleted(0), __m_garbage(0) {}
 
     void reserve(size_t n)
     {
-        __m_buffer.reserve(n * 8);
-
-        if (__m_size == 0) {
-            __m_buckets.resize(n);
-            return;
-        }
-
-        if ((double)n > (__m_buckets.size() / max_load_factor()))
-            __rehash(n);
+        reserve(n, n * 8);
     }
 
     void reserve(size_t n, size_t length)
     {
         __m_buffer.reserve(length);
 
-        if (__m_size == 0) {
-            __m_buckets.resize(n);
-            return;
-        }
-
-        if ((double)n > (__m_buckets.size() / max_load_factor()))
-            __rehash(n);
+        size_t buckets = __bucket_count_for(n);
+        if (buckets > __m_buckets.size())
+            __rehash(buckets);
     }
 
     template<class _TTraits, class _TAlloc>
@@ -221,24 +295,30 @@ public:
             return end();
 
         if (__m_buckets.empty()) {
-            __m_buckets.resize(16);
+            __rehash(group_width);
         } else {
-            if (load_factor() > max_load_factor()) {
-                __rehash(__m_buckets.size() * 2);
+            if (__m_garbage > __m_buffer.size() * max_garbage_factor())
+                compact();
+            // erased buckets still lengthen probe sequences
+            if ((__m_size + __m_deleted) >= __m_buckets.size() * max_load_factor()) {
+                __rehash(__m_deleted > __m_size ? __m_buckets.size() : __m_buckets.size() * 2);
             }
         }
-        size_t hs = __hash_bytes(str, len * sizeof(_Char));
-        const node* where = __find_free(hs, str, len);
-        if (where != nullptr)
-        {
-            length_type n = static_cast<length_type>(len);
-            new ((void*)where) node(__m_buffer.size(), hs);
-            __m_buffer.append(reinterpret_cast<raw_pointer>(&n), sizeof(n));
-            __m_buffer.append(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char));
-            ++__m_size;
-            return iterator(__m_buffer.data() + where->offset, __m_buffer.data() + (where->offset + len * sizeof(_Char)));
-        }
-        return end();
+        size_t hs = __hash_bytes(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char));
+        size_t i = __find_free(hs, str, len);
+        if (i == npos)
+            return end();
+
+        if (__m_ctrl[i] == ctrl_deleted)
+            --__m_deleted;
+        __set_ctrl(i, __h2(hs));
+        __m_buckets[i] = node(__m_buffer.size(), hs);
+
+        length_type n = static_cast<length_type>(len);
+        __m_buffer.append(reinterpret_cast<raw_pointer>(&n), sizeof(n));
+        __m_buffer.append(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char));
+        ++__m_size;
+        return iterator(__m_buffer.data() + __m_buckets[i].offset, __m_buffer.data() + __m_buffer.size());
     }
 
     template<class _InIt>
@@ -265,9 +345,9 @@ public:
         if (empty() || len == 0 || str == nullptr)
             return end();
 
-        size_t hs = __hash_bytes(str, len * sizeof(_Char));
-        const node* p = __find_node(hs, str, len);
-        return ((p == nullptr) ? end() : iterator(__m_buffer.data() + p->offset, __m_buffer.data() + __m_buffer.size()));
+        size_t hs = __hash_bytes(reinterpret_cast<raw_pointer>(str), len * sizeof(_Char));
+        size_t i = __find_node(hs, str, len);
+        return ((i == npos) ? end() : iterator(__m_buffer.data() + __m_buckets[i].offset, __m_buffer.data() + __m_buffer.size()));
     }
 
 
@@ -283,27 +363,39 @@ public:
     size_t count(const_char_ptr key, size_t len) const {
         if ((len > max_length || len == 0) || key == nullptr || empty())
             return 0;
-        size_t hs = __hash_bytes(key, len * sizeof(_Char));
-        return static_cast<size_t>(__find_node(hs, key, len) != nullptr);
+        size_t hs = __hash_bytes(reinterpret_cast<raw_pointer>(key), len * sizeof(_Char));
+        return static_cast<size_t>(__find_node(hs, key, len) != npos);
     }
 
+    /*!
+     * Erase string at position where. String bytes are
+     * not moved: erased string is marked dead in place and
+     * its bucket becomes a tombstone, so other iterators
+     * remain valid. Dead bytes are reclaimed by compact(),
+     * which insert() calls once garbage exceeds the
+     * max_garbage_factor() share of the buffer.
+     */
     iterator erase(iterator where)
     {
-        std::ptrdiff_t offset = ((raw_pointer)where->data() - __m_buffer.data()) - sizeof(length_type);
-        size_t size = where->size() + sizeof(length_type);
-        for (auto it = __m_buckets.begin(); it != __m_buckets.end(); ++it) {
-            if (it->offset == offset) {
-                it->offset = -1; // mark as free slot
-                continue;
-            }
-            if (it->offset > offset)
-                it->offset -= size;
-        }
-        auto first = __m_buffer.begin() + offset;
-        auto last = first + size;
-        auto pos = __m_buffer.erase(first, last);
+        raw_pointer p = reinterpret_cast<raw_pointer>(where->data());
+        std::ptrdiff_t offset = (p - __m_buffer.data()) - sizeof(length_type);
+        size_t bytes = where->size() * sizeof(_Char);
+        size_t i = __find_offset(__hash_bytes(p, bytes), offset);
+        if (i == npos)
+            return end();
+
+        __set_ctrl(i, ctrl_deleted);
+        ++__m_deleted;
         --__m_size;
-        return iterator(&(*pos), __m_buffer.data() + __m_buffer.size());
+        if (__m_size == 0) {
+            clear();
+            return end();
+        }
+
+        length_type n = static_cast<length_type>(where->size() | dead_bit);
+        std::memcpy(&__m_buffer[offset], &n, sizeof(n));
+        __m_garbage += sizeof(length_type) + bytes;
+        return iterator(p + bytes, __m_buffer.data() + __m_buffer.size());
     }
 
     template<class _TTraits, class _TAlloc>
@@ -329,7 +421,44 @@ public:
     {
         __m_buffer.clear();
         __m_buckets.clear();
+        __m_ctrl.clear();
         __m_size = 0;
+        __m_deleted = 0;
+        __m_garbage = 0;
+    }
+
+    /*!
+     * Squeeze erased strings out of the buffer. Live
+     * strings are moved down in a single pass and their
+     * buckets are patched in place. Invalidates iterators.
+     */
+    void compact()
+    {
+        if (__m_garbage == 0)
+            return;
+
+        char* first = &__m_buffer[0];
+        size_t total = __m_buffer.size();
+        size_t src = 0, dst = 0;
+        while (src < total)
+        {
+            length_type n;
+            std::memcpy(&n, first + src, sizeof(n));
+            size_t bytes = sizeof(length_type) + (n & ~dead_bit) * sizeof(_Char);
+            if (!(n & dead_bit))
+            {
+                if (dst != src) {
+                    raw_pointer str = first + src + sizeof(length_type);
+                    size_t i = __find_offset(__hash_bytes(str, bytes - sizeof(length_type)), src);
+                    __m_buckets[i].offset = dst;
+                    std::memmove(first + dst, first + src, bytes);
+                }
+                dst += bytes;
+            }
+            src += bytes;
+        }
+        __m_buffer.resize(dst);
+        __m_garbage = 0;
     }
 
     iterator begin() const {
@@ -343,13 +472,53 @@ public:
     }
 
     double load_factor() const {
-        return (__m_size / (double)__m_buckets.size());
+        return (__m_buckets.empty() ? 0.0 : __m_size / (double)__m_buckets.size());
     }
 
     double max_load_factor() const {
-        return 0.8;
+        return max_load;
+    }
+
+    double max_garbage_factor() const {
+        return 0.5;
+    }
+
+    size_t garbage_size() const { return __m_garbage; }
+
+    /*!
+     * Write binary image of the set, which can be
+     * served by basic_mapped_stringset without any
+     * rebuilding. Erased strings are saved as well,
+     * call compact() first to drop them.
+     */
+    void save(std::ostream& os) const
+    {
+        __save([&os](const void* p, size_t n) {
+            os.write(static_cast<const char*>(p), n);
+        });
+        if (!os)
+            throw std::runtime_error("unable to write stringset image");
     }
 
+#ifdef STDX_OS_UNIX
+    void save(int fd) const
+    {
+        __save([fd](const void* p, size_t n) {
+            const char* first = static_cast<const char*>(p);
+            while (n > 0) {
+                ssize_t k = ::write(fd, first, n);
+                if (k < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error("unable to write stringset image");
+                }
+                first += k;
+                n -= k;
+            }
+        });
+    }
+#endif
+
     bool empty() const { return (__m_size == 0); }
 
     size_t size() const { return __m_size; }
@@ -367,96 +536,229 @@ private:
 #endif
     }
 
+    static inline int8_t __h2(size_t hs) {
+        return static_cast<int8_t>(hs & 0x7F);
+    }
+
+    static inline size_t __h1(size_t hs) {
+        return (hs >> 7);
+    }
+
+    // bitmask of bytes in group equal to c
+    static inline uint32_t __match(const int8_t* group, int8_t c)
+    {
+#ifdef __SSE2__
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(c))));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < group_width; i++)
+            mask |= uint32_t(group[i] == c) << i;
+        return mask;
+#endif
+    }
+
+    // bitmask of empty or deleted bytes in group
+    static inline uint32_t __match_free(const int8_t* group)
+    {
+#ifdef __SSE2__
+        // both states are negative, all others are hash tags
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < group_width; i++)
+            mask |= uint32_t(group[i] < 0) << i;
+        return mask;
+#endif
+    }
+
+    static size_t __bucket_count_for(size_t n)
+    {
+        size_t buckets = group_width;
+        while (buckets * max_load < n + 1)
+            buckets <<= 1;
+        return buckets;
+    }
+
+    inline void __set_ctrl(size_t i, int8_t c)
+    {
+        __m_ctrl[i] = c;
+        if (i < group_width)
+            __m_ctrl[__m_buckets.size() + i] = c;
+    }
+
+    static inline bool __equal(raw_pointer buffer, const node& nd, const _Char* str, size_t len)
+    {
+        raw_pointer ptr = buffer + nd.offset;
+        length_type length;
+        std::memcpy(&length, ptr, sizeof(length));
+        return (length == len &&
+                std::memcmp(ptr + sizeof(length_type), str, len * sizeof(_Char)) == 0);
+    }
+
     void __rehash(size_t n)
     {
-        bucket_map temp(n);
+        // bucket count is always a power of two
+        size_t buckets = group_width;
+        while (buckets < n)
+            buckets <<= 1;
 
-        for (auto nodeIt = __m_buckets.cbegin(); nodeIt != __m_buckets.cend(); ++nodeIt)
+        bucket_map temp(buckets);
+        control_map ctrl(buckets + group_width, int8_t(ctrl_empty));
+        const size_t mask = buckets - 1;
+
+        for (size_t k = 0; k < __m_buckets.size(); ++k)
         {
-            if (nodeIt->offset == -1)
+            if (__m_ctrl[k] < 0) // free or erased
                 continue;
 
-            size_t offset = nodeIt->hash_code % n;
-            node* first = temp.data();
-            node* last = temp.data() + n;
-            node* current = first + offset;
-            node* it = current;
-            do
-            {
-                if (it->offset == -1)
-                    break;
-
-                if (++it == last)
-                    it = first;
-            } while (it != current);
-            std::memcpy(it, &(*nodeIt), sizeof(node));
+            size_t hs = __m_buckets[k].hash_code;
+            size_t pos = __h1(hs) & mask;
+            uint32_t m;
+            for (size_t step = group_width; (m = __match_free(ctrl.data() + pos)) == 0; step += group_width)
+                pos = (pos + step) & mask;
+
+            size_t i = (pos + __builtin_ctz(m)) & mask;
+            ctrl[i] = __h2(hs);
+            if (i < group_width)
+                ctrl[buckets + i] = ctrl[i];
+            temp[i] = __m_buckets[k];
         }
         __m_buckets = std::move(temp);
+        __m_ctrl = std::move(ctrl);
+        __m_deleted = 0;
     }
 
-    const node* __find_node(size_t hs, const _Char* str, size_t len) const
+    // Probing goes group by group with triangular steps,
+    // which visits every group of a power of two table.
+    // Full hashes are compared before buffer is touched.
+    static size_t __probe(const node* buckets, const int8_t* ctrl, size_t n,
+                          raw_pointer buffer, size_t hs, const _Char* str, size_t len)
     {
-        size_t n = __m_buckets.size();
-        size_t offset = hs % n;
-
-        raw_pointer bufptr = __m_buffer.data();
-        const node* first = __m_buckets.data();
-        const node* last = __m_buckets.data() + n;
-        const node* current = first + offset;
-        const node* it = current;
-        length_type length = 0;
-        do
+        const size_t mask = n - 1;
+        const int8_t tag = __h2(hs);
+        size_t pos = __h1(hs) & mask;
+        for (size_t step = group_width; ; step += group_width)
         {
-            if (it->offset == -1)
-                return nullptr;
-
-            raw_pointer ptr = bufptr + it->offset;
-            length = *(reinterpret_cast<const length_type*>(ptr));
+            const int8_t* group = ctrl + pos;
+            for (uint32_t m = __match(group, tag); m != 0; m &= m - 1)
+            {
+                size_t i = (pos + __builtin_ctz(m)) & mask;
+                const node& nd = buckets[i];
+                if (nd.hash_code == hs && __equal(buffer, nd, str, len))
+                    return i;
+            }
+            if (__match(group, ctrl_empty) != 0)
+                return npos;
+            pos = (pos + step) & mask;
+        }
+    }
 
-            if (length == len &&
-                _Traits::compare(ptr + sizeof(length_type), str, len * sizeof(_Char)) == 0)
-                    return it;
+    inline size_t __find_node(size_t hs, const _Char* str, size_t len) const
+    {
+        return __probe(__m_buckets.data(), __m_ctrl.data(), __m_buckets.size(),
+                       __m_buffer.data(), hs, str, len);
+    }
 
-            if (++it == last)
-                it = first;
-        } while (it != current);
-        return nullptr;
+    static uint32_t __hash_probe() {
+        static const char probe[] = "stlext";
+        return static_cast<uint32_t>(__hash_bytes(probe, sizeof(probe) - 1));
     }
 
-    const node* __find_free(size_t hs, const _Char* str, size_t len) const
+    stringset_header __make_header() const
     {
-        size_t n = __m_buckets.size();
-        size_t offset = hs % n;
+        stringset_header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "STDXSSET", sizeof(h.magic));
+        h.version = stringset_header::current_version;
+        h.byte_order = 0x01020304;
+        h.char_size = sizeof(_Char);
+        h.length_size = sizeof(length_type);
+        h.word_size = sizeof(size_t);
+        h.hash_probe = __hash_probe();
+        h.size = __m_size;
+        h.bucket_count = __m_buckets.size();
+        h.buffer_size = __m_buffer.size();
+        h.buckets_checksum = stringset_header::checksum(__m_buckets.data(), __m_buckets.size() * sizeof(node));
+        h.ctrl_checksum = stringset_header::checksum(__m_ctrl.data(), __m_ctrl.size());
+        h.buffer_checksum = stringset_header::checksum(__m_buffer.data(), __m_buffer.size());
+        h.header_checksum = stringset_header::checksum(&h, offsetof(stringset_header, header_checksum));
+        return h;
+    }
 
-        raw_pointer bufptr = __m_buffer.data();
-        const node* first = __m_buckets.data();
-        const node* last = __m_buckets.data() + n;
-        const node* current = first + offset;
-        const node* it = current;
-        length_type length = 0;
+    // calls __write(const void*, size_t) for every piece of image
+    template<class _Writer>
+    void __save(_Writer __write) const
+    {
+        static const char zeros[8] = { 0 };
+        stringset_header h = __make_header();
+        __write(&h, sizeof(h));
+
+        size_t n = __m_buckets.size() * sizeof(node);
+        __write(__m_buckets.data(), n);
+        __write(__m_ctrl.data(), __m_ctrl.size());
+        __write(zeros, stringset_header::align(__m_ctrl.size()) - __m_ctrl.size());
+        __write(__m_buffer.data(), __m_buffer.size());
+    }
 
-        for (size_t i = 0; i < n; i++)
+    size_t __find_offset(size_t hs, std::ptrdiff_t offset) const
+    {
+        const size_t mask = __m_buckets.size() - 1;
+        const int8_t tag = __h2(hs);
+        size_t pos = __h1(hs) & mask;
+        for (size_t step = group_width; ; step += group_width)
         {
-            if (it->offset == -1)
-                return it;
-
-            raw_pointer ptr = bufptr + it->offset;
-            length = *(reinterpret_cast<const length_type*>(ptr));
-
-            if (length == len)
-                if (_Traits::compare(ptr + sizeof(length_type), str, len * sizeof(_Char)) == 0)
-                    return nullptr;
+            const int8_t* group = __m_ctrl.data() + pos;
+            for (uint32_t m = __match(group, tag); m != 0; m &= m - 1)
+            {
+                size_t i = (pos + __builtin_ctz(m)) & mask;
+                if (__m_buckets[i].offset == offset)
+                    return i;
+            }
+            if (__match(group, ctrl_empty) != 0)
+                return npos;
+            pos = (pos + step) & mask;
+        }
+    }
 
-            if (++it == last)
-                it = first;
+    // Returns bucket to put string into, or npos if
+    // string is already here. First tombstone on the
+    // probe path is reused.
+    size_t __find_free(size_t hs, const _Char* str, size_t len) const
+    {
+        const size_t mask = __m_buckets.size() - 1;
+        const int8_t tag = __h2(hs);
+        size_t pos = __h1(hs) & mask;
+        size_t slot = npos;
+        for (size_t step = group_width; ; step += group_width)
+        {
+            const int8_t* group = __m_ctrl.data() + pos;
+            for (uint32_t m = __match(group, tag); m != 0; m &= m - 1)
+            {
+                size_t i = (pos + __builtin_ctz(m)) & mask;
+                const node& nd = __m_buckets[i];
+                if (nd.hash_code == hs && __equal(__m_buffer.data(), nd, str, len))
+                    return npos;
+            }
+            if (slot == npos) {
+                uint32_t m = __match_free(group);
+                if (m != 0)
+                    slot = (pos + __builtin_ctz(m)) & mask;
+            }
+            if (__match(group, ctrl_empty) != 0)
+                return slot;
+            pos = (pos + step) & mask;
         }
-        return nullptr;
     }
 
 private:
     buffer_type __m_buffer;
     bucket_map  __m_buckets;
+    control_map __m_ctrl;
     size_type   __m_size;
+    size_type   __m_deleted; // tombstone buckets
+    size_type   __m_garbage; // bytes occupied by erased strings
 };
 
 
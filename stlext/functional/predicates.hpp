@@ -128,7 +128,8 @@ struct __is_any_of<char> :
     element \a x, otherwise return false.
     */
     inline bool operator()(char x) const {
-        return __m_bits.test(x);
+        typedef typename std::make_unsigned<char>::type uchar_t;
+        return __m_bits[(uchar_t)x];
     }
 
 private:
@@ -382,7 +383,7 @@ struct __is_none_of<char> :
         static_assert(std::is_same<iter_valty, value_type>::value, "incorrect iterator value_type");
         __m_bits.set(); // set all bits
         for (; first != last; ++first) {
-            __m_bits.reset(*first); // reset target bit
+            __m_bits.reset((unsigned char)*first); // reset target bit
         }
     }
 
@@ -392,7 +393,8 @@ struct __is_none_of<char> :
     element set, otherwise return false.
     */
     inline bool operator()(char x) const {
-        return __m_bits.test(x);
+        typedef typename std::make_unsigned<char>::type uchar_t;
+        return __m_bits[(uchar_t)x];
     }
 
 private:
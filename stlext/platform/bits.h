@@ -295,7 +295,7 @@ __FORCE_INLINE uint16_t __byte_swap(uint16_t  __x) noexcept { return static_cast
 // Swap bytes of a 4 byte word
 __FORCE_INLINE uint32_t __byte_swap(uint32_t  __x) noexcept { return static_cast<unsigned>(__builtin_bswap32(__x)); }
 // Swap bytes of a 8 byte word
-__FORCE_INLINE uint64_t __byte_swap(uint64_t  __x) noexcept { return static_cast<unsigned>(__builtin_bswap64(__x)); }
+__FORCE_INLINE uint64_t __byte_swap(uint64_t  __x) noexcept { return static_cast<uint64_t>(__builtin_bswap64(__x)); }
 
 
 
@@ -21,16 +21,22 @@ HEADERS += \
     algorithm/ext/slide.hpp \
     algorithm/ext/split.hpp \
     algorithm/ext/stralgo.hpp \
+    algorithm/ext/tokenizer.hpp \
     algorithm/ext/simplify.hpp \
     algorithm/ext/distances.hpp \
     algorithm/searching/exponential_search.hpp \
     algorithm/searching.h \
     algorithm/searching/interpolation_search.hpp \
+    algorithm/searching/static_search_index.hpp \
     algorithm/sorting/bucket_sort.hpp \
     algorithm/sorting/counting_sort.hpp \
     algorithm/sorting.h \
     algorithm/sorting/insertion_sort.hpp \
+    algorithm/sorting/parallel_sort.hpp \
+    algorithm/sorting/radix_sort.hpp \
     algorithm/sorting/selection_sort.hpp \
+    algorithm/sorting/simd_sort.hpp \
+    algorithm/sorting/small_sort.hpp \
     allocators/aligned_allocator.hpp \
     allocators/allocators.hpp \
     allocators/arena_traits.hpp \
@@ -38,13 +44,17 @@ HEADERS += \
     allocators/basic_arena.hpp \
     allocators/binexp_arena.hpp \
     allocators/bitmap_arena.hpp \
+    allocators/concurrent_freelist.hpp \
     allocators/fallback_arena.hpp \
     allocators/freelist.hpp \
     allocators/heap_arena.hpp \
     allocators/intrusive_ptr.hpp \
+    allocators/lockfree_pool.hpp \
     allocators/memory_storage.hpp \
     allocators/ordered_arena.hpp \
     allocators/pooled_object.hpp \
+    allocators/slab_arena.hpp \
+    allocators/stats_arena.hpp \
     compability/cxx11/all_of.hpp \
     compability/cxx11/any_of.hpp \
     compability/cxx11/copy_if.hpp \
@@ -80,10 +90,16 @@ HEADERS += \
     components/reflect.hpp \
     components/stream_scanner.hpp \
     containers/circular_queue.hpp \
+    containers/concurrent_circular_queue.hpp \
+    containers/concurrent_string_interner.hpp \
+    containers/front_coded_dictionary.hpp \
+    containers/mapped_stringset.hpp \
     containers/packed_hashtbl.hpp \
     containers/packed_lru_cache.hpp \
     containers/priority_map.hpp \
+    containers/ring_buffer.hpp \
     containers/span.hpp \
+    containers/static_stringset.hpp \
     containers/stringset.hpp \
     cui/noecho.hpp \
     cui/progress_viewer.hpp \
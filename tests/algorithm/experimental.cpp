@@ -19,6 +19,12 @@
 #include <stack>
 
 #include <algorithm>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <iterator>
+#include <limits>
+#include <cstdlib>
 
 #if _MSC_VER >= 1800
 #include <concurrent_queue.h>
@@ -29,6 +35,7 @@
 
 
 #include <stlext/algorithm/experimental.h>
+#include <stlext/functional/predicates.hpp>
 
 namespace detail {
 
@@ -188,6 +195,72 @@ TEST_CASE("algorithms/is_unique", "[algorithm.experimental]")
 								  std::istreambuf_iterator<wchar_t>()));
 }
 
+TEST_CASE("algorithms/is_unique_engines", "[algorithm.experimental]")
+{
+	std::mt19937 gen(3);
+
+	// sizes around small-array threshold, narrow and wide value ranges
+	for (size_t n : { 2, 7, 31, 32, 33, 100, 5000 })
+	{
+		for (int64_t range : { int64_t(n), int64_t(n) * 1000, int64_t(1) << 31 })
+		{
+			std::vector<int64_t> v64(n);
+			for (size_t i = 0; i < n; ++i)
+				v64[i] = static_cast<int64_t>(i) * (range / static_cast<int64_t>(n)) - range / 2;
+			std::shuffle(v64.begin(), v64.end(), gen);
+			std::vector<int32_t> v32(v64.begin(), v64.end());
+			std::list<int64_t> l64(v64.begin(), v64.end());
+			std::vector<std::string> vs(n);
+			std::transform(v64.begin(), v64.end(), vs.begin(), [](int64_t x) { return std::to_string(x); });
+
+			REQUIRE(stdx::is_unique(v64.begin(), v64.end()));
+			REQUIRE(stdx::is_unique(v32.begin(), v32.end()));
+			REQUIRE(stdx::is_unique(l64.begin(), l64.end()));
+			REQUIRE(stdx::is_unique(vs.begin(), vs.end()));
+
+			// duplicate at random position, including the last one
+			size_t i = gen() % n, j = (n - 1);
+			if (i == j) i = 0;
+			v64[j] = v64[i]; v32[j] = v32[i]; vs[j] = vs[i];
+			l64.back() = v64[i];
+			REQUIRE_FALSE(stdx::is_unique(v64.begin(), v64.end()));
+			REQUIRE_FALSE(stdx::is_unique(v32.begin(), v32.end()));
+			REQUIRE_FALSE(stdx::is_unique(l64.begin(), l64.end()));
+			REQUIRE_FALSE(stdx::is_unique(vs.begin(), vs.end()));
+
+			REQUIRE_FALSE(stdx::is_unique_inplace(v64.begin(), v64.end()));
+			REQUIRE(std::is_sorted(v64.begin(), v64.end()));
+			v64.erase(std::unique(v64.begin(), v64.end()), v64.end());
+			std::shuffle(v64.begin(), v64.end(), gen);
+			REQUIRE(stdx::is_unique_inplace(v64.begin(), v64.end()));
+		}
+	}
+
+	// extreme values span whole range of type
+	std::vector<int32_t> extremes = { std::numeric_limits<int32_t>::min(), 0, std::numeric_limits<int32_t>::max() };
+	REQUIRE(stdx::is_unique(extremes.begin(), extremes.end()));
+	std::vector<uint8_t> bytes(256);
+	std::iota(bytes.begin(), bytes.end(), 0);
+	REQUIRE(stdx::is_unique(bytes.begin(), bytes.end()));
+	bytes.push_back(255);
+	REQUIRE_FALSE(stdx::is_unique(bytes.begin(), bytes.end()));
+
+	// custom predicate is respected by every engine
+	auto same_parity = [](int a, int b) { return (a % 2) == (b % 2); };
+	auto parity_hash = [](int a) { return std::hash<int>()(a % 2); };
+	std::vector<int> v = { 1, 2 };
+	REQUIRE(stdx::is_unique(v.begin(), v.end(), parity_hash, same_parity));
+	v.resize(100);
+	std::iota(v.begin(), v.end(), 0);
+	REQUIRE_FALSE(stdx::is_unique(v.begin(), v.end(), parity_hash, same_parity));
+
+	auto case_less = [](char a, char b) { return std::tolower(a) < std::tolower(b); };
+	std::string s = "abcABC";
+	REQUIRE_FALSE(stdx::is_unique_inplace(s.begin(), s.end(), case_less));
+	s = "abcXYZ";
+	REQUIRE(stdx::is_unique_inplace(s.begin(), s.end(), case_less));
+}
+
 TEST_CASE("algorithms/kadane_sum", "[algorithm.experimental]")
 {
     std::vector<int> v = { 0, -1, -2, 3, 1, -2, 5, 3, 4, -1, 0 };
@@ -313,6 +386,227 @@ TEST_CASE("algorithms/split_copy", "[algorithm.experimental]")
     REQUIRE(results == expected);
 }
 
+TEST_CASE("algorithms/split_into", "[algorithm.experimental]")
+{
+    using namespace std;
+
+    // fast path: arithmetic and string fields, delimiter character
+    int i = 0; unsigned u = 0; long long ll = 0; double d = 0; float f = 0; string s; char c = 0;
+    stdx::split_into(string("\t-42\t\t17\t-9223372036854775808\t3.25\t-1.5e3\tname\tx\t"), '\t', i, u, ll, d, f, s, c);
+    REQUIRE(i == -42);
+    REQUIRE(u == 17);
+    REQUIRE(ll == numeric_limits<long long>::min());
+    REQUIRE(d == 3.25);
+    REQUIRE(f == -1500.f);
+    REQUIRE(s == "name");
+    REQUIRE(c == 'x');
+
+    // decimals which need correct rounding fall back to strtod
+    const char* doubles[] = { "0.1", "123456.789e-3", "1e-30", "12345678901234567890123", "4.9e-324", "inf", "0x1p3" };
+    for (const char* str : doubles) {
+        string line = string("1 ") + str;
+        int n = 0; double x = 0;
+        stdx::split_into(line, ' ', n, x);
+        REQUIRE(n == 1);
+        REQUIRE(x == strtod(str, nullptr));
+    }
+
+    // malformed and out of range fields
+    int bad = 1; short clamped = 0; unsigned neg = 1; double nan_ = 1;
+    stdx::split_into("abc,70000,-1,xyz", ',', bad, clamped, neg, nan_);
+    REQUIRE(bad == 0);
+    REQUIRE(clamped == numeric_limits<short>::max());
+    REQUIRE(neg == 0);
+    REQUIRE(nan_ == 0);
+
+    // padded fields are read as operator>> reads them
+    int p1 = 0, p2 = 0; double pd = 0; char pc = 0; string ps, pw;
+    stdx::split_into(string("1, 2,\t-3.5 ,  z,hello world,  x  "), ',', p1, p2, pd, pc, ps, pw);
+    REQUIRE(p1 == 1);
+    REQUIRE(p2 == 2);
+    REQUIRE(pd == -3.5);
+    REQUIRE(pc == 'z');
+    REQUIRE(ps == "hello");
+    REQUIRE(pw == "x");
+
+    // same results through the stream based path
+    bool pb = false;
+    stdx::split_into(string("1, 2,hello world, 1"), ',', p1, p2, ps, pb);
+    REQUIRE(p2 == 2);
+    REQUIRE(ps == "hello");
+    REQUIRE(pb == true);
+
+    // missing fields keep their values
+    int a = 0, b = 5;
+    std::tuple<int&, int&> fields(a, b);
+    stdx::split_into(string("  10  "), ' ', fields);
+    REQUIRE(a == 10);
+    REQUIRE(b == 5);
+
+    // string views point into the source line, any-of predicate
+    string line = "key=value;\xC3\xA9t\xC3\xA9=1.5";
+    std::experimental::string_view k1, v1, k2; double v2 = 0;
+    stdx::split_into(line, stdx::is_any_of({ '=', ';' }), k1, v1, k2, v2);
+    REQUIRE(k1 == "key");
+    REQUIRE(v1 == "value");
+    REQUIRE(k2 == "\xC3\xA9t\xC3\xA9");
+    REQUIRE(k1.data() == line.data());
+    REQUIRE(v2 == 1.5);
+
+    // long lines with SIMD scanning and stream path for other field types
+    string wide(100, 'a');
+    line = wide + "," + wide + ",0";
+    string w1; std::experimental::string_view w2; bool flag = true;
+    stdx::split_into(line, ',', w1, w2, flag);
+    REQUIRE(w1 == wide);
+    REQUIRE(w2 == wide);
+    REQUIRE(flag == false);
+
+    stdx::split_into(line.substr(0, 100) + ",1", ',', w1, flag);
+    REQUIRE(flag == true);
+}
+
+TEST_CASE("algorithms/split_copy_view", "[algorithm.experimental]")
+{
+    using namespace std;
+    typedef std::experimental::string_view view_type;
+
+    string str = "\t\tA\tvery\t\tlong\tstring\twith\tsome\tdelimiters\t";
+    vector<view_type> views;
+    vector<string> strings;
+    vector<string> expected = { "A", "very", "long", "string", "with", "some", "delimiters" };
+
+    stdx::split_copy(str, back_inserter(views), '\t');
+    stdx::split_copy(view_type(str), back_inserter(strings), '\t');
+    REQUIRE(strings == expected);
+    REQUIRE(views.size() == expected.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        REQUIRE(views[i] == expected[i]);
+        REQUIRE(views[i].data() >= str.data());
+        REQUIRE(views[i].data() < str.data() + str.size());
+    }
+
+    views.clear();
+    stdx::split_copy(string(), back_inserter(views), '\t');
+    stdx::split_copy(string(70, ';'), back_inserter(views), ';');
+    REQUIRE(views.empty());
+
+    // outputs which are neither strings nor views receive iterator pairs
+    vector<vector<char>> chars;
+    stdx::split_copy(string("ab;cd"), back_inserter(chars), ';');
+    REQUIRE(chars == vector<vector<char>>({ { 'a', 'b' }, { 'c', 'd' } }));
+
+    str = string(40, 'x') + ";" + string(40, 'y');
+    stdx::split_copy(str, back_inserter(views), stdx::is_any_of({ ';' }));
+    REQUIRE(views.size() == 2);
+    REQUIRE(views[0] == string(40, 'x'));
+    REQUIRE(views[1] == string(40, 'y'));
+}
+
+namespace detail {
+
+// reference tokenizer, character by character
+static std::vector<std::string> __naive_tokenize(const std::string& text, const std::string& delims, bool keep_empty, char quote)
+{
+    std::vector<std::string> tokens;
+    if (text.empty())
+        return tokens;
+
+    bool quoted = false;
+    std::string::size_type first = 0;
+    for (std::string::size_type i = 0; i <= text.size(); ++i)
+    {
+        if (i < text.size() && quote != '\0' && text[i] == quote)
+            quoted = !quoted;
+        if (i == text.size() || (!quoted && delims.find(text[i]) != std::string::npos)) {
+            std::string token = text.substr(first, i - first);
+            if (quote != '\0' && token.size() >= 2 && token.front() == quote && token.back() == quote)
+                token = token.substr(1, token.size() - 2);
+            if (keep_empty || i != first)
+                tokens.push_back(token);
+            first = i + 1;
+        }
+    }
+    return tokens;
+}
+
+} // end namespace detail
+
+TEST_CASE("algorithms/delimiter_set", "[algorithm.experimental]")
+{
+    using namespace std;
+
+    // exact nibble tables, and a set with more than 8 distinct high nibbles
+    const string sets[] = { ",", " \t\r\n,;:|", "\x80\xFF,", string("\0\x10\x20\x30\x40\x50\x60\x70\x80", 9) };
+
+    mt19937 gen(7);
+    string alphabet = "ab ,;\t\n|:\"\x80\xFF\x10";
+    alphabet.push_back('\0');
+    for (const string& chars : sets)
+    {
+        stdx::delimiter_set delims(chars.begin(), chars.end());
+        for (int c = -128; c < 128; ++c)
+            REQUIRE(delims(char(c)) == (chars.find(char(c)) != string::npos));
+
+        for (size_t n : { 0, 1, 63, 64, 65, 200 }) {
+            string text(n, 'x');
+            for (size_t pos = 0; pos < n; pos += 1 + gen() % 70) {
+                text[pos] = alphabet[gen() % alphabet.size()];
+                REQUIRE(delims.find(text.data(), text.data() + n) == 
+                        find_if(text.data(), text.data() + n, [&chars](char x) { return chars.find(x) != string::npos; }));
+            }
+        }
+    }
+}
+
+TEST_CASE("algorithms/tokenizer", "[algorithm.experimental]")
+{
+    using namespace std;
+    typedef std::experimental::string_view view_type;
+
+    vector<view_type> tokens;
+    string text = "  A very\tlong,string;with   some|delimiters  ";
+    for (view_type token : stdx::tokenize(text, " \t,;|"))
+        tokens.push_back(token);
+    vector<view_type> expected = { "A", "very", "long", "string", "with", "some", "delimiters" };
+    REQUIRE(tokens == expected);
+
+    auto fields = stdx::csv_tokenize("1,,\"a,b\",\"say \"\"hi\"\"\",");
+    tokens.assign(fields.begin(), fields.end());
+    expected = { "1", "", "a,b", "say \"\"hi\"\"", "" };
+    REQUIRE(tokens == expected);
+
+    REQUIRE(stdx::tokenize(string(), ",").begin() == stdx::tokenizer::const_iterator());
+    REQUIRE(stdx::tokenize(string(100, ','), ",").begin() == stdx::tokenizer::const_iterator());
+
+    // random texts crossing block boundaries
+    mt19937 gen(11);
+    const string alphabet = "abc,;\" \t";
+    for (int iter = 0; iter < 500; ++iter)
+    {
+        string line(gen() % 300, 'x');
+        for (char& c : line)
+            c = alphabet[gen() % alphabet.size()];
+
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            bool keep = (mode & 1) != 0;
+            char quote = (mode & 2) ? '"' : '\0';
+            stdx::tokenizer range(line.data(), line.data() + line.size(), ",; ", 
+                                  keep ? stdx::empty_tokens::keep : stdx::empty_tokens::skip, quote);
+            vector<string> results;
+            for (auto it = range.begin(); it != range.end(); ++it)
+                results.push_back(it->to_string());
+            REQUIRE(results == detail::__naive_tokenize(line, ",; ", keep, quote));
+        }
+    }
+
+    // delimiter_set as split predicate
+    vector<string> words;
+    stdx::split_copy(text, back_inserter(words), stdx::delimiter_set(" \t,;|"));
+    REQUIRE(words == vector<string>({ "A", "very", "long", "string", "with", "some", "delimiters" }));
+}
+
 TEST_CASE("algorithms/regex_split", "[algorithm.experimental]")
 {
     const char* cexpr = "(\\w+)";
@@ -410,6 +704,66 @@ TEST_CASE("algorithms/kway_merge", "[algorithm.experimental]")
 }
 
 
+TEST_CASE("algorithms/kway_merger", "[algorithm.experimental]")
+{
+    using namespace std;
+    typedef pair<int, size_t> item; // value, run index
+
+    // many runs with duplicates
+    mt19937 gen(5);
+    for (size_t k : { 3, 7, 64, 257 })
+    {
+        vector< vector<item> > runs(k);
+        vector<item> desired;
+        for (size_t r = 0; r < k; r++) {
+            runs[r].resize(gen() % 40);
+            for (auto& x : runs[r])
+                x = item(gen() % 50, r);
+            sort(runs[r].begin(), runs[r].end());
+            desired.insert(desired.end(), runs[r].begin(), runs[r].end());
+        }
+        auto by_value = [](const item& x, const item& y) { return x.first < y.first; };
+
+        vector<item> merged;
+        stdx::kway_merge(runs, back_inserter(merged), by_value);
+        REQUIRE(is_sorted(merged.begin(), merged.end(), by_value));
+        REQUIRE(is_permutation(merged.begin(), merged.end(), desired.begin(), desired.end()));
+    }
+
+    // input iterators and block output
+    istringstream s1("1 4 7 10"), s2("2 5 8"), s3(""), s4("3 6 9 11 12");
+    typedef stdx::utility::range_cursor< istream_iterator<int> > cursor;
+    vector<cursor> sources;
+    for (auto s : { &s1, &s2, &s3, &s4 })
+        sources.emplace_back(istream_iterator<int>(*s), istream_iterator<int>());
+
+    stdx::kway_merger<cursor> merger(std::move(sources));
+    vector<int> block(5), merged;
+    while (!merger.empty()) {
+        auto last = merger.read(block.begin(), block.size());
+        REQUIRE((last - block.begin() == 5 || merger.empty()));
+        merged.insert(merged.end(), block.begin(), last);
+    }
+    REQUIRE(merged == vector<int>({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 }));
+
+    // cursor producing elements by value
+    struct counter_cursor {
+        int current, last, step;
+        bool empty() const { return current >= last; }
+        string front() const { return to_string(current); }
+        void pop() { current += step; }
+    };
+    vector<counter_cursor> counters = { { 10, 40, 3 }, { 11, 40, 3 }, { 12, 40, 3 } };
+    stdx::kway_merger<counter_cursor> strings(counters);
+    vector<string> merged_strings;
+    strings.read(back_inserter(merged_strings));
+    REQUIRE(merged_strings.size() == 30);
+    REQUIRE(is_sorted(merged_strings.begin(), merged_strings.end()));
+    REQUIRE(merged_strings.front() == "10");
+    REQUIRE(merged_strings.back() == "39");
+}
+
+
 TEST_CASE("algorithms/kway_union", "[algorithm.experimental]")
 {
     using namespace std;
@@ -551,3 +905,65 @@ TEST_CASE("algorithms/kway_intersect", "[algorithm.experimental]")
     intersection.clear();
 }
 
+
+template<class _Tp, class _Comp>
+static std::vector<_Tp> __reference_intersection(std::vector< std::vector<_Tp> > lists, _Comp comp)
+{
+    std::vector<_Tp> result;
+    for (auto& l : lists) {
+        l.erase(std::unique(l.begin(), l.end()), l.end());
+        if (l.empty())
+            continue; // kway_intersect skips empty ranges
+        if (result.empty()) {
+            result = l;
+            continue;
+        }
+        std::vector<_Tp> tmp;
+        std::set_intersection(result.begin(), result.end(), l.begin(), l.end(), std::back_inserter(tmp), comp);
+        result.swap(tmp);
+        if (result.empty())
+            break;
+    }
+    return result;
+}
+
+template<class _Tp, class _Comp = std::less<>>
+static void __check_kway_intersect(std::mt19937& gen, std::vector<size_t> sizes, _Tp universe, _Comp comp = _Comp())
+{
+    std::vector< std::vector<_Tp> > lists;
+    for (size_t n : sizes) {
+        std::vector<_Tp> l(n);
+        for (auto& x : l)
+            x = static_cast<_Tp>(gen() % universe);
+        std::sort(l.begin(), l.end(), comp);
+        lists.push_back(l);
+    }
+    std::vector<_Tp> result;
+    stdx::kway_intersect(lists, std::back_inserter(result), comp);
+    REQUIRE(result == __reference_intersection(lists, comp));
+
+    std::vector< std::list<_Tp> > linked;
+    for (auto& l : lists)
+        linked.emplace_back(l.begin(), l.end());
+    std::vector<_Tp> linked_result;
+    stdx::kway_intersect(linked, std::back_inserter(linked_result), comp);
+    REQUIRE(linked_result == result);
+}
+
+TEST_CASE("algorithms/kway_intersect.adaptive", "[algorithm.experimental]")
+{
+    std::mt19937 gen(11);
+    for (int round = 0; round < 20; round++) {
+        // similar sizes: block (SIMD) intersection of 32-bit integers
+        __check_kway_intersect<uint32_t>(gen, { 500, 700, 900 }, 2000);
+        __check_kway_intersect<int32_t>(gen, { 300 + gen() % 50, 400, 1000 }, 1200);
+        // wildly different sizes: galloping
+        __check_kway_intersect<uint32_t>(gen, { 20, 5000, 40000, 3 }, 50000);
+        __check_kway_intersect<int64_t>(gen, { 50, 10000, 300 }, 20000);
+        // many lists, duplicates and empty list
+        __check_kway_intersect<uint32_t>(gen, { 100, 120, 0, 110, 130, 90, 100, 100, 115, 125, 140, 150 }, 60);
+        // custom order
+        __check_kway_intersect<int32_t>(gen, { 400, 500, 20000 }, 5000, std::greater<>());
+    }
+}
+
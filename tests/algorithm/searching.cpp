@@ -0,0 +1,84 @@
+#include <catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include <stlext/algorithm/searching.h>
+
+
+template<class _Index, class _Tp, class _Comp>
+static void check_search_index(const std::vector<_Tp>& sorted, const std::vector<_Tp>& queries, _Comp comp)
+{
+    _Index index(sorted.begin(), sorted.end(), comp);
+    REQUIRE(index.size() == sorted.size());
+    for (const auto& x : queries) {
+        size_t expected = std::lower_bound(sorted.begin(), sorted.end(), x, comp) - sorted.begin();
+        REQUIRE(index.lower_bound(x) == expected);
+        REQUIRE(index.contains(x) == std::binary_search(sorted.begin(), sorted.end(), x, comp));
+    }
+
+    _Index copy(index);
+    for (const auto& x : queries)
+        REQUIRE(copy.lower_bound(x) == index.lower_bound(x));
+}
+
+template<class _Layout>
+static void check_search_index_layout()
+{
+    std::mt19937_64 rnd;
+    for (size_t n : { 0, 1, 2, 15, 16, 17, 100, 255, 256, 257, 1000, 4913, 65536, 100003 })
+    {
+        std::vector<int32_t> i32(n);
+        std::vector<int64_t> i64(n);
+        std::vector<double> f64(n);
+        for (size_t i = 0; i < n; i++) {
+            i32[i] = static_cast<int32_t>(rnd() % (4 * n + 1)) - static_cast<int32_t>(n);
+            i64[i] = static_cast<int64_t>(rnd());
+            f64[i] = static_cast<double>(i32[i]) / 2;
+        }
+        std::sort(i32.begin(), i32.end());
+        std::sort(i64.begin(), i64.end());
+        std::sort(f64.begin(), f64.end());
+
+        std::vector<int32_t> q32;
+        std::vector<int64_t> q64;
+        std::vector<double> qf;
+        for (int i = 0; i < 2000; i++) {
+            q32.push_back(static_cast<int32_t>(rnd() % (6 * n + 3)) - static_cast<int32_t>(2 * n + 1));
+            q64.push_back(n > 0 && i % 2 ? i64[rnd() % n] : static_cast<int64_t>(rnd()));
+            qf.push_back(static_cast<double>(q32.back()) / 2 + (i % 3 ? 0.0 : 0.25));
+        }
+        q32.push_back(std::numeric_limits<int32_t>::min());
+        q32.push_back(std::numeric_limits<int32_t>::max());
+
+        check_search_index<stdx::static_search_index<int32_t, _Layout>>(i32, q32, std::less<int32_t>());
+        check_search_index<stdx::static_search_index<int64_t, _Layout>>(i64, q64, std::less<int64_t>());
+        check_search_index<stdx::static_search_index<double, _Layout>>(f64, qf, std::less<double>());
+    }
+
+    // custom order and non-trivial keys
+    std::vector<std::string> strs;
+    for (int i = 0; i < 3000; i++)
+        strs.push_back(std::to_string(rnd() % 1000));
+    std::sort(strs.begin(), strs.end(), std::greater<std::string>());
+    std::vector<std::string> queries(strs.begin(), strs.begin() + 100);
+    queries.push_back("");
+    queries.push_back("99999");
+    queries.push_back("5");
+    check_search_index<stdx::static_search_index<std::string, _Layout, std::greater<std::string>>>(
+        strs, queries, std::greater<std::string>());
+}
+
+TEST_CASE("algorithms/static_search_index", "[algorithm.searching]")
+{
+    SECTION("eytzinger_layout") {
+        check_search_index_layout<stdx::eytzinger_layout>();
+    }
+
+    SECTION("btree_layout") {
+        check_search_index_layout<stdx::btree_layout>();
+    }
+}
@@ -20,6 +20,7 @@
 #include <stack>
 
 #include <algorithm>
+#include <cmath>
 
 #if _MSC_VER >= 1800
 #include <concurrent_queue.h>
@@ -160,3 +161,409 @@ TEST_CASE("algorithms/counting_sort", "[algorithm.sorting]")
 
 
 
+TEST_CASE("algorithms/radix_sort", "[algorithm.sorting]")
+{
+	using namespace std;
+
+	std::mt19937 rnd;
+
+	SECTION("lsd_radix_sort") 
+	{
+		vector<uint32_t> u(10000);
+		for (auto& x : u) x = rnd();
+		auto expected = u;
+		sort(expected.begin(), expected.end());
+
+		auto v = u;
+		stdx::lsd_radix_sort(v.begin(), v.end());
+		REQUIRE(v == expected);
+
+		v = u;
+		stdx::lsd_radix_sort<8>(v.begin(), v.end());
+		REQUIRE(v == expected);
+
+		v = u;
+		stdx::lsd_radix_sort<16>(v.begin(), v.end());
+		REQUIRE(v == expected);
+
+		// trivial passes are skipped: only low byte differs
+		for (auto& x : v) x = 0xABCD0000 | (rnd() & 0xFF);
+		stdx::lsd_radix_sort(v.begin(), v.end());
+		REQUIRE(is_sorted(v.begin(), v.end()));
+
+		vector<int64_t> s(5000);
+		for (auto& x : s) x = static_cast<int64_t>((uint64_t(rnd()) << 32) | rnd());
+		s[0] = numeric_limits<int64_t>::min();
+		s[1] = numeric_limits<int64_t>::max();
+		s[2] = 0; s[3] = -1;
+		auto s2 = s;
+		stdx::lsd_radix_sort(s.begin(), s.end());
+		sort(s2.begin(), s2.end());
+		REQUIRE(s == s2);
+
+		vector<int8_t> b(1000);
+		for (auto& x : b) x = static_cast<int8_t>(rnd());
+		stdx::lsd_radix_sort(b.begin(), b.end());
+		REQUIRE(is_sorted(b.begin(), b.end()));
+
+		uniform_real_distribution<double> dreal(-1e6, 1e6);
+		vector<double> d(3000);
+		for (auto& x : d) x = dreal(rnd);
+		d[0] = -0.0; d[1] = 0.0; 
+		d[2] = numeric_limits<double>::infinity(); 
+		d[3] = -numeric_limits<double>::infinity();
+		d[4] = numeric_limits<double>::denorm_min();
+		stdx::lsd_radix_sort(d.begin(), d.end());
+		REQUIRE(is_sorted(d.begin(), d.end()));
+
+		vector<float> f(3000);
+		for (auto& x : f) x = static_cast<float>(dreal(rnd));
+		stdx::lsd_radix_sort(f.begin(), f.end());
+		REQUIRE(is_sorted(f.begin(), f.end()));
+
+		// stable by projection
+		vector<pair<int, int>> r(5000);
+		for (size_t i = 0; i < r.size(); i++) 
+			r[i] = make_pair(static_cast<int>(rnd() % 100) - 50, static_cast<int>(i));
+		auto r2 = r;
+		stdx::lsd_radix_sort(r.begin(), r.end(), [](const pair<int, int>& p) { return p.first; });
+		stable_sort(r2.begin(), r2.end(), [](const pair<int, int>& x, const pair<int, int>& y) { 
+			return x.first < y.first; 
+		});
+		REQUIRE(r == r2);
+
+		// non-trivial values
+		vector<string> strs(1000);
+		for (auto& s : strs) s = to_string(static_cast<int>(rnd() % 100000) - 50000);
+		auto strs2 = strs;
+		auto string_proj = [](const string& s) { return stoi(s); };
+		stdx::lsd_radix_sort(strs.begin(), strs.end(), string_proj);
+		stable_sort(strs2.begin(), strs2.end(), [&](const string& x, const string& y) { 
+			return string_proj(x) < string_proj(y); 
+		});
+		REQUIRE(strs == strs2);
+
+		vector<int> small = { 3, -1, 2 };
+		stdx::lsd_radix_sort(small.begin(), small.end());
+		REQUIRE(small == vector<int>({ -1, 2, 3 }));
+	}
+
+	SECTION("american_flag_sort")
+	{
+		vector<int32_t> v(20000);
+		for (auto& x : v) x = static_cast<int32_t>(rnd());
+		auto v2 = v;
+		stdx::american_flag_sort(v.begin(), v.end());
+		sort(v2.begin(), v2.end());
+		REQUIRE(v == v2);
+
+		for (auto& x : v) x = static_cast<int32_t>(rnd() % 10);
+		stdx::american_flag_sort(v.begin(), v.end());
+		REQUIRE(is_sorted(v.begin(), v.end()));
+
+		vector<double> d(5000);
+		uniform_real_distribution<double> dreal(-1.0, 1.0);
+		for (auto& x : d) x = dreal(rnd);
+		stdx::american_flag_sort(d.begin(), d.end());
+		REQUIRE(is_sorted(d.begin(), d.end()));
+
+		vector<pair<uint64_t, string>> r(3000);
+		for (auto& p : r) {
+			p.first = (uint64_t(rnd()) << 32) | rnd();
+			p.second = to_string(p.first);
+		}
+		stdx::american_flag_sort(r.begin(), r.end(), [](const pair<uint64_t, string>& p) { return p.first; });
+		REQUIRE(is_sorted(r.begin(), r.end()));
+		for (auto& p : r) 
+			REQUIRE(p.second == to_string(p.first));
+	}
+
+	SECTION("msd_radix_sort")
+	{
+		string alpha = "abc";
+		vector<string> strs(20000);
+		for (auto& s : strs) {
+			s.resize(rnd() % 12);
+			for (auto& c : s) c = alpha[rnd() % alpha.size()];
+		}
+		strs.push_back(string("\xff\x01", 2));
+		strs.push_back(string("a\0b", 3));
+		strs.push_back(string());
+		auto strs2 = strs;
+		stdx::msd_radix_sort(strs.begin(), strs.end());
+		sort(strs2.begin(), strs2.end());
+		REQUIRE(strs == strs2);
+
+		// stable by projection
+		vector<pair<string, int>> r;
+		for (int i = 0; i < 5000; i++) 
+			r.emplace_back(strs[rnd() % strs.size()], i);
+		auto r2 = r;
+		auto proj = [](const pair<string, int>& p) -> const string& { return p.first; };
+		stdx::msd_radix_sort(r.begin(), r.end(), proj);
+		stable_sort(r2.begin(), r2.end(), [](const pair<string, int>& x, const pair<string, int>& y) {
+			return x.first < y.first; 
+		});
+		REQUIRE(r == r2);
+
+		vector<const char*> cstrs;
+		for (size_t i = 0; i < 1000; i++)
+			cstrs.push_back(strs[rnd() % strs.size()].c_str());
+		stdx::msd_radix_sort(cstrs.begin(), cstrs.end());
+		REQUIRE(is_sorted(cstrs.begin(), cstrs.end(), [](const char* x, const char* y) { 
+			return strcmp(x, y) < 0; 
+		}));
+	}
+}
+
+
+
+TEST_CASE("algorithms/sample_sort", "[algorithm.sorting]")
+{
+	using namespace std;
+
+	std::mt19937 rnd;
+
+	SECTION("sample_bucketizer")
+	{
+		vector<int> v(10000);
+		for (auto& x : v) x = static_cast<int>(rnd() % 100000);
+
+		stdx::sample_bucketizer<int> b(v.begin(), v.end(), 100);
+		REQUIRE(b.size() == 128);
+		REQUIRE(b.splitters().size() == 127);
+		REQUIRE(is_sorted(b.splitters().begin(), b.splitters().end()));
+		for (int x : v) {
+			size_t i = b(x);
+			REQUIRE(i < b.size());
+			if (i > 0) REQUIRE(b.splitters()[i - 1] < x);
+			if (i < b.splitters().size()) REQUIRE(x <= b.splitters()[i]);
+		}
+
+		// skewed keys get equality buckets
+		for (auto& x : v) x = (rnd() % 4 ? 7 : static_cast<int>(rnd() % 1000));
+		stdx::sample_bucketizer<int> eb(v.begin(), v.end(), 16);
+		REQUIRE(eb.size() == 31);
+		REQUIRE(eb.is_equal_bucket(eb(7)));
+		for (int x : v) {
+			size_t i = eb(x);
+			REQUIRE(i < eb.size());
+			if (eb.is_equal_bucket(i)) REQUIRE(x == eb.splitters()[i / 2]);
+		}
+	}
+
+	SECTION("sample_sort") 
+	{
+		for (size_t n : { 0, 1, 100, 5000, 200000 }) 
+		{
+			vector<uint64_t> v(n);
+			for (auto& x : v) x = (uint64_t(rnd()) << 32) | rnd();
+			auto expected = v;
+			sort(expected.begin(), expected.end());
+			stdx::sample_sort(v.begin(), v.end(), less<uint64_t>(), 4);
+			REQUIRE(v == expected);
+
+			// heavily skewed keys
+			exponential_distribution<double> expd(0.5);
+			for (auto& x : v) x = static_cast<uint64_t>(expd(rnd));
+			expected = v;
+			sort(expected.begin(), expected.end());
+			stdx::sample_sort(v.begin(), v.end(), less<uint64_t>(), 3);
+			REQUIRE(v == expected);
+		}
+
+		vector<string> strs(50000);
+		for (auto& s : strs) s = to_string(rnd() % 5000);
+		auto expected = strs;
+		sort(expected.begin(), expected.end(), greater<string>());
+		stdx::sample_sort(strs.begin(), strs.end(), greater<string>(), 4);
+		REQUIRE(strs == expected);
+
+		vector<int> v(100000);
+		for (auto& x : v) x = static_cast<int>(rnd() % 1000) - 500;
+		stdx::sample_sort(v.begin(), v.end());
+		REQUIRE(is_sorted(v.begin(), v.end()));
+	}
+
+	SECTION("bucket_sort with bucketizer<int>")
+	{
+		vector<int> v(50000);
+		for (auto& x : v) x = static_cast<int>(rnd() % 100000);
+		stdx::thread_set threads;
+		stdx::bucket_sort(v.begin(), v.end(), stdx::bucketizer<int>(v.begin(), v.end()), less<int>(), 2, threads);
+		REQUIRE(is_sorted(v.begin(), v.end()));
+	}
+}
+
+
+
+TEST_CASE("algorithms/small_sort", "[algorithm.sorting]")
+{
+	using namespace std;
+
+	std::mt19937_64 rnd;
+
+	auto check = [](auto v) {
+		auto expected = v;
+		sort(expected.begin(), expected.end());
+		stdx::small_sort(v.begin(), v.end());
+		return v == expected;
+	};
+
+	for (size_t n = 0; n <= 70; n++) 
+	{
+		vector<int32_t> i32(n);
+		vector<int64_t> i64(n);
+		vector<float> f32(n);
+		vector<double> f64(n);
+		vector<string> strs(n);
+		for (size_t i = 0; i < n; i++) {
+			i64[i] = static_cast<int64_t>(rnd());
+			i32[i] = static_cast<int32_t>(i64[i]);
+			f64[i] = static_cast<double>(i64[i] % 1000) / 7.0;
+			f32[i] = static_cast<float>(f64[i]);
+			strs[i] = to_string(i32[i]);
+		}
+		REQUIRE(check(i32));
+		REQUIRE(check(i64));
+		REQUIRE(check(f32));
+		REQUIRE(check(f64));
+		REQUIRE(check(strs));
+
+		// duplicates and extreme values
+		for (size_t i = 0; i < n; i++) {
+			i32[i] = (i % 3 == 0 ? numeric_limits<int32_t>::max() : static_cast<int32_t>(rnd() % 4) - 2);
+			i64[i] = (i % 5 == 0 ? numeric_limits<int64_t>::min() : static_cast<int64_t>(rnd() % 4));
+			f64[i] = (i % 4 == 0 ? -numeric_limits<double>::infinity() : static_cast<double>(rnd() % 3));
+		}
+		REQUIRE(check(i32));
+		REQUIRE(check(i64));
+		REQUIRE(check(f64));
+	}
+
+	// signed zeros compare equal but must not be duplicated
+	auto negative_zeros = [](const auto& v) {
+		return count_if(v.begin(), v.end(), [](auto x) { return x == 0 && signbit(x); });
+	};
+	for (size_t n : { 8, 16, 33, 64 }) 
+	{
+		vector<double> z64(n);
+		vector<float> z32(n);
+		for (size_t i = 0; i < n; i++) {
+			z64[i] = (rnd() % 5 == 0 ? 1.0 : (rnd() % 2 ? -0.0 : 0.0));
+			z32[i] = static_cast<float>(z64[i]);
+		}
+		auto zeros64 = negative_zeros(z64);
+		auto zeros32 = negative_zeros(z32);
+		stdx::small_sort(z64.begin(), z64.end());
+		stdx::small_sort(z32.begin(), z32.end());
+		REQUIRE(is_sorted(z64.begin(), z64.end()));
+		REQUIRE(is_sorted(z32.begin(), z32.end()));
+		REQUIRE(negative_zeros(z64) == zeros64);
+		REQUIRE(negative_zeros(z32) == zeros32);
+	}
+
+	vector<double> nan = { 3.0, 1.0, numeric_limits<double>::quiet_NaN(), 2.0 };
+	stdx::small_sort(nan.begin(), nan.end());
+	REQUIRE(count_if(nan.begin(), nan.end(), [](double x) { return x != x; }) == 1);
+
+	int arr[] = { 5, 4, 3, 2, 1 };
+	stdx::small_sort(begin(arr), end(arr), greater<int>());
+	REQUIRE(is_sorted(begin(arr), end(arr), greater<int>()));
+}
+
+TEST_CASE("algorithms/simd_sort", "[algorithm.sorting]")
+{
+	using namespace std;
+
+	std::mt19937_64 rnd;
+
+	auto check = [](auto v) {
+		auto expected = v;
+		sort(expected.begin(), expected.end());
+		stdx::simd_sort(v.begin(), v.end());
+		return v == expected;
+	};
+
+	for (size_t n : { 0, 1, 63, 64, 65, 100, 1000, 4097, 100000 }) 
+	{
+		vector<int32_t> i32(n);
+		vector<int64_t> i64(n);
+		vector<float> f32(n);
+		vector<double> f64(n);
+		for (size_t i = 0; i < n; i++) {
+			i64[i] = static_cast<int64_t>(rnd());
+			i32[i] = static_cast<int32_t>(i64[i]);
+			f64[i] = static_cast<double>(i32[i]) / 3.0;
+			f32[i] = static_cast<float>(f64[i]);
+		}
+		REQUIRE(check(i32));
+		REQUIRE(check(i64));
+		REQUIRE(check(f32));
+		REQUIRE(check(f64));
+
+		// few distinct keys
+		for (size_t i = 0; i < n; i++) {
+			i32[i] = static_cast<int32_t>(rnd() % 3);
+			i64[i] = (rnd() % 2 ? numeric_limits<int64_t>::max() : numeric_limits<int64_t>::min());
+		}
+		REQUIRE(check(i32));
+		REQUIRE(check(i64));
+
+		// presorted
+		sort(f64.begin(), f64.end());
+		REQUIRE(check(f64));
+		reverse(f64.begin(), f64.end());
+		REQUIRE(check(f64));
+
+		fill(i32.begin(), i32.end(), 7);
+		REQUIRE(check(i32));
+	}
+
+	vector<double> zeros(10000);
+	for (auto& x : zeros)
+		x = (rnd() % 3 == 0 ? -1.0 : (rnd() % 2 ? -0.0 : 0.0));
+	auto negative = count_if(zeros.begin(), zeros.end(), [](double x) { return x == 0 && signbit(x); });
+	stdx::simd_sort(zeros.begin(), zeros.end());
+	REQUIRE(is_sorted(zeros.begin(), zeros.end()));
+	REQUIRE(count_if(zeros.begin(), zeros.end(), [](double x) { return x == 0 && signbit(x); }) == negative);
+
+	vector<string> strs = { "c", "a", "b" };
+	stdx::simd_sort(strs.begin(), strs.end());
+	REQUIRE(is_sorted(strs.begin(), strs.end()));
+}
+
+
+
+TEST_CASE("algorithms/parallel_sort", "[algorithm.sorting]")
+{
+	using namespace std;
+	mt19937 rnd(17);
+
+	// heavy duplicates make splitter selection resolve equal keys
+	for (size_t n : { size_t(1000), size_t(200000), size_t(300007) }) {
+		for (uint32_t range : { 4u, 1000u, 0xFFFFFFFFu }) {
+			vector<uint32_t> v(n);
+			for (auto& x : v)
+				x = rnd() % range;
+			vector<uint32_t> desired = v;
+			std::sort(desired.begin(), desired.end());
+
+			for (size_t nthreads : { 1, 3, 4, 8 }) {
+				vector<uint32_t> w = v;
+				stdx::parallel_sort(w.begin(), w.end(), std::less<>(), nthreads);
+				REQUIRE(w == desired);
+			}
+		}
+	}
+
+	vector<string> strs(100000);
+	for (auto& s : strs)
+		s = to_string(rnd() % 5000);
+	vector<string> desired = strs;
+	std::sort(desired.begin(), desired.end(), std::greater<>());
+
+	stdx::thread_set pool;
+	stdx::parallel_sort(strs.begin(), strs.end(), std::greater<>(), 3, pool);
+	REQUIRE(strs == desired);
+}
@@ -0,0 +1,231 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/allocators/heap_arena.hpp>
+#include <stlext/allocators/stats_arena.hpp>
+#include <stlext/allocators/binexp_arena.hpp>
+#include <stlext/allocators/concurrent_freelist.hpp>
+#include <stlext/allocators/pooled_object.hpp>
+
+
+namespace
+{
+    struct block
+    {
+        void* link;                // overwritten by free list
+        std::atomic<bool> taken;
+    };
+
+    // serves memory from static buffer and counts requests
+    struct allocator_stats
+    {
+        static std::atomic<size_t> allocations;
+        static std::atomic<size_t> deallocations;
+        static std::atomic<size_t> bytes;
+    };
+    std::atomic<size_t> allocator_stats::allocations(0);
+    std::atomic<size_t> allocator_stats::deallocations(0);
+    std::atomic<size_t> allocator_stats::bytes(0);
+
+    template<class T>
+    struct counting_allocator
+    {
+        typedef T value_type;
+
+        counting_allocator() = default;
+        template<class U>
+        counting_allocator(const counting_allocator<U>&) {}
+
+        T* allocate(size_t n) {
+            alignas(16) static char buffer[1 << 23];
+            static std::atomic<size_t> used(0);
+            size_t nbytes = (n * sizeof(T) + 15) & ~size_t(15);
+            size_t offset = used.fetch_add(nbytes);
+            if (offset + nbytes > sizeof(buffer))
+                throw std::bad_alloc();
+            allocator_stats::allocations++;
+            allocator_stats::bytes += n * sizeof(T);
+            return reinterpret_cast<T*>(buffer + offset);
+        }
+
+        void deallocate(T*, size_t) {
+            allocator_stats::deallocations++;
+        }
+    };
+
+    template<template<size_t> class _FreeList>
+    struct pooled :
+        public stdx::pooled_object<pooled<_FreeList>, counting_allocator<pooled<_FreeList>>, 2, _FreeList>
+    {
+        double payload[4];
+    };
+
+    void reset_allocator_stats() {
+        allocator_stats::allocations = 0;
+        allocator_stats::deallocations = 0;
+        allocator_stats::bytes = 0;
+    }
+}
+
+
+TEST_CASE("allocators/concurrent_freelist", "[allocators]")
+{
+    const size_t nblocks = 1024;
+    const int nthreads = 8;
+    const size_t iterations = 20000;
+
+    std::vector<block> blocks(nblocks);
+    stdx::concurrent_freelist<> list;
+    REQUIRE(list.empty());
+    for (auto& b : blocks) {
+        b.taken = false;
+        REQUIRE(list.push(&b));
+    }
+
+    // every popped block is owned by exactly one thread
+    std::atomic<size_t> duplicates(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&] {
+            std::vector<block*> held;
+            for (size_t i = 0; i < iterations; i++) {
+                block* b = static_cast<block*>(list.pop());
+                if (b != nullptr) {
+                    if (b->taken.exchange(true))
+                        duplicates++;
+                    held.push_back(b);
+                }
+                if (held.size() > 3 || (b == nullptr && !held.empty())) {
+                    for (block* h : held) {
+                        h->taken = false;
+                        list.push(h);
+                    }
+                    held.clear();
+                }
+            }
+            for (block* h : held) {
+                h->taken = false;
+                list.push(h);
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    REQUIRE(duplicates == 0);
+
+    // no block is lost or duplicated
+    std::vector<void*> popped;
+    while (void* p = list.pop())
+        popped.push_back(p);
+    REQUIRE(list.empty());
+    REQUIRE(popped.size() == nblocks);
+    std::sort(popped.begin(), popped.end());
+    REQUIRE(std::unique(popped.begin(), popped.end()) == popped.end());
+    REQUIRE(popped.front() == &blocks.front());
+    REQUIRE(popped.back() == &blocks.back());
+
+    // bounded list rejects blocks above maximum size
+    stdx::concurrent_freelist<4> bounded;
+    for (size_t i = 0; i < 4; i++)
+        REQUIRE(bounded.push(&blocks[i]));
+    REQUIRE(!bounded.push(&blocks[4]));
+    REQUIRE(bounded.pop() == &blocks[3]);
+    REQUIRE(bounded.push(&blocks[5]));
+    size_t count = 0;
+    while (bounded.pop() != nullptr)
+        count++;
+    REQUIRE(count == 4);
+}
+
+
+TEST_CASE("allocators/binexp_arena/concurrent_freelist", "[allocators]")
+{
+    typedef stdx::stats_arena<stdx::malloc_arena<>> upstream_type;
+    typedef stdx::binexp_arena<upstream_type, 0, void, stdx::empty_delete<>, stdx::concurrent_freelist> arena_type;
+    const int nthreads = 4;
+    const size_t iterations = 10000;
+
+    upstream_type upstream;
+    {
+        arena_type arena(upstream);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nthreads; t++) {
+            threads.emplace_back([&] {
+                for (size_t i = 0; i < iterations; i++) {
+                    void* a = arena.allocate(24);
+                    void* b = arena.allocate(100);
+                    arena.deallocate(a, 24);
+                    arena.deallocate(b, 100);
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        // blocks are recycled through shared free lists
+        stdx::arena_stats st = upstream.stats();
+        REQUIRE(st.allocations <= 2 * nthreads);
+        REQUIRE(st.deallocations == 0);
+    }
+    REQUIRE(upstream.stats().bytes_in_use == 0);
+}
+
+
+template<template<size_t> class _FreeList>
+static void check_pooled_object()
+{
+    typedef pooled<_FreeList> object;
+    reset_allocator_stats();
+
+    // blocks of object size are requested in bytes
+    std::vector<object*> objects;
+    for (size_t i = 0; i < 4; i++)
+        objects.push_back(new object);
+    REQUIRE(allocator_stats::allocations == 4);
+    REQUIRE(allocator_stats::bytes == 4 * sizeof(object));
+
+    // two blocks are cached, blocks rejected by free list are released
+    for (object* p : objects)
+        delete p;
+    REQUIRE(allocator_stats::deallocations == 2);
+
+    objects.clear();
+    for (size_t i = 0; i < 3; i++)
+        objects.push_back(new object);
+    REQUIRE(allocator_stats::allocations == 5);
+    for (object* p : objects)
+        delete p;
+    REQUIRE(allocator_stats::deallocations == 3);
+    REQUIRE(allocator_stats::allocations - allocator_stats::deallocations == 2);
+}
+
+
+TEST_CASE("allocators/pooled_object", "[allocators]")
+{
+    check_pooled_object<stdx::freelist>();
+    check_pooled_object<stdx::concurrent_freelist>();
+
+    // concurrent free list is shared by all threads
+    typedef pooled<stdx::concurrent_freelist> object;
+    const int nthreads = 4;
+    const size_t iterations = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < iterations; i++) {
+                std::unique_ptr<object> a(new object), b(new object);
+                a->payload[0] = b->payload[3] = static_cast<double>(i);
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    // every block is either released or cached
+    REQUIRE(allocator_stats::allocations - allocator_stats::deallocations == 2);
+}
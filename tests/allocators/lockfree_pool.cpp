@@ -0,0 +1,134 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <stlext/allocators/lockfree_pool.hpp>
+
+
+namespace
+{
+    struct tracked
+    {
+        static std::atomic<int> alive;
+
+        int value;
+
+        explicit tracked(int v) : value(v) {
+            if (v < 0)
+                throw std::runtime_error("tracked");
+            alive++;
+        }
+        ~tracked() { alive--; }
+    };
+    std::atomic<int> tracked::alive(0);
+}
+
+
+TEST_CASE("allocators/lockfree_pool", "[allocators]")
+{
+    stdx::lockfree_pool<tracked, 4> pool;
+    REQUIRE(pool.capacity() == 4);
+    REQUIRE(!pool.empty());
+
+    // exhaustion
+    std::set<tracked*> objects;
+    for (int i = 0; i < 4; i++) {
+        tracked* p = pool.construct(i);
+        REQUIRE(p != nullptr);
+        REQUIRE(pool.contains(p));
+        REQUIRE(p->value == i);
+        objects.insert(p);
+    }
+    REQUIRE(objects.size() == 4);
+    REQUIRE(pool.empty());
+    REQUIRE(pool.allocate() == nullptr);
+    REQUIRE(pool.construct(5) == nullptr);
+    REQUIRE(tracked::alive == 4);
+
+    int local = 0;
+    REQUIRE(!pool.contains(&local));
+
+    // released slot is reused
+    tracked* first = *objects.begin();
+    pool.destroy(first);
+    objects.erase(first);
+    REQUIRE(tracked::alive == 3);
+    REQUIRE(pool.construct(7) == first);
+    objects.insert(first);
+
+    for (tracked* p : objects)
+        pool.destroy(p);
+    REQUIRE(tracked::alive == 0);
+
+    // throwing constructor returns slot to pool
+    for (int i = 0; i < 8; i++)
+        REQUIRE_THROWS_AS(pool.construct(-1), std::runtime_error);
+    REQUIRE(tracked::alive == 0);
+    objects.clear();
+    for (int i = 0; i < 4; i++)
+        objects.insert(pool.construct(i));
+    REQUIRE(objects.size() == 4);
+    REQUIRE(objects.count(nullptr) == 0);
+    REQUIRE(pool.empty());
+    for (tracked* p : objects)
+        pool.destroy(p);
+}
+
+
+TEST_CASE("allocators/lockfree_pool/threads", "[allocators]")
+{
+    stdx::lockfree_pool<tracked, 64> pool;
+    const int nthreads = 8;
+    const int iterations = 20000;
+    std::atomic<size_t> duplicates(0);
+
+    // objects are constructed on one thread and destroyed on another
+    std::vector<tracked*> handoff(nthreads, nullptr);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&, t] {
+            // slot owned by other thread would be overwritten
+            std::vector<std::pair<tracked*, int>> held;
+            auto release = [&] {
+                for (auto& h : held) {
+                    if (h.first->value != h.second)
+                        duplicates++;
+                    pool.destroy(h.first);
+                }
+                held.clear();
+            };
+            for (int i = 0; i < iterations; i++) {
+                int value = t * iterations + i;
+                tracked* p = pool.construct(value);
+                if (p != nullptr)
+                    held.emplace_back(p, value);
+                if (held.size() > 4 || p == nullptr)
+                    release();
+            }
+            release();
+            handoff[t] = pool.construct(t);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(duplicates == 0);
+    for (int t = 0; t < nthreads; t++) {
+        REQUIRE(handoff[t] != nullptr);
+        REQUIRE(handoff[t]->value == t);
+        pool.destroy(handoff[t]);
+    }
+    REQUIRE(tracked::alive == 0);
+
+    // all slots are back in pool
+    std::set<tracked*> slots;
+    while (tracked* p = pool.allocate())
+        slots.insert(p);
+    REQUIRE(slots.size() == 64);
+    for (tracked* p : slots)
+        pool.deallocate(p);
+}
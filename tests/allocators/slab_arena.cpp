@@ -0,0 +1,145 @@
+#include <catch.hpp>
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/allocators/heap_arena.hpp>
+#include <stlext/allocators/stats_arena.hpp>
+#include <stlext/allocators/slab_arena.hpp>
+
+
+TEST_CASE("allocators/slab_arena/size_class", "[allocators]")
+{
+    typedef stdx::slab_arena<> arena_type;
+    const size_t maxsize = arena_type::MAXSIZE;
+    const size_t nclasses = arena_type::CLASSCOUNT;
+
+    REQUIRE(arena_type::size_class(1) == 0);
+    REQUIRE(arena_type::size_class(8) == 0);
+    REQUIRE(arena_type::size_class(9) == 1);
+    REQUIRE(arena_type::size_class(64) == 7);
+    REQUIRE(arena_type::class_size(8) == 72);
+    REQUIRE(arena_type::size_class(maxsize) == nclasses - 1);
+    REQUIRE(arena_type::class_size(nclasses - 1) == maxsize);
+
+    for (size_t c = 0; c < nclasses; c++) {
+        REQUIRE(arena_type::size_class(arena_type::class_size(c)) == c);
+        if (c > 0)
+            REQUIRE(arena_type::class_size(c - 1) < arena_type::class_size(c));
+    }
+
+    // smallest class holding request, waste above 64 bytes is at most 12.5%
+    for (size_t n = 1; n <= maxsize; n++) {
+        size_t c = arena_type::size_class(n);
+        size_t size = arena_type::class_size(c);
+        REQUIRE(size >= n);
+        REQUIRE((c == 0 || arena_type::class_size(c - 1) < n));
+        if (n > 64)
+            REQUIRE((size - n) * 8 <= n);
+        else
+            REQUIRE(size - n < 8);
+    }
+}
+
+
+TEST_CASE("allocators/slab_arena", "[allocators]")
+{
+    typedef stdx::stats_arena<stdx::aligned_arena<4096>> upstream_type;
+    typedef stdx::slab_arena<upstream_type> arena_type;
+    const size_t slab = arena_type::SLABSIZE;
+    const size_t maxsize = arena_type::MAXSIZE;
+
+    upstream_type upstream;
+    {
+        arena_type arena(upstream);
+
+        // objects of different classes do not overlap
+        std::vector<std::pair<char*, size_t>> blocks;
+        const size_t sizes[3] = { 24, 100, 500 };
+        size_t slabs[3];
+        for (size_t k = 0; k < 3; k++) {
+            size_t before = upstream.stats().allocations;
+            for (size_t i = 0; i < 1000; i++) {
+                char* p = static_cast<char*>(arena.allocate(sizes[k]));
+                REQUIRE(p != nullptr);
+                REQUIRE(reinterpret_cast<uintptr_t>(p) % 8 == 0);
+                memset(p, static_cast<int>(blocks.size() & 0xFF), sizes[k]);
+                blocks.emplace_back(p, sizes[k]);
+            }
+            slabs[k] = upstream.stats().allocations - before;
+            size_t capacity = (slab - 128) / arena_type::class_size(arena_type::size_class(sizes[k]));
+            REQUIRE(slabs[k] >= (1000 + capacity - 1) / capacity);
+        }
+        bool intact = true;
+        for (size_t i = 0; i < blocks.size(); i++) {
+            intact &= (std::count(blocks[i].first, blocks[i].first + blocks[i].second, static_cast<char>(i & 0xFF))
+                       == static_cast<ptrdiff_t>(blocks[i].second));
+        }
+        REQUIRE(intact);
+
+        // aligned upstream: each slab is a single block of slab size
+        stdx::arena_stats st = upstream.stats();
+        REQUIRE(st.bytes_allocated == st.allocations * slab);
+        REQUIRE(st.deallocations == 0);
+
+        // freed object is reused first
+        char* reused = blocks[3].first;
+        REQUIRE(arena.deallocate(reused, 24) == nullptr);
+        REQUIRE(arena.allocate(20) == reused);
+
+        // empty slabs go upstream, but the last one of class is kept
+        for (size_t k = 0; k < 2; k++) {
+            for (size_t i = k * 1000; i < (k + 1) * 1000; i++)
+                REQUIRE(arena.deallocate(blocks[i].first, blocks[i].second) == nullptr);
+        }
+        st = upstream.stats();
+        REQUIRE(st.deallocations == slabs[0] - 1 + slabs[1] - 1);
+        REQUIRE(st.bytes_in_use == static_cast<int64_t>((2 + slabs[2]) * slab));
+
+        // kept slab serves the next request
+        void* p = arena.allocate(24);
+        REQUIRE(upstream.stats().allocations == slabs[0] + slabs[1] + slabs[2]);
+        REQUIRE(arena.deallocate(p, 24) == nullptr);
+
+        // requests above maximum size are forwarded upstream
+        upstream.reset();
+        void* large = arena.allocate(maxsize + 1);
+        REQUIRE(large != nullptr);
+        st = upstream.stats();
+        REQUIRE(st.allocations == 1);
+        REQUIRE(st.bytes_allocated == maxsize + 1);
+        REQUIRE(arena.deallocate(large, maxsize + 1) == nullptr);
+        REQUIRE(upstream.stats().deallocations == 1);
+
+        REQUIRE(arena.allocate(0) == nullptr);
+    }
+    // destructor returns remaining slabs
+    REQUIRE(upstream.stats().bytes_in_use == 0);
+    REQUIRE(upstream.use_count() == 0);
+}
+
+
+TEST_CASE("allocators/slab_arena/unaligned_upstream", "[allocators]")
+{
+    typedef stdx::stats_arena<stdx::malloc_arena<>> upstream_type;
+    typedef stdx::slab_arena<upstream_type, 1024, 128> arena_type;
+
+    upstream_type upstream;
+    {
+        arena_type arena(upstream);
+        std::vector<std::pair<char*, size_t>> blocks;
+        for (size_t i = 0; i < 300; i++) {
+            size_t n = 1 + i % arena_type::MAXSIZE;
+            char* p = static_cast<char*>(arena.allocate(n));
+            REQUIRE(p != nullptr);
+            memset(p, static_cast<int>(i & 0xFF), n);
+            blocks.emplace_back(p, n);
+        }
+        for (size_t i = 0; i < blocks.size(); i++) {
+            REQUIRE(static_cast<unsigned char>(blocks[i].first[blocks[i].second - 1]) == (i & 0xFF));
+            REQUIRE(arena.deallocate(blocks[i].first, blocks[i].second) == nullptr);
+        }
+    }
+    REQUIRE(upstream.stats().bytes_in_use == 0);
+}
@@ -0,0 +1,231 @@
+#include <catch.hpp>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <type_traits>
+
+#include <stlext/allocators/heap_arena.hpp>
+#include <stlext/allocators/fallback_arena.hpp>
+#include <stlext/allocators/stats_arena.hpp>
+
+
+namespace
+{
+    // stateful arena serving at most limit bytes, rejects foreign blocks
+    class limited_arena :
+        public stdx::basic_arena<void, stdx::empty_delete<>, false>
+    {
+    public:
+        explicit limited_arena(size_t limit = 0) : limit_(limit), used_(0) {}
+
+        void* allocate(size_t n) {
+            if (used_ + n > limit_)
+                return nullptr;
+            void* p = ::malloc(n);
+            used_ += n;
+            owned_.insert(p);
+            return p;
+        }
+
+        void* reallocate(size_t n, void*) { return allocate(n); }
+
+        void* deallocate(void* p, size_t n) {
+            if (owned_.erase(p) == 0)
+                return p;
+            used_ -= n;
+            ::free(p);
+            return nullptr;
+        }
+
+        template<typename T>
+        size_t max_size() const { return limit_ / sizeof(T); }
+
+    private:
+        size_t limit_, used_;
+        std::set<void*> owned_;
+    };
+}
+
+
+TEST_CASE("allocators/stats_arena", "[allocators]")
+{
+    stdx::stats_arena<stdx::malloc_arena<>> arena;
+
+    REQUIRE(stdx::arena_stats::bin_index(1) == 0);
+    REQUIRE(stdx::arena_stats::bin_index(2) == 1);
+    REQUIRE(stdx::arena_stats::bin_index(3) == 2);
+    REQUIRE(stdx::arena_stats::bin_index(100) == 7);
+    REQUIRE(stdx::arena_stats::bin_index(4096) == 12);
+    REQUIRE(stdx::arena_stats::bin_size(7) == 128);
+
+    std::vector<size_t> sizes = { 1, 2, 3, 100, 128, 4096 };
+    std::vector<void*> blocks;
+    for (size_t n : sizes)
+        blocks.push_back(arena.allocate(n));
+
+    stdx::arena_stats st = arena.stats();
+    REQUIRE(st.allocations == 6);
+    REQUIRE(st.deallocations == 0);
+    REQUIRE(st.failures == 0);
+    REQUIRE(st.bytes_allocated == 4330);
+    REQUIRE(st.bytes_in_use == 4330);
+    REQUIRE(st.peak_bytes_in_use == 4330);
+    REQUIRE(st.histogram[0] == 1);
+    REQUIRE(st.histogram[1] == 1);
+    REQUIRE(st.histogram[2] == 1);
+    REQUIRE(st.histogram[7] == 2);
+    REQUIRE(st.histogram[12] == 1);
+
+    for (size_t i = 0; i < sizes.size(); i++)
+        REQUIRE(arena.deallocate(blocks[i], sizes[i]) == nullptr);
+    st = arena.stats();
+    REQUIRE(st.deallocations == 6);
+    REQUIRE(st.bytes_deallocated == 4330);
+    REQUIRE(st.bytes_in_use == 0);
+    REQUIRE(st.peak_bytes_in_use == 4330);
+
+    // realloc releases the hint block
+    arena.reset();
+    REQUIRE(arena.stats().peak_bytes_in_use == 0);
+    void* p = arena.allocate(100);
+    p = arena.reallocate(1000, p, 100);
+    REQUIRE(p != nullptr);
+    REQUIRE(arena.deallocate(p, 1000) == nullptr);
+    st = arena.stats();
+    REQUIRE(st.allocations == 1);
+    REQUIRE(st.reallocations == 1);
+    REQUIRE(st.bytes_in_use == 0);
+    REQUIRE(st.peak_bytes_in_use == 1000);
+    REQUIRE(st.bytes_allocated == st.bytes_deallocated);
+
+    // reset keeps bytes in use as the new peak
+    void* q = arena.allocate(64);
+    arena.reset();
+    st = arena.stats();
+    REQUIRE(st.allocations == 0);
+    REQUIRE(st.histogram[6] == 0);
+    REQUIRE(st.bytes_in_use == 64);
+    REQUIRE(st.peak_bytes_in_use == 64);
+    arena.deallocate(q, 64);
+    REQUIRE(arena.stats().bytes_in_use == 0);
+
+    // hint is ignored: reallocation is a fresh block
+    stdx::stats_arena<stdx::newdel_arena<>> newdel;
+    void* a = newdel.allocate(16);
+    void* b = newdel.reallocate(32, a);
+    REQUIRE(newdel.stats().bytes_in_use == 48);
+    newdel.deallocate(a, 16);
+    newdel.deallocate(b, 32);
+    REQUIRE(newdel.stats().bytes_in_use == 0);
+    REQUIRE(newdel.stats().peak_bytes_in_use == 48);
+}
+
+
+TEST_CASE("allocators/stats_arena/threads", "[allocators]")
+{
+    stdx::stats_arena<stdx::malloc_arena<>> arena;
+    const int nthreads = 8;
+    const size_t iterations = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < iterations; i++) {
+                void* p = arena.allocate(24);
+                arena.deallocate(p, 24);
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    stdx::arena_stats st = arena.stats();
+    REQUIRE(st.allocations == nthreads * iterations);
+    REQUIRE(st.deallocations == nthreads * iterations);
+    REQUIRE(st.bytes_allocated == nthreads * iterations * 24);
+    REQUIRE(st.histogram[5] == nthreads * iterations);
+    REQUIRE(st.bytes_in_use == 0);
+    REQUIRE(st.peak_bytes_in_use >= 24);
+    REQUIRE(st.peak_bytes_in_use <= nthreads * 24);
+}
+
+
+TEST_CASE("allocators/stats_arena/fallback", "[allocators]")
+{
+    typedef stdx::stats_arena<limited_arena> primary_arena;
+    typedef stdx::fallback_arena<primary_arena, stdx::malloc_arena<>> arena_type;
+
+    // stateful arenas are held by intrusive pointer, stateless by value
+    REQUIRE((std::is_same<stdx::arena_traits<primary_arena>::member_type, stdx::intrusive_ptr<primary_arena>>::value));
+    REQUIRE((std::is_same<stdx::arena_traits<stdx::malloc_arena<>>::member_type, stdx::malloc_arena<>>::value));
+
+    limited_arena limited(256);
+    primary_arena primary(limited);
+    REQUIRE(limited.use_count() == 1);
+    {
+        arena_type arena(primary, stdx::malloc_arena<>());
+        REQUIRE(primary.use_count() == 1);
+
+        void* a = arena.allocate(100);
+        void* b = arena.allocate(100);
+        void* c = arena.allocate(100); // primary is exhausted
+        void* d = arena.reallocate(100, nullptr);
+        REQUIRE((a && b && c && d));
+
+        stdx::arena_stats st = primary.stats();
+        REQUIRE(st.allocations == 2);
+        REQUIRE(st.failures == 2);
+        REQUIRE(st.bytes_in_use == 200);
+
+        REQUIRE(arena.deallocate(d, 100) == nullptr);
+        REQUIRE(arena.deallocate(c, 100) == nullptr);
+        REQUIRE(arena.deallocate(b, 100) == nullptr);
+        REQUIRE(arena.deallocate(a, 100) == nullptr);
+
+        st = primary.stats();
+        REQUIRE(st.rejects == 2);
+        REQUIRE(st.deallocations == 2);
+        REQUIRE(st.bytes_in_use == 0);
+    }
+    REQUIRE(primary.use_count() == 0);
+}
+
+
+TEST_CASE("allocators/stats_arena/dump", "[allocators]")
+{
+    stdx::stats_arena<stdx::malloc_arena<>> arena;
+    void* a = arena.allocate(100);
+    void* b = arena.allocate(3);
+    arena.deallocate(b, 3);
+
+    std::ostringstream text;
+    arena.dump(text);
+    REQUIRE(text.str().find("allocations:       2\n") != std::string::npos);
+    REQUIRE(text.str().find("bytes in use:      100\n") != std::string::npos);
+    REQUIRE(text.str().find("  <= 128: 1\n") != std::string::npos);
+    REQUIRE(text.str().find("  <= 4: 1\n") != std::string::npos);
+
+    std::ostringstream json;
+    arena.dump(json, stdx::stats_json);
+    REQUIRE(json.str() ==
+        "{\"stats\":{\"allocations\":2,\"reallocations\":0,\"deallocations\":1,\"failures\":0,\"rejects\":0,"
+        "\"bytes_allocated\":103,\"bytes_deallocated\":3,\"bytes_in_use\":100,\"peak_bytes_in_use\":103,"
+        "\"histogram\":{\"4\":1,\"128\":1}},\"traces\":[]}");
+
+    // every allocation is sampled
+    arena.set_sampling(1);
+    void* c = arena.allocate(8);
+#ifdef _STDX_HAVE_BACKTRACE
+    REQUIRE(arena.traces().size() == 1);
+    REQUIRE(arena.traces()[0].nbytes == 8);
+    REQUIRE(arena.traces()[0].nframes > 0);
+#endif
+    arena.reset();
+    REQUIRE(arena.traces().empty());
+
+    arena.deallocate(c, 8);
+    arena.deallocate(a, 100);
+}
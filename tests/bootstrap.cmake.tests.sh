@@ -11,7 +11,12 @@ echo 'set(CMAKE_LFLAGS "${CMAKE_LFLAGS} -fsanitize=address")'
 echo 'include_directories(../ ../catch ${CMAKE_CURRENT_SOURCE_DIR})'
 echo 'add_executable(${PROJECT_NAME}'
 echo '  algorithm/experimental.cpp'
+echo '  algorithm/searching.cpp'
 echo '  algorithm/sorting.cpp' 
+echo '  allocators/concurrent_freelist.cpp'
+echo '  allocators/lockfree_pool.cpp'
+echo '  allocators/slab_arena.cpp'
+echo '  allocators/stats_arena.cpp'
 echo '  bitvector/bitvector.cpp'
 echo '  compability/c++11_algo.cpp'
 echo '  compability/c++14_algo.cpp'
@@ -30,8 +35,14 @@ echo '  iostreams/ostream_joiner.cpp'
 echo '  iostreams/ratio.cpp'
 echo '  iterator/iterators.cpp' 
 echo '  containers/lru_cache.cpp' 
+echo '  containers/circular_queue.cpp'
+echo '  containers/concurrent_circular_queue.cpp'
+echo '  containers/front_coded_dictionary.cpp'
 echo '  containers/packed_hashtbl.cpp' 
+echo '  containers/priority_set.cpp'
+echo '  containers/static_stringset.cpp'
 echo '  containers/stringset.cpp'
+echo '  containers/string_interner.cpp'
 echo '  containers/span.cpp'
 echo '  main.cpp'
 echo ')'
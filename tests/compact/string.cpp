@@ -415,6 +415,68 @@ TEST_CASE("compact/string.compare", "[compact]")
     REQUIRE(strlt < s1);
 }
 
+TEST_CASE("compact/string.fast_paths", "[compact]")
+{
+    // in-place strings with stale bytes past the end
+    compact::string a = "abcde";
+    a.pop_back();
+    a.pop_back();
+    compact::string b = "abx";
+    b.pop_back();
+    REQUIRE(a == "abc");
+    REQUIRE(b == "ab");
+    b.push_back('c');
+    REQUIRE(a == b);
+    REQUIRE(a.hash_code() == b.hash_code());
+    REQUIRE(a.compare(b) == 0);
+
+    std::vector<std::string> words = { "", "a", "ab", "abc", "abd", "b", std::string("a\0", 2),
+                                       "\xff", "zzzzz", "aaaaa", "hello world", "hello" };
+    for (auto& x : words) {
+        for (auto& y : words) {
+            compact::string cx(x), cy(y);
+            compact::tagged_string<2> ty(y);
+            int expected = x.compare(y);
+            int r = cx.compare(cy);
+            REQUIRE((r < 0) == (expected < 0));
+            REQUIRE((r > 0) == (expected > 0));
+            REQUIRE((cx.compare(ty) < 0) == (expected < 0));
+            REQUIRE((cx == cy) == (x == y));
+            REQUIRE((cx == y) == (x == y));
+            if (x == y)
+                REQUIRE(cx.hash_code() == ty.hash_code());
+        }
+    }
+
+    std::string text = "The quick brown fox jumps over the lazy dog; "
+                       "the five boxing wizards jump quickly. 0123456789";
+    compact::string ct(text);
+    for (std::string needle : { "T", "q", "dog", "jump", "quickly.", "0123456789", "9", "",
+                                "cat", "wizards jump quickly. 0123456789x", "the five" }) {
+        for (size_t pos : { 0, 1, 5, 40, 90, 200 }) {
+            REQUIRE(ct.find(needle, pos) == (text.find(needle, pos) == std::string::npos ? ct.npos : text.find(needle, pos)));
+            REQUIRE(ct.find_first_of(needle, pos) ==
+                    (text.find_first_of(needle, pos) == std::string::npos ? ct.npos : text.find_first_of(needle, pos)));
+        }
+    }
+    std::string dense(1000, 'a');
+    dense[700] = 'b';
+    compact::string cd(dense);
+    REQUIRE(cd.find("aab") == 698);
+    REQUIRE(cd.find("aab", 699) == cd.npos);
+    REQUIRE(cd.find("ba") == 700);
+    REQUIRE(cd.find(std::string(250, 'a'), 500) == 701);
+
+    REQUIRE(ct.find('z') == text.find('z'));
+    REQUIRE(ct.find('#') == ct.npos);
+    REQUIRE(ct.find_first_of("#@!?0") == text.find('0'));
+    REQUIRE(ct.find_first_of("abcdefghijklmnopqrstuvwxyz.", 44) == text.find_first_of("abcdefghijklmnopqrstuvwxyz.", 44));
+    REQUIRE(a.find('c') == 2);
+    REQUIRE(a.find("bc") == 1);
+    REQUIRE(a.find_first_of("xc") == 2);
+}
+
+
 TEST_CASE("compact/string.streaming", "[compact]")
 {
     compact::string s1 = "aaa";
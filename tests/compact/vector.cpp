@@ -264,3 +264,115 @@ TEST_CASE("compact/vector.compare", "[compact]")
     REQUIRE(tagneq2 != v);
 }
 
+
+TEST_CASE("compact/vector.buffered", "[compact]")
+{
+    typedef compact::buffered_vector<std::string, 1> vector_type;
+    REQUIRE(sizeof(vector_type) == sizeof(uint64_t));
+
+    vector_type v1;
+    std::vector<std::string> expected;
+    REQUIRE(v1.capacity() == 0);
+    for (int i = 0; i < 100; ++i) {
+        v1.push_back(std::to_string(i));
+        expected.push_back(std::to_string(i));
+        REQUIRE(v1.size() <= v1.capacity());
+    }
+    REQUIRE(v1.capacity() == 128);
+    REQUIRE(v1 == expected);
+
+    v1.tag(true);
+    const std::string* p = v1.data();
+    v1.erase(v1.begin() + 10, v1.begin() + 20);
+    expected.erase(expected.begin() + 10, expected.begin() + 20);
+    v1.insert(v1.begin() + 5, "x");
+    expected.insert(expected.begin() + 5, "x");
+    v1.pop_back();
+    expected.pop_back();
+    REQUIRE(v1.data() == p); // no reallocation
+    REQUIRE(v1.capacity() == 128);
+    REQUIRE(v1.tag());
+    REQUIRE(v1 == expected);
+
+    v1.shrink_to_fit();
+    REQUIRE(v1.capacity() == 128);
+    v1.resize(60);
+    expected.resize(60);
+    v1.shrink_to_fit();
+    REQUIRE(v1.capacity() == 64);
+    REQUIRE(v1 == expected);
+
+    v1.assign(3, "y");
+    REQUIRE(v1.size() == 3);
+    REQUIRE(v1.capacity() == 64);
+
+    vector_type v2;
+    v2.reserve(17);
+    REQUIRE(v2.capacity() == 32);
+    v2 = v1;
+    REQUIRE(v2 == v1);
+
+    std::stringstream buf("a b c d e f g h i j");
+    v2.assign(std::istream_iterator<std::string>(buf), std::istream_iterator<std::string>{});
+    REQUIRE(v2.size() == 10);
+    REQUIRE(v2.back() == "j");
+
+    compact::buffered_vector<int> v3;
+    REQUIRE(v3.max_size() == 4095);
+    v3.resize(v3.max_size());
+    REQUIRE(v3.capacity() == 4096);
+    REQUIRE_THROWS(v3.push_back(0));
+}
+
+TEST_CASE("compact/vector.inline", "[compact]")
+{
+    typedef compact::small_vector<uint16_t, 1> vector_type;
+    REQUIRE(sizeof(vector_type) == sizeof(uint64_t));
+
+    vector_type v1;
+    v1.tag(true);
+    const void* local = &v1;
+    v1.push_back(1);
+    REQUIRE(static_cast<const void*>(v1.data()) == local);
+    v1.push_back(2);
+    v1.push_back(3);
+    REQUIRE(static_cast<const void*>(v1.data()) == local);
+    REQUIRE(v1 == std::vector<uint16_t>({ 1, 2, 3 }));
+
+    v1.insert(v1.begin(), 0); // spills to the heap
+    REQUIRE(static_cast<const void*>(v1.data()) != local);
+    REQUIRE(v1 == std::vector<uint16_t>({ 0, 1, 2, 3 }));
+
+    v1.erase(v1.begin() + 1); // back inline
+    REQUIRE(static_cast<const void*>(v1.data()) == local);
+    REQUIRE(v1 == std::vector<uint16_t>({ 0, 2, 3 }));
+    REQUIRE(v1.tag());
+
+    vector_type v2 = v1;
+    REQUIRE(v2 == v1);
+    vector_type v3 = std::move(v2);
+    REQUIRE(v3 == v1);
+    REQUIRE(static_cast<const void*>(v3.data()) == static_cast<const void*>(&v3));
+
+    compact::small_vector<uint8_t> v4 = { 1, 2, 3, 4, 5, 6 };
+    REQUIRE(static_cast<const void*>(v4.data()) == static_cast<const void*>(&v4));
+    v4.resize(100, 7);
+    REQUIRE(v4.size() == 100);
+    REQUIRE(v4[5] == 6);
+    REQUIRE(v4[99] == 7);
+    v4.assign(2, 9);
+    REQUIRE(static_cast<const void*>(v4.data()) == static_cast<const void*>(&v4));
+    v4.clear();
+    REQUIRE(v4.empty());
+
+    compact::vector<uint8_t, std::allocator<uint8_t>, 0, 11, true, true> v5;
+    for (int i = 0; i < 6; ++i)
+        v5.push_back(uint8_t(i));
+    REQUIRE(v5.capacity() == 6);
+    v5.push_back(6);
+    REQUIRE(v5.capacity() == 8);
+    v5.resize(2);
+    v5.shrink_to_fit();
+    REQUIRE(v5.capacity() == 6);
+    REQUIRE(v5 == std::vector<uint8_t>({ 0, 1 }));
+}
@@ -0,0 +1,114 @@
+#include <catch.hpp>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/containers/circular_queue.hpp>
+
+
+TEST_CASE("containers/ring_buffer", "[containers]")
+{
+    stdx::ring_buffer<std::string> rb;
+    std::deque<std::string> ref;
+    std::mt19937 gen(7);
+
+    for (int i = 0; i < 20000; i++) {
+        switch (gen() % 6) {
+        case 0: case 1:
+            rb.push_back(std::to_string(i));
+            ref.push_back(std::to_string(i));
+            break;
+        case 2:
+            rb.emplace_front(3, char('a' + i % 26));
+            ref.emplace_front(3, char('a' + i % 26));
+            break;
+        case 3:
+            if (!ref.empty()) { rb.pop_front(); ref.pop_front(); }
+            break;
+        case 4:
+            if (!ref.empty()) { rb.pop_back(); ref.pop_back(); }
+            break;
+        case 5: {
+            std::vector<std::string> v(gen() % 12, std::to_string(i));
+            rb.append(v.begin(), v.end());
+            ref.insert(ref.end(), v.begin(), v.end());
+            break;
+        }
+        }
+        REQUIRE(rb.size() == ref.size());
+    }
+    REQUIRE(std::equal(rb.begin(), rb.end(), ref.begin(), ref.end()));
+    REQUIRE(std::equal(rb.rbegin(), rb.rend(), ref.rbegin(), ref.rend()));
+    REQUIRE((rb.capacity() & (rb.capacity() - 1)) == 0);
+
+    // self-referencing push on full buffer
+    stdx::ring_buffer<std::string> small(8);
+    for (int i = 0; i < 8; i++)
+        small.push_back(std::string(32, char('a' + i)));
+    REQUIRE(small.full());
+    small.push_back(small.front());
+    REQUIRE(small.back() == std::string(32, 'a'));
+
+    stdx::ring_buffer<std::string> copy(rb);
+    REQUIRE(std::equal(copy.begin(), copy.end(), ref.begin(), ref.end()));
+    stdx::ring_buffer<std::string> moved(std::move(copy));
+    REQUIRE(copy.empty());
+    REQUIRE(moved.size() == ref.size());
+
+    stdx::ring_buffer<std::string>::const_iterator cit = rb.begin();
+    REQUIRE(rb.end() - cit == static_cast<ptrdiff_t>(rb.size()));
+    REQUIRE(cit[3] == ref[3]);
+    REQUIRE_THROWS_AS(rb.at(rb.size()), std::out_of_range);
+}
+
+
+TEST_CASE("containers/circular_queue", "[containers]")
+{
+    typedef stdx::circular_queue<int> deque_queue;
+    typedef stdx::circular_queue<int, stdx::ring_buffer<int>> ring_queue;
+
+    deque_queue dq(100);
+    ring_queue rq(100);
+    REQUIRE(rq.get_allocator() == std::allocator<int>());
+
+    std::mt19937 gen(42);
+    std::vector<int> src(300);
+    std::vector<int> out_d(300), out_r(300);
+    for (int i = 0; i < 5000; i++) {
+        switch (gen() % 5) {
+        case 0:
+            dq.push(i); rq.push(i);
+            break;
+        case 1:
+            dq.emplace(-i); rq.emplace(-i);
+            break;
+        case 2: {
+            size_t n = gen() % src.size();
+            std::generate_n(src.begin(), n, [&] { return int(gen()); });
+            dq.push(src.begin(), src.begin() + n);
+            rq.push(src.data(), src.data() + n);
+            break;
+        }
+        case 3: {
+            size_t n = gen() % 40;
+            dq.pop_n(n); rq.pop_n(n);
+            break;
+        }
+        case 4: {
+            size_t n = gen() % 40;
+            auto ed = dq.pop_n(n, out_d.data());
+            auto er = rq.pop_n(n, out_r.data());
+            REQUIRE(ed - out_d.data() == er - out_r.data());
+            REQUIRE(std::equal(out_d.data(), ed, out_r.data()));
+            break;
+        }
+        }
+        REQUIRE(dq.size() <= 100);
+        REQUIRE(rq.size() == dq.size());
+        REQUIRE(std::equal(rq.begin(), rq.end(), dq.begin(), dq.end()));
+    }
+    REQUIRE(rq.capacity() == 100);
+}
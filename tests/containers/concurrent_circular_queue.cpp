@@ -0,0 +1,176 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <stdexcept>
+
+#include <stlext/containers/concurrent_circular_queue.hpp>
+
+
+TEST_CASE("containers/spsc_circular_queue", "[containers]")
+{
+    stdx::spsc_circular_queue<std::string> q(5);
+    REQUIRE(q.capacity() == 8);
+
+    for (int i = 0; i < 8; i++)
+        REQUIRE(q.try_push(std::to_string(i)));
+    REQUIRE(!q.try_push("overflow"));
+    REQUIRE(q.size() == 8);
+
+    std::string s;
+    REQUIRE(q.try_pop(s));
+    REQUIRE(s == "0");
+
+    std::vector<std::string> out(10);
+    REQUIRE(q.try_pop_n(out.begin(), 10) == 7);
+    REQUIRE(out[6] == "7");
+    REQUIRE(!q.try_pop(s));
+
+    std::vector<std::string> in = { "a", "b", "c" };
+    REQUIRE(q.try_push_n(in.begin(), in.size()) == 3);
+    // remaining elements are destroyed with the queue
+
+    const size_t n = 200000;
+    stdx::spsc_circular_queue<size_t> iq(64);
+    std::thread producer([&] {
+        std::vector<size_t> batch(17);
+        for (size_t i = 0; i < n; ) {
+            size_t k = (std::min)(batch.size(), n - i);
+            std::iota(batch.begin(), batch.begin() + k, i);
+            iq.push_n(batch.begin(), k);
+            i += k;
+        }
+    });
+
+    bool ordered = true;
+    std::vector<size_t> batch(13);
+    for (size_t i = 0; i < n; ) {
+        size_t k = iq.try_pop_n(batch.begin(), (std::min)(batch.size(), n - i));
+        for (size_t j = 0; j < k; j++)
+            ordered &= (batch[j] == i + j);
+        i += k;
+        if (k == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+    REQUIRE(ordered);
+    REQUIRE(iq.empty());
+}
+
+
+TEST_CASE("containers/mpmc_circular_queue", "[containers]")
+{
+    stdx::mpmc_circular_queue<std::shared_ptr<int>> q(4);
+    for (int i = 0; i < 4; i++)
+        REQUIRE(q.try_push(std::make_shared<int>(i)));
+    REQUIRE(!q.try_push(std::make_shared<int>(4)));
+    REQUIRE(q.push_overwrite(std::make_shared<int>(4)) == 1);
+
+    std::shared_ptr<int> p;
+    REQUIRE(q.try_pop(p));
+    REQUIRE(*p == 1);
+
+    const int nproducers = 3, nconsumers = 3;
+    const size_t per_producer = 50000;
+    stdx::mpmc_circular_queue<size_t> iq(128);
+    std::atomic<size_t> sum(0), count(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nproducers; t++) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < per_producer; i++)
+                iq.push(t * per_producer + i + 1);
+        });
+    }
+    for (int t = 0; t < nconsumers; t++) {
+        threads.emplace_back([&] {
+            size_t v, local = 0;
+            while (count.load() < nproducers * per_producer) {
+                if (iq.try_pop(v)) {
+                    local += v;
+                    count.fetch_add(1);
+                }
+                else std::this_thread::yield();
+            }
+            sum.fetch_add(local);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    const size_t total = nproducers * per_producer;
+    REQUIRE(count.load() == total);
+    REQUIRE(sum.load() == total * (total + 1) / 2);
+    REQUIRE(iq.empty());
+}
+
+
+namespace
+{
+    // throws when constructed from negative value
+    struct throwing_ctor
+    {
+        int value;
+        explicit throwing_ctor(int v = 0) : value(v) {
+            if (v < 0)
+                throw std::runtime_error("throwing_ctor");
+        }
+        throwing_ctor(throwing_ctor&& other) noexcept : value(other.value) {}
+        throwing_ctor& operator=(throwing_ctor&& other) noexcept { value = other.value; return *this; }
+    };
+
+    // throws when negative value is move-assigned
+    struct throwing_assign
+    {
+        int value;
+        explicit throwing_assign(int v = 0) noexcept : value(v) {}
+        throwing_assign(throwing_assign&& other) noexcept : value(other.value) {}
+        throwing_assign& operator=(throwing_assign&& other) {
+            if (other.value < 0)
+                throw std::runtime_error("throwing_assign");
+            value = other.value;
+            return *this;
+        }
+    };
+}
+
+TEST_CASE("containers/mpmc_circular_queue/exceptions", "[containers]")
+{
+    stdx::mpmc_circular_queue<throwing_ctor> q(2);
+    REQUIRE(q.try_emplace(1));
+    REQUIRE_THROWS_AS(q.try_emplace(-1), std::runtime_error);
+    REQUIRE_THROWS_AS(q.try_emplace(-2), std::runtime_error);
+    REQUIRE(q.size() == 1);
+    REQUIRE(q.try_emplace(2));
+    REQUIRE(!q.try_emplace(3));
+
+    throwing_ctor c;
+    REQUIRE(q.try_pop(c));
+    REQUIRE(c.value == 1);
+    REQUIRE(q.try_pop(c));
+    REQUIRE(c.value == 2);
+    REQUIRE(!q.try_pop(c));
+    for (int i = 0; i < 8; i++) {
+        REQUIRE(q.try_emplace(i));
+        REQUIRE(q.try_pop(c));
+        REQUIRE(c.value == i);
+    }
+
+    stdx::mpmc_circular_queue<throwing_assign> aq(2);
+    REQUIRE(aq.try_emplace(-1));
+    REQUIRE(aq.try_emplace(1));
+    throwing_assign a(7);
+    REQUIRE_THROWS_AS(aq.try_pop(a), std::runtime_error);
+    REQUIRE(a.value == 7);
+    REQUIRE(aq.size() == 1);
+    REQUIRE(aq.try_pop(a));
+    REQUIRE(a.value == 1);
+    REQUIRE(aq.try_emplace(2));
+    REQUIRE(aq.try_emplace(3));
+    REQUIRE(aq.try_pop(a));
+    REQUIRE(a.value == 2);
+}
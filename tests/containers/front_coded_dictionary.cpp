@@ -0,0 +1,86 @@
+#include <catch.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <stlext/containers/front_coded_dictionary.hpp>
+
+
+TEST_CASE("containers/front_coded_dictionary", "[containers]")
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 2000; i++)
+        words.push_back("http://example.com/path/" + std::to_string(i % 37) + "/item" + std::to_string(i));
+    words.push_back("");
+    words.push_back("http://example.com/");
+    std::sort(words.begin(), words.end());
+    words.push_back(words.back()); // duplicate
+
+    stdx::front_coded_dictionary dict(words.begin(), words.end());
+    words.pop_back();
+
+    REQUIRE(dict.size() == words.size());
+    REQUIRE(dict.bucket_count() == (words.size() + dict.bucket_size - 1) / dict.bucket_size);
+
+    size_t raw = 0;
+    for (auto& w : words)
+        raw += w.size();
+    REQUIRE(dict.size_in_bytes() * 3 < raw);
+
+    for (size_t i = 0; i < words.size(); i++) {
+        REQUIRE(dict.locate(words[i]) == i);
+        REQUIRE(dict.extract(i) == words[i]);
+    }
+    REQUIRE(dict.locate("http://example.com/path") == dict.npos);
+    REQUIRE(dict.locate("zzz") == dict.npos);
+    REQUIRE_THROWS_AS(dict.extract(words.size()), std::out_of_range);
+
+    size_t i = 0;
+    for (auto it = dict.begin(); it != dict.end(); ++it, ++i) {
+        REQUIRE(*it == words[i]);
+        REQUIRE(it.id() == i);
+    }
+    REQUIRE(i == words.size());
+
+    for (std::string prefix : { "http://example.com/path/1", "http://example.com/path/36/item1",
+                                "http://", "", "a", "zzz", "http://example.com/path/3/item999" })
+    {
+        auto r = dict.prefix_range(prefix);
+        auto first = std::lower_bound(words.begin(), words.end(), prefix);
+        auto last = first;
+        while (last != words.end() && last->compare(0, prefix.size(), prefix) == 0)
+            ++last;
+        REQUIRE(r.first.id() == size_t(first - words.begin()));
+        REQUIRE(r.second.id() == size_t(last - words.begin()));
+
+        size_t n = 0;
+        for (auto it = r.first; it != r.second; ++it, ++n)
+            REQUIRE(it->compare(0, prefix.size(), prefix) == 0);
+        REQUIRE(n == size_t(last - first));
+    }
+
+    REQUIRE(dict.lower_bound("http://example.com/path/10").id() ==
+            size_t(std::lower_bound(words.begin(), words.end(), "http://example.com/path/10") - words.begin()));
+}
+
+
+TEST_CASE("containers/front_coded_dictionary.edges", "[containers]")
+{
+    stdx::front_coded_dictionary empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty.locate("a") == empty.npos);
+    REQUIRE(empty.begin() == empty.end());
+    REQUIRE(empty.prefix_range("a").first == empty.end());
+
+    std::vector<std::string> unsorted = { "b", "a" };
+    REQUIRE_THROWS_AS(stdx::front_coded_dictionary(unsorted.begin(), unsorted.end()), std::invalid_argument);
+
+    std::vector<std::wstring> wide = { L"alpha", L"alphabet", L"beta" };
+    stdx::wfront_coded_dictionary wdict(wide.begin(), wide.end());
+    REQUIRE(wdict.locate(L"alphabet") == 1);
+    REQUIRE(wdict.extract(2) == L"beta");
+    auto r = wdict.prefix_range(L"alpha");
+    REQUIRE(r.first.id() == 0);
+    REQUIRE(r.second.id() == 2);
+}
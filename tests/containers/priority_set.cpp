@@ -0,0 +1,160 @@
+#include <catch.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <stlext/containers/priority_map.hpp>
+
+
+TEST_CASE("containers/priority_set", "[containers]")
+{
+    stdx::priority_set<std::string, int> ps;
+    ps.insert("b", 2);
+    ps.insert("a", 1);
+    auto it = ps.insert("c", 3);
+    REQUIRE(it->key == "c");
+    REQUIRE(ps.size() == 3);
+    REQUIRE(ps.count("a") == 1);
+    REQUIRE(ps.front().key == "a");
+    REQUIRE(ps.back().key == "c");
+
+    REQUIRE(ps.update("c", 0)->priority == 0);
+    REQUIRE(ps.front().key == "c");
+    REQUIRE(ps.insert("a", 5)->priority == 5);
+    REQUIRE(ps.back().key == "a");
+    REQUIRE(ps.erase("b") == 1);
+    REQUIRE(ps.erase("b") == 0);
+    ps.pop_front();
+    REQUIRE(ps.size() == 1);
+    REQUIRE(ps.front().key == "a");
+}
+
+
+TEST_CASE("containers/heap_priority_set", "[containers]")
+{
+    stdx::heap_priority_set<int, double> hs;
+    std::map<int, double> ref;
+    std::mt19937 gen(7);
+
+    for (int step = 0; step < 20000; step++)
+    {
+        int key = gen() % 500;
+        double prio = gen() % 1000;
+        switch (gen() % 6)
+        {
+        case 0:
+        case 1:
+            REQUIRE(hs.insert(key, prio)->key == key);
+            ref[key] = prio;
+            break;
+        case 2:
+            if (ref.count(key)) {
+                REQUIRE(hs.update(key, prio)->priority == prio);
+                ref[key] = prio;
+            } else
+                REQUIRE(hs.update(key, prio) == hs.end());
+            break;
+        case 3:
+            REQUIRE(hs.erase(key) == ref.erase(key));
+            break;
+        case 4:
+            if (!ref.empty()) {
+                double lowest = std::min_element(ref.begin(), ref.end(), [](const std::pair<const int, double>& a, const std::pair<const int, double>& b) {
+                    return a.second < b.second; })->second;
+                REQUIRE(hs.front().priority == lowest);
+                ref.erase(hs.front().key);
+                hs.pop_front();
+            }
+            break;
+        default:
+            if (!ref.empty()) {
+                double highest = std::max_element(ref.begin(), ref.end(), [](const std::pair<const int, double>& a, const std::pair<const int, double>& b) {
+                    return a.second < b.second; })->second;
+                REQUIRE(hs.back().priority == highest);
+                ref.erase(hs.back().key);
+                hs.pop_back();
+            }
+            break;
+        }
+        REQUIRE(hs.size() == ref.size());
+    }
+
+    for (auto& kv : ref) {
+        auto it = hs.find(kv.first);
+        REQUIRE(it != hs.end());
+        REQUIRE(it->priority == kv.second);
+        REQUIRE(hs.count(kv.first) == 1);
+    }
+
+    // drains in priority order
+    double last = -1;
+    while (!hs.empty()) {
+        REQUIRE(hs.front().priority >= last);
+        last = hs.front().priority;
+        hs.pop_front();
+    }
+    REQUIRE(hs.find(1) == hs.end());
+}
+
+
+namespace
+{
+    // few distinct hash values: long probe sequences
+    struct colliding_hash
+    {
+        size_t operator()(int key) const { return static_cast<size_t>(key % 3); }
+    };
+}
+
+TEST_CASE("containers/heap_priority_set/collisions", "[containers]")
+{
+    stdx::heap_priority_set<int, int, colliding_hash> hs;
+    std::map<int, int> ref;
+    std::mt19937 gen(11);
+
+    hs.reserve(100);
+    REQUIRE(hs.bucket_count() >= 200);
+    size_t buckets = hs.bucket_count();
+
+    for (int step = 0; step < 20000; step++)
+    {
+        int key = gen() % 100;
+        int prio = gen() % 50;
+        switch (gen() % 4)
+        {
+        case 0:
+        case 1:
+            hs.insert(key, prio);
+            ref[key] = prio;
+            break;
+        case 2:
+            REQUIRE(hs.erase(key) == ref.erase(key));
+            break;
+        default:
+            if (!ref.empty()) {
+                ref.erase(hs.front().key);
+                hs.pop_front();
+            }
+            break;
+        }
+        REQUIRE(hs.size() == ref.size());
+        if (step % 97 == 0) {
+            for (int k = 0; k < 100; k++) {
+                auto it = hs.find(k);
+                REQUIRE(hs.count(k) == ref.count(k));
+                REQUIRE((it == hs.end() ? ref.count(k) == 0 : ref[k] == it->priority));
+            }
+        }
+    }
+    // released handles are reused, table never grows past reserve
+    REQUIRE(hs.bucket_count() == buckets);
+
+    hs.clear();
+    REQUIRE(hs.empty());
+    REQUIRE(hs.find(1) == hs.end());
+    REQUIRE(hs.insert(1, 5)->priority == 5);
+    REQUIRE(hs.count(1) == 1);
+}
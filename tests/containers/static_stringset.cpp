@@ -0,0 +1,68 @@
+#include <catch.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <stlext/containers/static_stringset.hpp>
+
+
+TEST_CASE("containers/static_stringset", "[containers]")
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 5000; i++)
+        words.push_back("w" + std::to_string(i * 7919));
+    words.push_back("");
+    words.push_back("w0"); // duplicate
+
+    stdx::static_stringset ss(words.begin(), words.end());
+    REQUIRE(ss.size() == words.size() - 1);
+
+    // index() is a bijection onto [0, size())
+    std::vector<bool> seen(ss.size(), false);
+    for (size_t i = 0; i + 1 < words.size(); i++) {
+        size_t k = ss.index(words[i]);
+        REQUIRE(k < ss.size());
+        REQUIRE_FALSE(seen[k]);
+        seen[k] = true;
+        REQUIRE(*ss.find(words[i]) == words[i]);
+    }
+
+    REQUIRE(ss.count("w1") == 0);
+    REQUIRE(ss.find("missing") == ss.end());
+    REQUIRE(ss.index("w7") == ss.npos);
+    REQUIRE(ss.hash_size() * 8 < ss.size() * 6);
+
+    // iteration keeps first occurrences in input order
+    auto it = ss.begin();
+    for (size_t i = 0; i + 1 < words.size(); i++, ++it)
+        REQUIRE(*it == words[i]);
+    REQUIRE(it == ss.end());
+
+    stdx::static_stringset empty;
+    REQUIRE(empty.empty());
+    REQUIRE(empty.count("x") == 0);
+    REQUIRE(empty.begin() == empty.end());
+}
+
+
+TEST_CASE("containers/static_stringset.from_stringset", "[containers]")
+{
+    stdx::stringset dyn;
+    for (int i = 0; i < 300; i++)
+        dyn.insert("key" + std::to_string(i));
+    dyn.erase("key5");
+
+    stdx::static_stringset ss(dyn);
+    REQUIRE(ss.size() == dyn.size());
+    for (int i = 0; i < 300; i++) {
+        std::string s = "key" + std::to_string(i);
+        REQUIRE(ss.count(s) == dyn.count(s));
+    }
+
+    std::vector<std::string> single = { "a" };
+    stdx::static_stringset one(single.begin(), single.end());
+    REQUIRE(one.size() == 1);
+    REQUIRE(one.index("a") == 0);
+    REQUIRE(one.count("b") == 0);
+}
@@ -0,0 +1,71 @@
+#include <catch.hpp>
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+#include <stlext/containers/concurrent_string_interner.hpp>
+
+
+TEST_CASE("containers/string_interner", "[containers]")
+{
+    stdx::concurrent_string_interner si(4);
+    REQUIRE(si.empty());
+    REQUIRE(si.find("abc") == si.npos);
+
+    uint32_t a = si.intern("abc");
+    uint32_t b = si.intern(std::string("abcd"));
+    REQUIRE(a != b);
+    REQUIRE(si.intern("abc", 3) == a);
+    REQUIRE(si.find("abcd") == b);
+    REQUIRE(si.size() == 2);
+    REQUIRE(si[a] == "abc");
+    REQUIRE(si.view(b) == "abcd");
+    REQUIRE(si.view(12345).empty());
+
+    // views must survive index growth
+    auto v = si.view(a);
+    for (int i = 0; i < 10000; i++)
+        REQUIRE(si.intern(std::to_string(i)) == uint32_t(i + 2));
+    REQUIRE(si.size() == 10002);
+    REQUIRE(v.data() == si.view(a).data());
+    REQUIRE(si.bucket_count() * si.max_load_factor() >= si.size());
+    for (int i = 0; i < 10000; i++)
+        REQUIRE(si.view(i + 2) == std::to_string(i));
+
+    std::string big(100000, 'x');
+    uint32_t c = si.intern(big);
+    REQUIRE(si.view(c) == big);
+}
+
+TEST_CASE("containers/string_interner.concurrent", "[containers]")
+{
+    const int nthreads = 8;
+    const int nwords = 20000;
+
+    stdx::concurrent_string_interner si;
+    std::vector< std::vector<uint32_t> > ids(nthreads, std::vector<uint32_t>(nwords));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&, t]() {
+            // every thread interns the same vocabulary in its own order
+            std::vector<int> order(nwords);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), std::mt19937(t));
+            for (int w : order)
+                ids[t][w] = si.intern("word" + std::to_string(w));
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    REQUIRE(si.size() == size_t(nwords));
+    for (int w = 0; w < nwords; w++) {
+        for (int t = 1; t < nthreads; t++)
+            REQUIRE(ids[t][w] == ids[0][w]);
+        REQUIRE(si.view(ids[0][w]) == "word" + std::to_string(w));
+    }
+}
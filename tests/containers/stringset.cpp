@@ -2,8 +2,11 @@
 
 #include <vector>
 #include <string>
+#include <sstream>
+#include <cstring>
 
 #include <stlext/containers/stringset.hpp>
+#include <stlext/containers/mapped_stringset.hpp>
 
 
 TEST_CASE("containers/stringset", "[containers]")
@@ -29,3 +32,133 @@ TEST_CASE("containers/stringset", "[containers]")
     REQUIRE(ss.count("11", 2) == 1);
 }
 
+
+TEST_CASE("containers/stringset.tombstones", "[containers]")
+{
+    stdx::stringset ss;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back("key" + std::to_string(i));
+        ss.insert(keys.back());
+    }
+
+    // erase every other key: iterators of survivors stay valid
+    auto survivor = ss.find("key1");
+    for (size_t i = 0; i < keys.size(); i += 2)
+        REQUIRE(ss.erase(keys[i]) == 1);
+    REQUIRE(ss.size() == keys.size() / 2);
+    REQUIRE(ss.garbage_size() > 0);
+    REQUIRE(*survivor == "key1");
+
+    size_t n = 0;
+    for (auto it = ss.begin(); it != ss.end(); ++it, ++n)
+        REQUIRE(std::stoi(std::string(it->substr(3))) % 2 == 1);
+    REQUIRE(n == ss.size());
+
+    for (size_t i = 0; i < keys.size(); i++)
+        REQUIRE(ss.count(keys[i]) == (i % 2));
+
+    // erase by iterator returns the next live string
+    auto it = ss.erase(ss.begin());
+    REQUIRE(it == ss.begin());
+    REQUIRE(ss.size() == keys.size() / 2 - 1);
+
+    // reinsertion reuses tombstones and eventually compacts
+    for (size_t i = 0; i < keys.size(); i++)
+        ss.insert(keys[i]);
+    REQUIRE(ss.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+        REQUIRE(ss.count(keys[i]) == 1);
+
+    for (size_t i = 0; i < keys.size(); i += 3)
+        ss.erase(keys[i]);
+    ss.compact();
+    REQUIRE(ss.garbage_size() == 0);
+    n = 0;
+    for (auto it = ss.begin(); it != ss.end(); ++it, ++n)
+        REQUIRE(ss.count(it->data(), it->size()) == 1);
+    REQUIRE(n == ss.size());
+    for (size_t i = 0; i < keys.size(); i++)
+        REQUIRE(ss.count(keys[i]) == (i % 3 != 0));
+
+    for (size_t i = 0; i < keys.size(); i++)
+        ss.erase(keys[i]);
+    REQUIRE(ss.empty());
+    REQUIRE(ss.begin() == ss.end());
+}
+
+TEST_CASE("containers/stringset.probing", "[containers]")
+{
+    stdx::stringset ss;
+    ss.reserve(1000);
+    size_t buckets = ss.bucket_count();
+    REQUIRE((buckets & (buckets - 1)) == 0);
+    REQUIRE(buckets * ss.max_load_factor() > 1000);
+
+    for (int i = 0; i < 1000; i++)
+        ss.insert("s" + std::to_string(i));
+    REQUIRE(ss.bucket_count() == buckets);
+    REQUIRE(ss.size() == 1000);
+
+    for (int i = 0; i < 1000; i++) {
+        REQUIRE(ss.count("s" + std::to_string(i)) == 1);
+        REQUIRE(ss.count("m" + std::to_string(i)) == 0);
+    }
+    ss.insert("s1");
+    REQUIRE(ss.size() == 1000);
+}
+
+
+TEST_CASE("containers/stringset.mapped", "[containers]")
+{
+    stdx::stringset ss;
+    for (int i = 0; i < 500; i++)
+        ss.insert("word" + std::to_string(i));
+    ss.erase("word7");
+
+    std::ostringstream os;
+    ss.save(os);
+    std::string bytes = os.str();
+
+    // mapped view expects 8 byte aligned image
+    std::vector<uint64_t> image((bytes.size() + 7) / 8);
+    std::memcpy(image.data(), bytes.data(), bytes.size());
+
+    stdx::mapped_stringset ms(image.data(), bytes.size());
+    REQUIRE(ms.size() == ss.size());
+    REQUIRE(ms.bucket_count() == ss.bucket_count());
+    for (int i = 0; i < 500; i++) {
+        std::string s = "word" + std::to_string(i);
+        REQUIRE(ms.count(s) == ss.count(s));
+    }
+    REQUIRE(ms.find("word7") == ms.end());
+    REQUIRE(ms.find("missing") == ms.end());
+    REQUIRE(*ms.find("word42") == "word42");
+
+    size_t n = 0;
+    for (auto it = ms.begin(); it != ms.end(); ++it, ++n)
+        REQUIRE(ss.count(it->data(), it->size()) == 1);
+    REQUIRE(n == ss.size());
+
+    stdx::mapped_stringset moved(std::move(ms));
+    REQUIRE(moved.count("word1") == 1);
+    REQUIRE(ms.empty());
+    REQUIRE(ms.find("word1") == ms.end());
+
+    // corrupted images are rejected
+    reinterpret_cast<char*>(image.data())[bytes.size() - 1] ^= 1;
+    REQUIRE_THROWS_AS(stdx::mapped_stringset(image.data(), bytes.size()), std::runtime_error);
+    REQUIRE_NOTHROW(stdx::mapped_stringset(image.data(), bytes.size(), false));
+    REQUIRE_THROWS_AS(stdx::mapped_stringset(image.data(), 16), std::runtime_error);
+
+    // empty set
+    std::ostringstream eos;
+    stdx::stringset().save(eos);
+    std::string ebytes = eos.str();
+    std::vector<uint64_t> eimage((ebytes.size() + 7) / 8);
+    std::memcpy(eimage.data(), ebytes.data(), ebytes.size());
+    stdx::mapped_stringset es(eimage.data(), ebytes.size());
+    REQUIRE(es.empty());
+    REQUIRE(es.find("x") == es.end());
+    REQUIRE(es.begin() == es.end());
+}
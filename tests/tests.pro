@@ -19,7 +19,12 @@ QMAKE_LFLAGS += -fsanitize=address,leak
 
 SOURCES += \
     algorithm/experimental.cpp \
+    algorithm/searching.cpp \
     algorithm/sorting.cpp \
+    allocators/concurrent_freelist.cpp \
+    allocators/lockfree_pool.cpp \
+    allocators/slab_arena.cpp \
+    allocators/stats_arena.cpp \
     bitvector/bitvector.cpp \
     compability/c++11_algo.cpp \
     compability/c++14_algo.cpp \
@@ -29,8 +34,14 @@ SOURCES += \
     compact/vector.cpp \
     compact/wstring.cpp \
     components/class_factory.cpp \
+    containers/circular_queue.cpp \
+    containers/concurrent_circular_queue.cpp \
+    containers/front_coded_dictionary.cpp \
     containers/packed_hashtbl.cpp \
+    containers/priority_set.cpp \
+    containers/static_stringset.cpp \
     containers/stringset.cpp \
+    containers/string_interner.cpp \
     functional/predicates.cpp \
     iostreams/base16.cpp \
     iostreams/base64.cpp \